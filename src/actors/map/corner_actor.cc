@@ -60,9 +60,9 @@ namespace GameActors {
                 render_settings.hex_size * 1.0f / 3.0f * animation->get_current_value(),
                 outline_color);
         }
-        if (m_corner->house != nullptr) {
+        if (m_corner->house.is_built()) {
             auto texture = render_resources.sprites.house;
-            if (m_corner->house->level == 2) {
+            if (m_corner->house.level == 2) {
                 texture = render_resources.sprites.town;
             }
             const float scale = render_settings.hex_size * (1.5f / 3.0f) / static_cast<float>(texture.width);
@@ -106,7 +106,7 @@ namespace GameActors {
         return m_corner;
     }
 
-    void CornerActor::set_house(House *house) {
+    void CornerActor::set_house(const House &house) {
         m_corner->house = house;
         const auto linear_animation = new LinearAnimation(0.2f, 1.0f, 0.0f);
         animations.add_animation_for(CornerActorAnimations::BUILD_HOUSE, linear_animation);
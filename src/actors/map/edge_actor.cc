@@ -51,7 +51,7 @@ namespace GameActors {
             .width = width,
             .height = 19.0f
         };
-        if (edge->road != nullptr) {
+        if (edge->road.is_built()) {
             if (const auto animation = animations.get_potential_animation_for(EdgeActorAnimations::ON_BUILD);
                 animation == nullptr) {
                 DrawRectanglePro(rectangle, {0.0f, 9.5f},
@@ -90,7 +90,7 @@ namespace GameActors {
         return edge;
     }
 
-    void EdgeActor::set_road(Road *road) {
+    void EdgeActor::set_road(const Road &road) {
         edge->road = road;
         const auto linear_animation = new LinearAnimation(0.2f, 1.0f, 0.0f);
         animations.add_animation_for(EdgeActorAnimations::ON_BUILD, linear_animation);
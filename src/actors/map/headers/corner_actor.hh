@@ -20,6 +20,7 @@ namespace GameActors {
         enum class CornerActorAnimations {
             HIGHLIGHTED,
             BUILD_HOUSE,
+            COUNT,
         };
 
         AnimationContainer<CornerActorAnimations> animations{};
@@ -39,7 +40,7 @@ namespace GameActors {
 
         [[nodiscard]] const Map::Corner *get_corner() const;
 
-        void set_house(House *house);
+        void set_house(const House &house);
 
         void set_upgradable(bool upgradable);
 
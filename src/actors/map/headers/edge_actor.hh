@@ -17,6 +17,7 @@ namespace GameActors {
         enum class EdgeActorAnimations {
             HIGHLIGHTED,
             ON_BUILD,
+            COUNT,
         };
 
         AnimationContainer<EdgeActorAnimations> animations{};
@@ -36,7 +37,7 @@ namespace GameActors {
 
         [[nodiscard]] const Map::Edge *get_edge() const;
 
-        void set_road(Road *road);
+        void set_road(const Road &road);
 
 
         ~EdgeActor() override;
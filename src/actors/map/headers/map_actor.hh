@@ -1,6 +1,10 @@
 
 #pragma once
 
+#include <vector>
+
+#include "corner_actor.hh"
+#include "edge_actor.hh"
 #include "generic_actors.hh"
 #include "map.hh"
 
@@ -10,11 +14,32 @@ namespace GameActors {
     class MapActor final : public PositionedActor, IClickableActor {
         LayeredContainer m_actors{};
         const Map::Map &m_map;
+        // Indexed by the topology ids, so a picked coordinate resolves to its actor without a scan.
+        std::vector<CornerActor *> m_corner_actors;
+        std::vector<EdgeActor *> m_edge_actors;
+        CornerActor *m_hovered_corner = nullptr;
+        EdgeActor *m_hovered_edge = nullptr;
+
+        void set_hovered(CornerActor *corner_actor, EdgeActor *edge_actor);
 
     public:
+        // Creates an actor for every corner and edge of the map.
         explicit MapActor(const Vector2 &position, const Map::Map &map);
 
-        ~MapActor() override = default;
+        ~MapActor() override;
+
+        MapActor(const MapActor &) = delete;
+
+        auto operator=(const MapActor &) -> MapActor & = delete;
+
+        // Corner actor under the mouse, if any. Constant time whatever the board size.
+        [[nodiscard]] auto get_corner_actor_at(const Vector2 &mouse_position) const -> CornerActor *;
+
+        // Edge actor under the mouse, if any. Constant time whatever the board size.
+        [[nodiscard]] auto get_edge_actor_at(const Vector2 &mouse_position) const -> EdgeActor *;
+
+        // Highlights the corner or edge under the mouse and clears the previous one.
+        void update_hover(const Vector2 &mouse_position);
 
         [[nodiscard]] auto get_children() -> LayeredContainer &;
 
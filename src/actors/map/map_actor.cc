@@ -1,9 +1,55 @@
-
 #include "map_actor.hh"
 
+#include "engine_settings.hh"
+#include "utils.hh"
+
 
 namespace GameActors {
+    namespace {
+        auto get_full_hex_size() -> float { return get_engine_settings().get_render_settings().full_hex_size; }
+
+        auto to_world(const Vector2 &origin, const Vector2 &position) -> Vector2 {
+            return {origin.x + position.x, origin.y + position.y};
+        }
+
+        auto to_local(const Vector2 &origin, const Vector2 &position) -> Vector2 {
+            return {position.x - origin.x, position.y - origin.y};
+        }
+    } // namespace
+
     MapActor::MapActor(const Vector2 &position, const Map::Map &map) : PositionedActor(position), m_map(map) {
+        const auto &topology = m_map.get_topology();
+        const float full_hex_size = get_full_hex_size();
+
+        m_edge_actors.reserve(topology.get_edge_count());
+        for (Map::EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+            const auto &coord = topology.get_edge_coord(edge);
+            // Edges are drawn from the corner they start at
+            const Map::CornerCoord start{coord.hex_coord, static_cast<Map::HexCornerDirection>(coord.edge_direction)};
+            const auto edge_position = to_world(position, Utils::compute_corner_position(full_hex_size, start));
+            auto *edge_actor = new EdgeActor(m_map.get_edge(edge), coord, edge_position);
+            m_edge_actors.push_back(edge_actor);
+            m_actors.add(edge_actor, RenderLayer::MAP_EDGES);
+        }
+
+        m_corner_actors.reserve(topology.get_corner_count());
+        for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+            const auto &coord = topology.get_corner_coord(corner);
+            const auto corner_position = to_world(position, Utils::compute_corner_position(full_hex_size, coord));
+            auto *corner_actor = new CornerActor(m_map.get_corner(corner), coord, corner_position);
+            m_corner_actors.push_back(corner_actor);
+            m_actors.add(corner_actor, RenderLayer::MAP_CORNERS);
+        }
+    }
+
+    MapActor::~MapActor() {
+        m_actors.clear();
+        for (const auto *corner_actor: m_corner_actors) {
+            delete corner_actor;
+        }
+        for (const auto *edge_actor: m_edge_actors) {
+            delete edge_actor;
+        }
     }
 
     auto MapActor::get_children() -> LayeredContainer & {
@@ -27,8 +73,56 @@ namespace GameActors {
         }
     }
 
+    auto MapActor::get_corner_actor_at(const Vector2 &mouse_position) const -> CornerActor * {
+        const auto coord = Utils::compute_corner_at_position(get_full_hex_size(),
+                                                             to_local(get_position(), mouse_position));
+        const auto corner = m_map.get_topology().find_corner(coord);
+        if (!corner.has_value() || !m_corner_actors[*corner]->is_mouse_over(mouse_position)) {
+            return nullptr;
+        }
+        return m_corner_actors[*corner];
+    }
+
+    auto MapActor::get_edge_actor_at(const Vector2 &mouse_position) const -> EdgeActor * {
+        const auto coord = Utils::compute_edge_at_position(get_full_hex_size(),
+                                                           to_local(get_position(), mouse_position));
+        const auto edge = m_map.get_topology().find_edge(coord);
+        if (!edge.has_value() || !m_edge_actors[*edge]->is_mouse_over(mouse_position)) {
+            return nullptr;
+        }
+        return m_edge_actors[*edge];
+    }
+
+    void MapActor::update_hover(const Vector2 &mouse_position) {
+        CornerActor *hovered_corner = get_corner_actor_at(mouse_position);
+        set_hovered(hovered_corner, hovered_corner == nullptr ? get_edge_actor_at(mouse_position) : nullptr);
+    }
+
+    void MapActor::set_hovered(CornerActor *corner_actor, EdgeActor *edge_actor) {
+        if (corner_actor != m_hovered_corner) {
+            if (m_hovered_corner != nullptr) {
+                m_hovered_corner->set_highlighted(false);
+            }
+            if (corner_actor != nullptr) {
+                corner_actor->set_highlighted(true);
+            }
+            m_hovered_corner = corner_actor;
+        }
+        if (edge_actor != m_hovered_edge) {
+            if (m_hovered_edge != nullptr) {
+                m_hovered_edge->set_highlighted(false);
+            }
+            if (edge_actor != nullptr) {
+                edge_actor->set_highlighted(true);
+            }
+            m_hovered_edge = edge_actor;
+        }
+    }
+
     auto MapActor::is_mouse_over(const Vector2 &mouse_position) -> bool {
-        return false;
+        const auto coord = Utils::compute_hex_at_position(get_full_hex_size(),
+                                                          to_local(get_position(), mouse_position));
+        return m_map.get_bounds().is_within_bounds(coord);
     }
 
     void MapActor::on_mouse_entered(const Vector2 &mouse_position) {
@@ -37,13 +131,24 @@ namespace GameActors {
 
     void MapActor::on_mouse_exited(const Vector2 &mouse_position) {
         IClickableActor::on_mouse_exited(mouse_position);
+        set_hovered(nullptr, nullptr);
     }
 
     void MapActor::on_mouse_pressed(const Vector2 &mouse_position) {
         IClickableActor::on_mouse_pressed(mouse_position);
+        if (auto *corner_actor = get_corner_actor_at(mouse_position); corner_actor != nullptr) {
+            corner_actor->on_mouse_pressed(mouse_position);
+        } else if (auto *edge_actor = get_edge_actor_at(mouse_position); edge_actor != nullptr) {
+            edge_actor->on_mouse_pressed(mouse_position);
+        }
     }
 
     void MapActor::on_mouse_released(const Vector2 &mouse_position) {
         IClickableActor::on_mouse_released(mouse_position);
+        if (auto *corner_actor = get_corner_actor_at(mouse_position); corner_actor != nullptr) {
+            corner_actor->on_mouse_released(mouse_position);
+        } else if (auto *edge_actor = get_edge_actor_at(mouse_position); edge_actor != nullptr) {
+            edge_actor->on_mouse_released(mouse_position);
+        }
     }
 }
@@ -141,16 +141,13 @@ namespace Engine {
     }
 
     ResourceDisplayActor::ResourceDisplayActor(const RenderResources &render_resources,
-                                               const std::unordered_map<Map::Resource, int> &
-                                               player_resources) : ContainerActor(Vector2Zero(), {}) {
+                                               const Game::ResourceBundle &player_resources)
+        : ContainerActor(Vector2Zero(), {}) {
         std::vector<BoundedBoxActor *> resource_containers;
         float starting_x = 0.0f;
         float starting_y = 0.0f;
         float texture_width = 64.0f;
-        for (const auto resource: {
-                 Map::Resource::WOOD, Map::Resource::BRICK, Map::Resource::SHEEP,
-                 Map::Resource::WHEAT, Map::Resource::STONE
-             }) {
+        for (const auto resource: Map::RESOURCES) {
             auto &outline_texture = render_resources.resource_sprites.resource_outline;
             const auto &texture = get_texture_for_resource(resource);
             float scale = texture_width / static_cast<float>(texture.width);
@@ -216,12 +213,13 @@ namespace Engine {
         recalculate_bounding_box();
     }
 
-    void ResourceDisplayActor::update_resources(const std::unordered_map<Map::Resource, int> &player_resources,
-                                                const std::unordered_map<Map::Resource, int> &delta_resources) const {
-        for (const auto [resource, amount]: player_resources) {
-            resource_text_actors.at(resource)->set_text(std::to_string(amount));
+    void ResourceDisplayActor::update_resources(const Game::ResourceBundle &player_resources,
+                                                const Game::ResourceBundle &delta_resources) const {
+        for (const auto resource: Map::RESOURCES) {
+            resource_text_actors.at(resource)->set_text(std::to_string(player_resources[resource]));
         }
-        for (const auto [resource, amount]: delta_resources) {
+        for (const auto resource: Map::RESOURCES) {
+            const int amount = delta_resources[resource];
             auto resource_actor = delta_resources_actors.at(resource);
             if (amount == 0) {
                 resource_actor->set_text("");
@@ -248,7 +246,7 @@ namespace Engine {
             return std::nullopt;
         }
         for (const auto [resource, actor]: resource_bounding_box) {
-            if (CheckCollisionPointRec(mouse_position, actor->get_bounding_box())) {
+            if (actor != nullptr && CheckCollisionPointRec(mouse_position, actor->get_bounding_box())) {
                 return resource;
             }
         }
@@ -261,7 +259,7 @@ namespace Engine {
             return std::nullopt;
         }
         for (const auto [resource, actor]: resource_sprites) {
-            if (CheckCollisionPointRec(mouse_position, actor->get_bounding_box())) {
+            if (actor != nullptr && CheckCollisionPointRec(mouse_position, actor->get_bounding_box())) {
                 return resource;
             }
         }
@@ -271,7 +269,7 @@ namespace Engine {
     ContainerActor *ResourceDisplayActor::get_drag_and_drop_resource(const RenderResources &resources,
                                                                      const Vector2 &mouse_position) const {
         for (const auto [resource, actor]: resource_sprites) {
-            if (CheckCollisionPointRec(mouse_position, actor->get_bounding_box())) {
+            if (actor != nullptr && CheckCollisionPointRec(mouse_position, actor->get_bounding_box())) {
                 Vector2 anchored_actor_position = actor->get_anchored_position();
                 Vector2 delta = Vector2Subtract(mouse_position, anchored_actor_position);
                 const auto &[actor_width, actor_height] = actor->get_size();
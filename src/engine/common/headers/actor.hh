@@ -5,12 +5,13 @@
 #ifndef COLOLITE_ACTOR_HH
 #define COLOLITE_ACTOR_HH
 #include <raylib.h>
-#include <unordered_map>
 #include <vector>
 #include "generic_actors.hh"
 
 #include "engine_settings.hh"
+#include "enum_map.hh"
 #include "map.hh"
+#include "resource_bundle.hh"
 
 namespace Engine {
     class FixedSizedTextActor : public BoundedBoxActor {
@@ -86,19 +87,18 @@ namespace Engine {
     };
 
     class ResourceDisplayActor : public ContainerActor {
-        std::unordered_map<Map::Resource, FixedSizedTextActor *> resource_text_actors;
-        std::unordered_map<Map::Resource, FixedSizedTextActor *> delta_resources_actors;
-        std::unordered_map<Map::Resource, BoundedBoxActor *> resource_bounding_box;
-        std::unordered_map<Map::Resource, ContainerActor *> resource_sprites;
+        Game::EnumMap<Map::Resource, FixedSizedTextActor *> resource_text_actors;
+        Game::EnumMap<Map::Resource, FixedSizedTextActor *> delta_resources_actors;
+        Game::EnumMap<Map::Resource, BoundedBoxActor *> resource_bounding_box;
+        Game::EnumMap<Map::Resource, ContainerActor *> resource_sprites;
 
     public:
-        ResourceDisplayActor(const RenderResources &render_resources,
-                             const std::unordered_map<Map::Resource, int> &player_resources);
+        ResourceDisplayActor(const RenderResources &render_resources, const Game::ResourceBundle &player_resources);
 
         ~ResourceDisplayActor() override = default;
 
-        void update_resources(const std::unordered_map<Map::Resource, int> &player_resources,
-                              const std::unordered_map<Map::Resource, int> &delta_resources) const;
+        void update_resources(const Game::ResourceBundle &player_resources,
+                              const Game::ResourceBundle &delta_resources) const;
 
         void render() const override;
 
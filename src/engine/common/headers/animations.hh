@@ -4,9 +4,11 @@
 
 #ifndef COLOLITE_ANIMATIONS_HH
 #define COLOLITE_ANIMATIONS_HH
-#include <utility>
+#include <stdexcept>
 #include <vector>
 
+#include "enum_map.hh"
+
 namespace Engine {
     class BaseAnimation;
 
@@ -55,74 +57,67 @@ namespace Engine {
     };
 
 
+    // At most one animation per key of the enum T, which needs a trailing COUNT enumerator (see EnumMap).
     template<typename T>
     class AnimationContainer {
-        std::vector<std::pair<T, BaseAnimation *> > animations{};
+        Game::EnumMap<T, BaseAnimation *> animations{};
 
     public:
         AnimationContainer() = default;
 
+        AnimationContainer(const AnimationContainer &) = delete;
+
+        AnimationContainer &operator=(const AnimationContainer &) = delete;
+
         BaseAnimation *get_animation_for(const T &key) const {
-            for (const auto &[animation_key, animation]: animations) {
-                if (animation_key == key) {
-                    return animation;
-                }
+            if (animations[key] == nullptr) {
+                throw std::runtime_error("No animation found");
             }
-            throw std::runtime_error("No animation found");
+            return animations[key];
         };
 
         BaseAnimation *get_potential_animation_for(const T &key) const {
-            for (const auto &[animation_key, animation]: animations) {
-                if (animation_key == key) {
-                    return animation;
-                }
-            }
-            return nullptr;
+            return animations[key];
         };
 
+        // Replaces the animation already running for `key`, if any.
         void add_animation_for(T key, BaseAnimation *animation) {
-            animations.emplace_back(key, animation);
+            delete animations[key];
+            animations[key] = animation;
         }
 
         void remove_animation_for(const T &key) {
-            for (auto it = animations.begin(); it != animations.end(); ++it) {
-                if (it->first == key) {
-                    delete it->second;
-                    animations.erase(it);
-                    break;
-                }
-            }
+            delete animations[key];
+            animations[key] = nullptr;
         }
 
         void tick_animations(float delta_time) {
-            for (const auto &[_, animation]: animations) {
+            for (auto &animation: animations.values()) {
+                if (animation == nullptr) {
+                    continue;
+                }
                 animation->tick_animation(delta_time);
-            }
-            for (int i = 0; i < animations.size();) {
-                if (animations[i].second->is_finished() && animations[i].second->get_on_finished() ==
+                if (animation->is_finished() && animation->get_on_finished() ==
                     OnAnimationFinished::DESTROY_ANIMATION) {
-                    delete animations[i].second;
-                    animations[i] = animations.back();
-                    animations.pop_back();
-                } else {
-                    ++i;
+                    delete animation;
+                    animation = nullptr;
                 }
             }
         }
 
         void remove_animation(BaseAnimation *animation) {
-            for (auto it = animations.begin(); it != animations.end(); ++it) {
-                if (it->second == animation) {
-                    delete it->second;
-                    animations.erase(it);
+            for (auto &slot: animations.values()) {
+                if (slot == animation) {
+                    delete slot;
+                    slot = nullptr;
                     break;
                 }
             }
         }
 
         ~AnimationContainer() {
-            for (auto it = animations.begin(); it != animations.end(); ++it) {
-                delete it->second;
+            for (const auto *animation: animations.values()) {
+                delete animation;
             }
         }
     };
@@ -12,6 +12,20 @@ namespace Engine::Utils {
     Vector2 compute_hex_center_position(const float hex_size, const Map::HexCoord2 &hex_coord);
 
     Vector2 compute_hex_center_position(const Map::HexCoord2 &hex_coord);
+
+    Vector2 compute_corner_position(const float hex_size, const Map::CornerCoord &corner_coord);
+
+    // Midpoint of the edge.
+    Vector2 compute_edge_position(const float hex_size, const Map::EdgeCoord &edge_coord);
+
+    // Inverse of compute_hex_center_position: the hex whose area contains `position`.
+    Map::HexCoord2 compute_hex_at_position(const float hex_size, const Vector2 &position);
+
+    // Corner closest to `position`, named from the hex containing it.
+    Map::CornerCoord compute_corner_at_position(const float hex_size, const Vector2 &position);
+
+    // Edge whose midpoint is closest to `position`, named from the hex containing it.
+    Map::EdgeCoord compute_edge_at_position(const float hex_size, const Vector2 &position);
 }
 
 #endif //COLOLITE_UTILS_HH
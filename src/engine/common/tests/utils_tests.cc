@@ -0,0 +1,63 @@
+#include <cmath>
+#include <gtest/gtest.h>
+#include "coord_keys.hh"
+#include "utils.hh"
+
+namespace Engine::Utils {
+    constexpr float hex_size = 100.0f;
+
+    // Test: Every hex center maps back to its hex, and so does any point well inside it
+    TEST(UtilsTest, HexAtPositionInvertsHexCenter) {
+        for (int q = -6; q <= 6; q++) {
+            for (int r = -6; r <= 6; r++) {
+                const Map::HexCoord2 coord{q, r};
+                const Vector2 center = compute_hex_center_position(hex_size, coord);
+                EXPECT_EQ(compute_hex_at_position(hex_size, center), coord);
+                for (int step = 0; step < 12; step++) {
+                    const float angle = static_cast<float>(step) * 0.5236f + 0.1f;
+                    const Vector2 inside{
+                        center.x + std::cos(angle) * hex_size * 0.8f,
+                        center.y + std::sin(angle) * hex_size * 0.8f,
+                    };
+                    EXPECT_EQ(compute_hex_at_position(hex_size, inside), coord);
+                }
+            }
+        }
+    }
+
+    // Test: Neighbouring hex centers are one hex apart in the direction of the shared edge
+    TEST(UtilsTest, NeighbouringHexCenters) {
+        const Map::HexCoord2 coord{1, -2};
+        const Vector2 center = compute_hex_center_position(hex_size, coord);
+        for (const auto direction: Map::HEX_EDGE_DIRECTIONS) {
+            const Vector2 edge = compute_edge_position(hex_size, {coord, direction});
+            const Vector2 neighbour = compute_hex_center_position(hex_size, coord.get_neighbouring_hex_coord(direction));
+            EXPECT_NEAR(neighbour.x, 2.0f * edge.x - center.x, 1e-3f);
+            EXPECT_NEAR(neighbour.y, 2.0f * edge.y - center.y, 1e-3f);
+        }
+    }
+
+    // Test: Points near a corner or an edge midpoint pick that corner or edge, under any of its names
+    TEST(UtilsTest, CornerAndEdgeAtPosition) {
+        for (int q = -3; q <= 3; q++) {
+            for (int r = -3; r <= 3; r++) {
+                const Map::HexCoord2 coord{q, r};
+                for (const auto direction: Map::HEX_CORNER_DIRECTIONS) {
+                    const Map::CornerCoord corner{coord, direction};
+                    Vector2 position = compute_corner_position(hex_size, corner);
+                    position.x += 3.0f;
+                    position.y -= 2.0f;
+                    EXPECT_EQ(Map::encode_corner(compute_corner_at_position(hex_size, position)),
+                              Map::encode_corner(corner));
+                }
+                for (const auto direction: Map::HEX_EDGE_DIRECTIONS) {
+                    const Map::EdgeCoord edge{coord, direction};
+                    Vector2 position = compute_edge_position(hex_size, edge);
+                    position.x -= 4.0f;
+                    position.y += 1.0f;
+                    EXPECT_EQ(Map::encode_edge(compute_edge_at_position(hex_size, position)), Map::encode_edge(edge));
+                }
+            }
+        }
+    }
+} // namespace Engine::Utils
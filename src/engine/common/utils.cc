@@ -3,16 +3,53 @@
 //
 #include "utils.hh"
 
+#include <array>
+#include <cmath>
 #include <numbers>
 
 #include "engine_settings.hh"
 
 namespace Engine::Utils {
+    namespace {
+        constexpr float sqrt3 = std::numbers::sqrt3_v<float>;
+
+        // Unit vectors from a hex center towards its corners, indexed by HexCornerDirection.
+        constexpr std::array<Vector2, 6> CORNER_DIRECTIONS{{
+            {1.0f, 0.0f}, {0.5f, sqrt3 / 2.0f}, {-0.5f, sqrt3 / 2.0f},
+            {-1.0f, 0.0f}, {-0.5f, -sqrt3 / 2.0f}, {0.5f, -sqrt3 / 2.0f},
+        }};
+
+        // Unit vectors from a hex center towards its edge midpoints, indexed by HexEdgeDirection.
+        constexpr std::array<Vector2, 6> EDGE_DIRECTIONS{{
+            {sqrt3 / 2.0f, 0.5f}, {0.0f, 1.0f}, {-sqrt3 / 2.0f, 0.5f},
+            {-sqrt3 / 2.0f, -0.5f}, {0.0f, -1.0f}, {sqrt3 / 2.0f, -0.5f},
+        }};
+
+        // Index of the direction closest to `offset`, by largest dot product.
+        auto get_closest_direction(const std::array<Vector2, 6> &directions, const Vector2 &offset) -> int {
+            int closest = 0;
+            float closest_dot = offset.x * directions[0].x + offset.y * directions[0].y;
+            for (int i = 1; i < 6; i++) {
+                const float dot = offset.x * directions[i].x + offset.y * directions[i].y;
+                if (dot > closest_dot) {
+                    closest = i;
+                    closest_dot = dot;
+                }
+            }
+            return closest;
+        }
+
+        auto get_offset_from_hex_center(const float hex_size, const Map::HexCoord2 &hex_coord,
+                                        const Vector2 &position) -> Vector2 {
+            const Vector2 center = compute_hex_center_position(hex_size, hex_coord);
+            return {position.x - center.x, position.y - center.y};
+        }
+    } // namespace
+
     Vector2 compute_hex_center_position(const float hex_size, const Map::HexCoord2 &hex_coord) {
         return {
             .x = hex_size * 3.0f / 2.0f * static_cast<float>(hex_coord.q),
-            .y = hex_size *
-                 (std::numbers::sqrt3_v<float> / 2.0f * static_cast<float>(hex_coord.q) + std::numbers::sqrt3_v<float>)
+            .y = hex_size * sqrt3 * (static_cast<float>(hex_coord.q) / 2.0f + static_cast<float>(hex_coord.r))
         };
     }
 
@@ -21,5 +58,52 @@ namespace Engine::Utils {
 
         return compute_hex_center_position(hex_size, hex_coord);
     }
-}
 
+    Vector2 compute_corner_position(const float hex_size, const Map::CornerCoord &corner_coord) {
+        const Vector2 center = compute_hex_center_position(hex_size, corner_coord.hex_coord);
+        const Vector2 &direction = CORNER_DIRECTIONS[static_cast<int>(corner_coord.corner_direction)];
+        return {center.x + direction.x * hex_size, center.y + direction.y * hex_size};
+    }
+
+    Vector2 compute_edge_position(const float hex_size, const Map::EdgeCoord &edge_coord) {
+        const Vector2 center = compute_hex_center_position(hex_size, edge_coord.hex_coord);
+        const Vector2 &direction = EDGE_DIRECTIONS[static_cast<int>(edge_coord.edge_direction)];
+        const float apothem = hex_size * sqrt3 / 2.0f;
+        return {center.x + direction.x * apothem, center.y + direction.y * apothem};
+    }
+
+    Map::HexCoord2 compute_hex_at_position(const float hex_size, const Vector2 &position) {
+        // Fractional axial coordinates, then rounded in cube space (q + r + s = 0): the component that moved the
+        // most while rounding is recomputed from the other two.
+        const float q = 2.0f / 3.0f * position.x / hex_size;
+        const float r = (-1.0f / 3.0f * position.x + sqrt3 / 3.0f * position.y) / hex_size;
+        const float s = -q - r;
+
+        float rounded_q = std::round(q);
+        float rounded_r = std::round(r);
+        const float rounded_s = std::round(s);
+        const float q_delta = std::abs(rounded_q - q);
+        const float r_delta = std::abs(rounded_r - r);
+        const float s_delta = std::abs(rounded_s - s);
+        if (q_delta > r_delta && q_delta > s_delta) {
+            rounded_q = -rounded_r - rounded_s;
+        } else if (r_delta > s_delta) {
+            rounded_r = -rounded_q - rounded_s;
+        }
+        return {static_cast<int>(rounded_q), static_cast<int>(rounded_r)};
+    }
+
+    Map::CornerCoord compute_corner_at_position(const float hex_size, const Vector2 &position) {
+        // The closest corner of the plane is always a corner of the hex containing the position.
+        const Map::HexCoord2 hex_coord = compute_hex_at_position(hex_size, position);
+        const Vector2 offset = get_offset_from_hex_center(hex_size, hex_coord, position);
+        return {hex_coord, static_cast<Map::HexCornerDirection>(get_closest_direction(CORNER_DIRECTIONS, offset))};
+    }
+
+    Map::EdgeCoord compute_edge_at_position(const float hex_size, const Vector2 &position) {
+        // Likewise the closest edge midpoint belongs to the hex containing the position.
+        const Map::HexCoord2 hex_coord = compute_hex_at_position(hex_size, position);
+        const Vector2 offset = get_offset_from_hex_center(hex_size, hex_coord, position);
+        return {hex_coord, static_cast<Map::HexEdgeDirection>(get_closest_direction(EDGE_DIRECTIONS, offset))};
+    }
+}
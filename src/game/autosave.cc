@@ -0,0 +1,106 @@
+#include "autosave.hh"
+#include <stdexcept>
+#include <utility>
+
+#include "save_format.hh"
+
+namespace Game {
+    Autosaver::Autosaver(const GameState &state, const std::filesystem::path &path, const size_t queue_depth)
+        : Autosaver(state, [path](const std::span<const std::byte> bytes) { write_save_file(path, bytes); },
+                    queue_depth) {
+    }
+
+    Autosaver::Autosaver(const GameState &state, SaveWriter writer, const size_t queue_depth)
+        : m_board(state.get_map().clone()),
+          m_writer(std::move(writer)),
+          m_slots(queue_depth) {
+        if (queue_depth == 0) {
+            throw std::invalid_argument("An autosave needs room for at least one snapshot");
+        }
+        m_free.reserve(queue_depth);
+        m_pending.reserve(queue_depth);
+        for (size_t slot = 0; slot < queue_depth; slot++) {
+            // Sizes the buffers now, so that no save has to allocate
+            state.snapshot(m_slots[slot]);
+            m_free.push_back(slot);
+        }
+        m_thread = std::jthread([this](const std::stop_token &stop) { run(stop); });
+    }
+
+    auto Autosaver::save(const GameState &state) -> bool {
+        size_t slot = 0;
+        {
+            std::scoped_lock lock(m_mutex);
+            if (!m_free.empty()) {
+                slot = m_free.back();
+                m_free.pop_back();
+            } else if (!m_pending.empty()) {
+                slot = m_pending.back();
+                m_pending.pop_back();
+                m_superseded++;
+            } else {
+                return false;
+            }
+        }
+        // The slot is out of both lists, so the snapshot is taken without holding the lock
+        state.snapshot(m_slots[slot]);
+        {
+            std::scoped_lock lock(m_mutex);
+            m_pending.push_back(slot);
+        }
+        m_changed.notify_all();
+        return true;
+    }
+
+    void Autosaver::run(const std::stop_token &stop) {
+        while (true) {
+            std::unique_lock lock(m_mutex);
+            // Saves still waiting when the autosaver is destroyed are written before the thread ends
+            if (!m_changed.wait(lock, stop, [this] { return !m_pending.empty(); })) {
+                return;
+            }
+            const size_t slot = m_pending.front();
+            m_pending.erase(m_pending.begin());
+            m_writing = true;
+            lock.unlock();
+
+            std::exception_ptr error;
+            try {
+                m_writer(save_game(m_board, m_slots[slot]));
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            m_free.push_back(slot);
+            m_writing = false;
+            if (error) {
+                if (!m_error) {
+                    m_error = error;
+                }
+            } else {
+                m_written++;
+            }
+            lock.unlock();
+            m_changed.notify_all();
+        }
+    }
+
+    void Autosaver::wait() {
+        std::unique_lock lock(m_mutex);
+        m_changed.wait(lock, [this] { return m_pending.empty() && !m_writing; });
+        if (m_error) {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        }
+    }
+
+    auto Autosaver::get_written_count() -> std::uint64_t {
+        std::scoped_lock lock(m_mutex);
+        return m_written;
+    }
+
+    auto Autosaver::get_superseded_count() -> std::uint64_t {
+        std::scoped_lock lock(m_mutex);
+        return m_superseded;
+    }
+} // namespace Game
@@ -0,0 +1,117 @@
+// Measures how long building a seeded board takes and how much heap it needs at its peak, as the radius grows.
+// Tile dealing alone, the topology and the full Map are reported separately; all three should grow linearly with
+// the number of hexes.
+//
+// Usage: board_generation_benchmark [max_radius]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include "board_generator.hh"
+#include "board_topology.hh"
+#include "map.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Heap accounting: every allocation is prefixed with its size so live and peak bytes can be tracked through
+    // the replaced global operator new/delete.
+    constexpr size_t header_size = alignof(std::max_align_t);
+    std::atomic<size_t> live_bytes{0};
+    std::atomic<size_t> peak_bytes{0};
+
+    auto allocate(const size_t size) -> void * {
+        auto *block = static_cast<std::byte *>(std::malloc(size + header_size));
+        if (block == nullptr) {
+            throw std::bad_alloc();
+        }
+        *reinterpret_cast<size_t *>(block) = size;
+        const size_t live = live_bytes += size;
+        size_t peak = peak_bytes.load();
+        while (live > peak && !peak_bytes.compare_exchange_weak(peak, live)) {
+        }
+        return block + header_size;
+    }
+
+    void deallocate(void *pointer) {
+        if (pointer == nullptr) {
+            return;
+        }
+        auto *block = static_cast<std::byte *>(pointer) - header_size;
+        live_bytes -= *reinterpret_cast<size_t *>(block);
+        std::free(block);
+    }
+
+    volatile std::uint64_t sink = 0;
+
+    struct Measurement {
+        double milliseconds;
+        double peak_megabytes;
+    };
+
+    // Runs `build` once and reports its duration and the heap it needed on top of what was live before.
+    template<typename Build>
+    auto measure(Build &&build) -> Measurement {
+        const size_t live_before = live_bytes.load();
+        peak_bytes = live_before;
+        const auto start = Clock::now();
+        build();
+        const auto elapsed = Clock::now() - start;
+        return {
+            std::chrono::duration<double, std::milli>(elapsed).count(),
+            static_cast<double>(peak_bytes.load() - live_before) / (1024.0 * 1024.0),
+        };
+    }
+} // namespace
+
+auto operator new(const size_t size) -> void * { return allocate(size); }
+
+auto operator new[](const size_t size) -> void * { return allocate(size); }
+
+void operator delete(void *pointer) noexcept { deallocate(pointer); }
+
+void operator delete[](void *pointer) noexcept { deallocate(pointer); }
+
+void operator delete(void *pointer, size_t) noexcept { deallocate(pointer); }
+
+void operator delete[](void *pointer, size_t) noexcept { deallocate(pointer); }
+
+auto main(const int argc, char **argv) -> int {
+    const size_t max_radius = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 500;
+    constexpr std::uint64_t seed = 42;
+
+    std::printf("%-8s %10s %12s %12s %12s %12s %12s %12s %10s\n", "radius", "hexes", "tiles ms", "tiles KB",
+                "topology ms", "topology MB", "map ms", "map MB", "ns/hex");
+    for (const size_t radius: {2, 10, 50, 100, 200, 350, 500, 750, 1000}) {
+        if (radius > max_radius) {
+            break;
+        }
+        const size_t hex_count = 3 * radius * radius + 3 * radius + 1;
+
+        const auto tiles = measure([&] {
+            Map::BoardGenerator generator{seed, Map::TileDistribution::standard()};
+            std::uint64_t checksum = 0;
+            for (size_t i = 0; i < hex_count; i++) {
+                checksum += generator.next_tile().number;
+            }
+            sink = sink + checksum;
+        });
+        const auto topology = measure([&] {
+            const auto built = Map::BoardTopology::build(Map::MapBounds::from_radius(radius));
+            sink = sink + built.get_edge_count();
+        });
+        const auto map = measure([&] {
+            const auto built = Map::Map::build_map_of_size(radius, seed);
+            sink = sink + built.get_topology().get_edge_count();
+        });
+
+        std::printf("%-8zu %10zu %12.3f %12.3f %12.3f %12.3f %12.3f %12.3f %10.1f\n", radius, hex_count,
+                    tiles.milliseconds, tiles.peak_megabytes * 1024.0, topology.milliseconds, topology.peak_megabytes,
+                    map.milliseconds, map.peak_megabytes, map.milliseconds * 1e6 / static_cast<double>(hex_count));
+    }
+    return 0;
+}
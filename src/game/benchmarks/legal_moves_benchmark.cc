@@ -0,0 +1,119 @@
+// Compares computing the legal settlement and road sets of every player by walking the board node by node
+// against the whole-board bitboard passes of BoardBitboards, on positions with a few pieces per player.
+//
+// Usage: legal_moves_benchmark
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include "board_bitboards.hh"
+#include "board_state.hh"
+#include "board_topology.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto minimum_measure_time = std::chrono::milliseconds(300);
+    constexpr size_t player_count = 4;
+
+    volatile std::uint64_t sink = 0;
+
+    // Runs `pass` until the minimum measure time elapsed and returns the passes per second.
+    template<typename Pass>
+    auto measure_passes_per_second(Pass &&pass) -> double {
+        std::uint64_t passes = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < minimum_measure_time) {
+            pass();
+            passes++;
+            elapsed = Clock::now() - start;
+        }
+        return static_cast<double>(passes) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    auto other_end(const Map::BoardTopology &topology, const Map::EdgeId edge, const Map::CornerId corner) {
+        const auto ends = topology.get_edge_corners(edge);
+        return ends[0] == corner ? ends[1] : ends[0];
+    }
+
+    // Legal settlements and roads of every player, one node at a time.
+    auto walk_legal_moves(const Map::BoardTopology &topology, const Map::BoardState &state) -> std::uint64_t {
+        std::uint64_t legal = 0;
+        for (PlayerId player = 0; player < static_cast<PlayerId>(player_count); player++) {
+            for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+                if (state.get_house(corner).is_built()) {
+                    continue;
+                }
+                bool blocked = false;
+                bool reached = false;
+                for (const Map::EdgeId edge: topology.get_corner_edges(corner)) {
+                    blocked = blocked || state.get_house(other_end(topology, edge, corner)).is_built();
+                    reached = reached || state.get_road(edge).owner == player;
+                }
+                legal += !blocked && reached;
+            }
+            for (Map::EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+                if (state.get_road(edge).is_built()) {
+                    continue;
+                }
+                bool anchored = false;
+                for (const Map::CornerId corner: topology.get_edge_corners(edge)) {
+                    const House &house = state.get_house(corner);
+                    if (house.is_built()) {
+                        anchored = anchored || house.owner == player;
+                        continue;
+                    }
+                    for (const Map::EdgeId next: topology.get_corner_edges(corner)) {
+                        anchored = anchored || state.get_road(next).owner == player;
+                    }
+                }
+                legal += anchored;
+            }
+        }
+        return legal;
+    }
+
+    auto bitboard_legal_moves(const Map::BoardBitboards &bitboards) -> std::uint64_t {
+        std::uint64_t legal = 0;
+        for (PlayerId player = 0; player < static_cast<PlayerId>(player_count); player++) {
+            legal += bitboards.get_legal_settlements(player).count();
+            legal += bitboards.get_legal_roads(player).count();
+        }
+        return legal;
+    }
+} // namespace
+
+auto main() -> int {
+    std::printf("%-8s %10s %18s %18s %8s\n", "radius", "pieces", "walk boards/s", "bitboard boards/s", "speedup");
+    for (const size_t radius: {2, 10, 50}) {
+        const auto topology = Map::BoardTopology::shared(Map::MapBounds::from_radius(radius));
+        Map::BoardState state{*topology};
+        Map::BoardBitboards bitboards{topology, player_count};
+
+        // Scatter a settlement and two roads per player for every few hexes
+        std::mt19937_64 random{7};
+        const size_t piece_count = player_count * (1 + topology->get_hex_count() / 8);
+        for (size_t piece = 0; piece < piece_count; piece++) {
+            const auto player = static_cast<PlayerId>(piece % player_count);
+            const auto corner = static_cast<Map::CornerId>(random() % topology->get_corner_count());
+            state.set_house(corner, House{.owner = player, .level = 1});
+            bitboards.set_house(corner, House{.owner = player, .level = 1});
+            for (const Map::EdgeId edge: topology->get_corner_edges(corner).first(2)) {
+                state.set_road(edge, Road{player});
+                bitboards.set_road(edge, Road{player});
+            }
+        }
+
+        if (walk_legal_moves(*topology, state) != bitboard_legal_moves(bitboards)) {
+            std::printf("legal move counts disagree at radius %zu\n", radius);
+            return 1;
+        }
+        const double walk = measure_passes_per_second([&] { sink = sink + walk_legal_moves(*topology, state); });
+        const double bitboard = measure_passes_per_second([&] { sink = sink + bitboard_legal_moves(bitboards); });
+        std::printf("%-8zu %10zu %18.3e %18.3e %7.2fx\n", radius, 3 * piece_count, walk, bitboard, walk > 0 ? bitboard / walk : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Compares the pointer based Map against the index based FlatMap on the two access patterns the game logic
+// relies on: walking from a corner to its neighbouring corners, and scanning every hex with its corners. Also
+// reports how fast a new game can be started on a board (Map::clone vs copying the FlatMap state), which search
+// and self-play code do all the time.
+//
+// Usage: map_layout_benchmark
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ranges>
+
+#include "flat_map.hh"
+#include "map.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto minimum_measure_time = std::chrono::milliseconds(300);
+
+    volatile std::uint64_t sink = 0;
+
+    // Runs `pass` until the minimum measure time elapsed. Every pass returns how many nodes it visited.
+    template<typename Pass>
+    auto measure_nodes_per_second(Pass &&pass) -> double {
+        std::uint64_t visited = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < minimum_measure_time) {
+            visited += pass();
+            elapsed = Clock::now() - start;
+        }
+        return static_cast<double>(visited) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    auto map_neighbour_walk(const Map::Map &map) -> std::uint64_t {
+        std::uint64_t visited = 0;
+        std::uint64_t occupied = 0;
+        for (const Map::Corner *corner: map.get_corners() | std::views::values) {
+            for (const Map::Edge *edge: corner->edges | std::views::values) {
+                for (const Map::Corner *neighbour: edge->corners | std::views::values) {
+                    if (neighbour == corner) {
+                        continue;
+                    }
+                    occupied += neighbour->house.is_built();
+                    visited++;
+                }
+            }
+        }
+        sink = sink + occupied;
+        return visited;
+    }
+
+    auto flat_map_neighbour_walk(const Map::FlatMap &flat_map) -> std::uint64_t {
+        const auto &topology = flat_map.get_topology();
+        std::uint64_t visited = 0;
+        std::uint64_t occupied = 0;
+        for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+            for (const Map::EdgeId edge: topology.get_corner_edges(corner)) {
+                for (const Map::CornerId neighbour: topology.get_edge_corners(edge)) {
+                    if (neighbour == corner) {
+                        continue;
+                    }
+                    occupied += flat_map.get_house(neighbour).is_built();
+                    visited++;
+                }
+            }
+        }
+        sink = sink + occupied;
+        return visited;
+    }
+
+    auto map_board_scan(const Map::Map &map) -> std::uint64_t {
+        std::uint64_t visited = 0;
+        std::uint64_t production = 0;
+        for (const Map::Hex *hex: map.get_hexes() | std::views::values) {
+            for (const Map::Corner *corner: hex->corners | std::views::values) {
+                production += corner->house.is_built() ? hex->number : 0;
+                visited++;
+            }
+        }
+        sink = sink + production;
+        return visited;
+    }
+
+    auto flat_map_board_scan(const Map::FlatMap &flat_map) -> std::uint64_t {
+        const auto &topology = flat_map.get_topology();
+        std::uint64_t visited = 0;
+        std::uint64_t production = 0;
+        for (Map::HexId hex = 0; hex < topology.get_hex_count(); hex++) {
+            const int number = flat_map.get_hex_number(hex);
+            for (const Map::CornerId corner: topology.get_hex_corners(hex)) {
+                production += flat_map.get_house(corner).is_built() ? number : 0;
+                visited++;
+            }
+        }
+        sink = sink + production;
+        return visited;
+    }
+} // namespace
+
+auto main() -> int {
+    std::printf("%-8s %-16s %18s %18s %8s\n", "radius", "pattern", "Map nodes/s", "FlatMap nodes/s", "speedup");
+    for (const size_t radius: {2, 10, 100}) {
+        const auto map = Map::Map::build_map_of_size(radius);
+        // Sprinkle a few houses so the occupancy branch is not trivially predictable
+        size_t corner_index = 0;
+        for (Map::Corner *corner: map.get_corners() | std::views::values) {
+            if (corner_index++ % 7 == 0) {
+                corner->house = House{.owner = 0, .level = 1};
+            }
+        }
+        const auto flat_map = Map::FlatMap::from_map(map);
+
+        const double map_walk = measure_nodes_per_second([&] { return map_neighbour_walk(map); });
+        const double flat_walk = measure_nodes_per_second([&] { return flat_map_neighbour_walk(flat_map); });
+        std::printf("%-8zu %-16s %18.3e %18.3e %7.2fx\n", radius, "neighbour walk", map_walk, flat_walk,
+                    flat_walk / map_walk);
+
+        const double map_scan = measure_nodes_per_second([&] { return map_board_scan(map); });
+        const double flat_scan = measure_nodes_per_second([&] { return flat_map_board_scan(flat_map); });
+        std::printf("%-8zu %-16s %18.3e %18.3e %7.2fx\n", radius, "board scan", map_scan, flat_scan,
+                    flat_scan / map_scan);
+
+        const double map_clones = measure_nodes_per_second([&] {
+            const auto clone = map.clone();
+            sink = sink + clone.get_topology().get_hex_count();
+            return 1;
+        });
+        const double flat_clones = measure_nodes_per_second([&] {
+            const auto clone = flat_map;
+            sink = sink + clone.get_topology().get_hex_count();
+            return 1;
+        });
+        std::printf("%-8zu %-16s %18.3e %18.3e %7.2fx\n", radius, "new games/s", map_clones, flat_clones,
+                    flat_clones / map_clones);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Compares resolving the production of a roll by scanning every hex of the board, as the old engine loop did,
+// against reading the slots of the rolled number from the ProductionIndex.
+//
+// Usage: production_benchmark
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "flat_map.hh"
+#include "production_index.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto minimum_measure_time = std::chrono::milliseconds(300);
+    constexpr size_t player_count = 4;
+
+    volatile std::uint64_t sink = 0;
+
+    // Runs `pass` until the minimum measure time elapsed and returns the passes per second.
+    template<typename Pass>
+    auto measure_passes_per_second(Pass &&pass) -> double {
+        std::uint64_t passes = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < minimum_measure_time) {
+            pass();
+            passes++;
+            elapsed = Clock::now() - start;
+        }
+        return static_cast<double>(passes) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    void scan_production(const Map::FlatMap &flat_map, const int roll, std::vector<Game::ResourceBundle> &deltas) {
+        const auto &topology = flat_map.get_topology();
+        const Map::HexId robber = flat_map.get_state().get_robber();
+        for (Map::HexId hex = 0; hex < topology.get_hex_count(); hex++) {
+            if (hex == robber || flat_map.get_hex_number(hex) != roll) {
+                continue;
+            }
+            const Map::Resource resource = flat_map.get_hex_resource(hex);
+            for (const Map::CornerId corner: topology.get_hex_corners(hex)) {
+                const House &house = flat_map.get_house(corner);
+                if (house.is_built()) {
+                    deltas[house.owner][resource] += house.level;
+                }
+            }
+        }
+    }
+
+    auto checksum(const std::vector<Game::ResourceBundle> &deltas) -> std::uint64_t {
+        std::uint64_t total = 0;
+        for (const auto &delta: deltas) {
+            total += static_cast<std::uint64_t>(delta.total());
+        }
+        return total;
+    }
+} // namespace
+
+auto main() -> int {
+    std::printf("%-8s %10s %18s %18s %8s\n", "radius", "houses", "scan rolls/s", "index rolls/s", "speedup");
+    for (const size_t radius: {2, 10, 50, 200}) {
+        auto flat_map = Map::FlatMap::generate(radius, 3);
+        const auto &topology = flat_map.get_topology();
+
+        // Two settlements per player for every ten hexes, the density of a game in its middle stage
+        std::mt19937_64 random{5};
+        const size_t house_count = player_count * 2 * (1 + topology.get_hex_count() / 10);
+        for (size_t house = 0; house < house_count; house++) {
+            const auto corner = static_cast<Map::CornerId>(random() % topology.get_corner_count());
+            flat_map.set_house(corner, House{.owner = static_cast<PlayerId>(house % player_count), .level = 1});
+        }
+        const Game::ProductionIndex index{flat_map.get_shared_topology(), flat_map.get_state()};
+
+        std::vector<Game::ResourceBundle> deltas(player_count);
+        int roll = 2;
+        const auto next_roll = [&] { return roll = roll == 12 ? 2 : roll + 1; };
+        const double scan = measure_passes_per_second([&] {
+            scan_production(flat_map, next_roll(), deltas);
+            sink = sink + checksum(deltas);
+        });
+        const double indexed = measure_passes_per_second([&] {
+            index.produce(next_roll(), flat_map.get_state().get_robber(), deltas);
+            sink = sink + checksum(deltas);
+        });
+        std::printf("%-8zu %10zu %18.3e %18.3e %7.2fx\n", radius, house_count, scan, indexed, indexed / scan);
+    }
+    return 0;
+}
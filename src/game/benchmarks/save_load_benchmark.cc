@@ -0,0 +1,105 @@
+// Measures saving a game to disk and opening it again as the radius grows. Opening maps the file and checks the
+// header, so it should take the same few microseconds on every board; reading every record through the view and
+// loading a playable GameState from it are reported separately and grow with the number of nodes.
+//
+// Usage: save_load_benchmark [repetitions]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+#include "save_format.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    volatile std::uint64_t sink = 0;
+
+    auto seconds_since(const Clock::time_point start) -> double {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // A game with a settlement and a road on about one corner in twenty, spread over the board.
+    auto make_game(const size_t radius) -> Game::GameState {
+        Game::GameState state{Map::Map::build_map_of_size(radius, radius), 4, static_cast<std::uint32_t>(radius)};
+        const auto &layout = state.get_map().get_topology().get_bitboard_layout();
+        std::mt19937_64 random{radius};
+        const size_t pieces = std::max<size_t>(8, state.get_map().get_topology().get_corner_count() / 20);
+        for (size_t piece = 0; piece < pieces; piece++) {
+            std::vector<std::uint32_t> nodes;
+            layout.for_each_corner(state.get_setup_builds(), [&](const std::uint32_t node) { nodes.push_back(node); });
+            if (nodes.empty()) {
+                break;
+            }
+            const auto player = static_cast<PlayerId>(piece % 4);
+            state.place_house(nodes[random() % nodes.size()], House{.owner = player, .level = 1});
+            nodes.clear();
+            layout.for_each_edge(state.get_setup_roads(), [&](const std::uint32_t node) { nodes.push_back(node); });
+            if (!nodes.empty()) {
+                state.place_road(nodes[random() % nodes.size()], Road{player});
+            }
+        }
+        state.clear_undo_log();
+        return state;
+    }
+} // namespace
+
+auto main(const int argc, char **argv) -> int {
+    const int repetitions = argc > 1 ? std::atoi(argv[1]) : 200;
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "cololite_save_load_benchmark.clsv";
+
+    std::printf("%-8s %10s %10s %12s %12s %12s %12s\n", "radius", "nodes", "size KiB", "save ms", "open us",
+                "scan ms", "load ms");
+    for (const size_t radius: {2, 10, 50, 100, 150}) {
+        const Game::GameState state = make_game(radius);
+        const auto &topology = state.get_map().get_topology();
+        const size_t nodes = topology.get_hex_count() + topology.get_corner_count() + topology.get_edge_count();
+
+        auto start = Clock::now();
+        Game::save_game(state, path);
+        const double save = seconds_since(start);
+
+        // Fastest of the repetitions: the file is in the page cache after the first
+        double open = 1e9;
+        for (int repetition = 0; repetition < repetitions; repetition++) {
+            start = Clock::now();
+            const Game::MappedFile file(path);
+            const Game::SaveView view(file.get_bytes());
+            sink = sink + view.get_house(0).level;
+            open = std::min(open, seconds_since(start));
+        }
+
+        const Game::MappedFile file(path);
+        const Game::SaveView view(file.get_bytes());
+        start = Clock::now();
+        std::uint64_t built = 0;
+        for (const Game::SavedHouse &house: view.get_houses()) {
+            built += house.level;
+        }
+        for (const Game::SavedRoad &road: view.get_roads()) {
+            built += road.owner != NO_PLAYER;
+        }
+        const double scan = seconds_since(start);
+        sink = sink + built;
+
+        start = Clock::now();
+        const Game::GameState loaded = Game::load_game_state(view);
+        const double load = seconds_since(start);
+        sink = sink + loaded.get_hash();
+        if (loaded.get_hash() != state.get_hash()) {
+            std::fprintf(stderr, "radius %zu: the loaded game differs from the saved one\n", radius);
+            return 1;
+        }
+
+        std::printf("%-8zu %10zu %10.1f %12.3f %12.2f %12.3f %12.3f\n", radius, nodes,
+                    static_cast<double>(view.get_header().file_size.get()) / 1024, save * 1e3, open * 1e6,
+                    scan * 1e3, load * 1e3);
+    }
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Compares the ways a search can take back a line of play: undoing it through the GameState undo log, restoring a
+// snapshot taken before it, and rebuilding the GameState from a copy of the board as a search without either
+// would have to. Every pass plays the same line of moves and takes it back.
+//
+// Usage: undo_benchmark [moves per line]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "game_state.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto minimum_measure_time = std::chrono::milliseconds(300);
+    constexpr size_t player_count = 4;
+
+    volatile std::uint64_t sink = 0;
+
+    // Runs `pass` until the minimum measure time elapsed and returns the passes per second.
+    template<typename Pass>
+    auto measure_passes_per_second(Pass &&pass) -> double {
+        std::uint64_t passes = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < minimum_measure_time) {
+            pass();
+            passes++;
+            elapsed = Clock::now() - start;
+        }
+        return static_cast<double>(passes) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    struct Move {
+        enum class Kind { ROLL, HOUSE, ROAD, ROBBER } kind;
+        PlayerId player;
+        std::uint32_t node;
+    };
+
+    void apply(Game::GameState &state, const Move &move) {
+        switch (move.kind) {
+            case Move::Kind::ROLL:
+                sink = sink + static_cast<std::uint64_t>(state.roll_dice());
+                break;
+            case Move::Kind::HOUSE:
+                state.place_house(move.node, House{.owner = move.player, .level = 1});
+                break;
+            case Move::Kind::ROAD:
+                state.place_road(move.node, Road{move.player});
+                break;
+            case Move::Kind::ROBBER:
+                state.set_robber(move.node);
+                break;
+        }
+    }
+
+    template<typename Board>
+    auto first_node(const Map::BitboardLayout &layout, const Board &board) -> std::uint32_t {
+        std::uint32_t first = Map::NO_NODE;
+        const auto keep_first = [&](const std::uint32_t node) { first = std::min(first, node); };
+        if constexpr (std::is_same_v<Board, Map::CornerBoard>) {
+            layout.for_each_corner(board, keep_first);
+        } else {
+            layout.for_each_edge(board, keep_first);
+        }
+        return first;
+    }
+
+    // Plays the opening and picks a line of legal moves after it, leaving `state` at the start of the line.
+    auto make_line(Game::GameState &state, const size_t length) -> std::vector<Move> {
+        const auto &layout = state.get_map().get_topology().get_bitboard_layout();
+        std::mt19937_64 random{length};
+        for (int round = 0; round < 2; round++) {
+            for (PlayerId player = 0; player < static_cast<PlayerId>(player_count); player++) {
+                state.place_house(first_node(layout, state.get_setup_builds()), House{.owner = player, .level = 1});
+                state.place_road(first_node(layout, state.get_setup_roads()), Road{player});
+            }
+        }
+        state.clear_undo_log();
+
+        std::vector<Move> line;
+        while (line.size() < length) {
+            const auto player = static_cast<PlayerId>(line.size() % player_count);
+            Move move{Move::Kind::ROLL, player, 0};
+            switch (random() % 4) {
+                case 1:
+                    move = {Move::Kind::HOUSE, player, first_node(layout, state.get_legal_builds(player))};
+                    break;
+                case 2:
+                    move = {Move::Kind::ROAD, player, first_node(layout, state.get_legal_roads(player))};
+                    break;
+                case 3:
+                    move = {
+                        Move::Kind::ROBBER, player,
+                        static_cast<std::uint32_t>(random() % state.get_map().get_topology().get_hex_count())
+                    };
+                    break;
+                default:
+                    break;
+            }
+            if (move.node == Map::NO_NODE) {
+                continue;
+            }
+            apply(state, move);
+            line.push_back(move);
+        }
+        state.undo(0);
+        return line;
+    }
+} // namespace
+
+auto main(const int argc, char **argv) -> int {
+    const size_t length = argc > 1 ? std::stoul(argv[1]) : 8;
+    std::printf("%-8s %-6s %16s %16s %16s %10s\n", "radius", "moves", "undo lines/s", "restore lines/s",
+                "rebuild lines/s", "undo gain");
+    for (const size_t radius: {2, 10, 30}) {
+        const auto board = Map::Map::build_map_of_size(radius, 1);
+        Game::GameState state{board.clone(), player_count, 1};
+        const std::vector<Move> line = make_line(state, length);
+
+        const double undo = measure_passes_per_second([&] {
+            const Game::UndoMark mark = state.get_undo_mark();
+            for (const Move &move: line) {
+                apply(state, move);
+            }
+            state.undo(mark);
+        });
+
+        Game::GameStateSnapshot snapshot;
+        state.snapshot(snapshot);
+        const double restore = measure_passes_per_second([&] {
+            for (const Move &move: line) {
+                apply(state, move);
+            }
+            state.restore(snapshot);
+        });
+
+        // Without a way back, every line starts from a fresh state with the opening replayed
+        const double rebuild = measure_passes_per_second([&] {
+            Game::GameState fresh{board.clone(), player_count, 1};
+            make_line(fresh, 0);
+            for (const Move &move: line) {
+                apply(fresh, move);
+            }
+            sink = sink + fresh.get_undo_mark();
+        });
+
+        std::printf("%-8zu %-6zu %16.3e %16.3e %16.3e %9.2fx\n", radius, length, undo, restore, rebuild,
+                    undo / rebuild);
+    }
+    return 0;
+}
@@ -0,0 +1,241 @@
+#include "headers/bitboard.hh"
+#include <algorithm>
+#include <utility>
+
+namespace Map {
+    Bitboard::Bitboard(const size_t bit_count) : m_bit_count(bit_count), m_word_count((bit_count + 63) / 64) {
+        if (m_word_count > INLINE_WORDS) {
+            m_heap = std::make_unique<std::uint64_t[]>(m_word_count);
+        }
+    }
+
+    Bitboard::Bitboard(const Bitboard &other) : Bitboard(other.m_bit_count) {
+        std::copy_n(other.words(), m_word_count, words());
+    }
+
+    auto Bitboard::operator=(const Bitboard &other) -> Bitboard & {
+        if (this != &other) {
+            if (m_word_count != other.m_word_count) {
+                *this = Bitboard{other.m_bit_count};
+            }
+            m_bit_count = other.m_bit_count;
+            std::copy_n(other.words(), m_word_count, words());
+        }
+        return *this;
+    }
+
+    Bitboard::Bitboard(Bitboard &&other) noexcept : m_bit_count(std::exchange(other.m_bit_count, 0)),
+                                                    m_word_count(std::exchange(other.m_word_count, 0)),
+                                                    m_inline(other.m_inline), m_heap(std::move(other.m_heap)) {
+    }
+
+    auto Bitboard::operator=(Bitboard &&other) noexcept -> Bitboard & {
+        if (this != &other) {
+            m_bit_count = std::exchange(other.m_bit_count, 0);
+            m_word_count = std::exchange(other.m_word_count, 0);
+            m_inline = other.m_inline;
+            m_heap = std::move(other.m_heap);
+        }
+        return *this;
+    }
+
+    void Bitboard::clear_tail() {
+        if (const size_t used = m_bit_count % 64; used != 0) {
+            words()[m_word_count - 1] &= (std::uint64_t{1} << used) - 1;
+        }
+    }
+
+    auto Bitboard::count() const -> size_t {
+        const std::uint64_t *data = words();
+        size_t total = 0;
+        for (size_t word = 0; word < m_word_count; word++) {
+            total += static_cast<size_t>(std::popcount(data[word]));
+        }
+        return total;
+    }
+
+    auto Bitboard::any() const -> bool {
+        const std::uint64_t *data = words();
+        std::uint64_t all = 0;
+        for (size_t word = 0; word < m_word_count; word++) {
+            all |= data[word];
+        }
+        return all != 0;
+    }
+
+    auto Bitboard::gathered(const std::ptrdiff_t offset) const -> Bitboard {
+        Bitboard result{m_bit_count};
+        const std::uint64_t *data = words();
+        std::uint64_t *out = result.words();
+        const auto word_count = static_cast<std::ptrdiff_t>(m_word_count);
+        // offset = 64 * word_shift + bit_shift with bit_shift in [0, 64)
+        const std::ptrdiff_t word_shift = offset >= 0 ? offset / 64 : -((-offset + 63) / 64);
+        const auto bit_shift = static_cast<unsigned>(offset - word_shift * 64);
+        const auto word_at = [&](const std::ptrdiff_t word) -> std::uint64_t {
+            return word >= 0 && word < word_count ? data[word] : 0;
+        };
+        for (std::ptrdiff_t word = 0; word < word_count; word++) {
+            const std::uint64_t low = word_at(word + word_shift);
+            const std::uint64_t high = word_at(word + word_shift + 1);
+            out[word] = bit_shift == 0 ? low : low >> bit_shift | high << (64 - bit_shift);
+        }
+        result.clear_tail();
+        return result;
+    }
+
+    auto Bitboard::operator|=(const Bitboard &other) -> Bitboard & {
+        std::uint64_t *data = words();
+        const std::uint64_t *other_data = other.words();
+        for (size_t word = 0; word < m_word_count; word++) {
+            data[word] |= other_data[word];
+        }
+        return *this;
+    }
+
+    auto Bitboard::operator&=(const Bitboard &other) -> Bitboard & {
+        std::uint64_t *data = words();
+        const std::uint64_t *other_data = other.words();
+        for (size_t word = 0; word < m_word_count; word++) {
+            data[word] &= other_data[word];
+        }
+        return *this;
+    }
+
+    auto Bitboard::and_not(const Bitboard &other) -> Bitboard & {
+        std::uint64_t *data = words();
+        const std::uint64_t *other_data = other.words();
+        for (size_t word = 0; word < m_word_count; word++) {
+            data[word] &= ~other_data[word];
+        }
+        return *this;
+    }
+
+    auto Bitboard::operator==(const Bitboard &other) const -> bool {
+        return m_bit_count == other.m_bit_count && std::equal(words(), words() + m_word_count, other.words());
+    }
+
+    // Plane indices follow the canonical directions: RIGHT = 0 and BOTTOM_RIGHT = 1 for corners, BOTTOM_RIGHT = 0,
+    // BOTTOM = 1 and BOTTOM_LEFT = 2 for edges. Written as A(q, r), B(q, r) for the corners and E0, E1, E2 for the
+    // edges of hex (q, r):
+    //
+    //   E0(q, r) joins A(q, r) and B(q, r)
+    //   E1(q, r) joins B(q, r) and A(q - 1, r + 1)
+    //   E2(q, r) joins A(q - 1, r + 1) and B(q - 1, r)
+    //
+    // Every neighbour query below is that table read in one direction or the other.
+    namespace {
+        constexpr size_t A = 0;
+        constexpr size_t B = 1;
+        constexpr size_t E0 = 0;
+        constexpr size_t E1 = 1;
+        constexpr size_t E2 = 2;
+    } // namespace
+
+    BitboardLayout::BitboardLayout(const size_t radius, const std::span<const CornerCoord> canonical_corners,
+                                   const std::span<const EdgeCoord> canonical_edges)
+        : m_reach(static_cast<std::ptrdiff_t>(radius) + 1), m_width(2 * m_reach + 2),
+          m_plane_bits(static_cast<size_t>(m_width * (2 * m_reach + 1))) {
+        m_corners = make_corner_board();
+        m_edges = make_edge_board();
+        m_corner_ids.assign(m_corners.planes.size() * m_plane_bits, UINT32_MAX);
+        m_edge_ids.assign(m_edges.planes.size() * m_plane_bits, UINT32_MAX);
+        m_corner_slots.reserve(canonical_corners.size());
+        m_edge_slots.reserve(canonical_edges.size());
+
+        for (const auto &coord: canonical_corners) {
+            const auto plane = static_cast<size_t>(coord.corner_direction);
+            const size_t bit = get_bit(coord.hex_coord);
+            const auto slot = static_cast<std::uint32_t>(plane * m_plane_bits + bit);
+            m_corner_ids[slot] = static_cast<std::uint32_t>(m_corner_slots.size());
+            m_corner_slots.push_back(slot);
+            m_corners.planes[plane].set(bit);
+        }
+        for (const auto &coord: canonical_edges) {
+            const auto plane = static_cast<size_t>(coord.edge_direction);
+            const size_t bit = get_bit(coord.hex_coord);
+            const auto slot = static_cast<std::uint32_t>(plane * m_plane_bits + bit);
+            m_edge_ids[slot] = static_cast<std::uint32_t>(m_edge_slots.size());
+            m_edge_slots.push_back(slot);
+            m_edges.planes[plane].set(bit);
+        }
+    }
+
+    auto BitboardLayout::get_bit(const HexCoord2 &coord) const -> size_t {
+        return static_cast<size_t>((coord.r + m_reach) * m_width + coord.q + m_reach);
+    }
+
+    auto BitboardLayout::gathered(const Bitboard &plane, const int dq, const int dr) const -> Bitboard {
+        return plane.gathered(dr * m_width + dq);
+    }
+
+    auto BitboardLayout::make_corner_board() const -> CornerBoard {
+        return {{Bitboard{m_plane_bits}, Bitboard{m_plane_bits}}};
+    }
+
+    auto BitboardLayout::make_edge_board() const -> EdgeBoard {
+        return {{Bitboard{m_plane_bits}, Bitboard{m_plane_bits}, Bitboard{m_plane_bits}}};
+    }
+
+    void BitboardLayout::insert(CornerBoard &board, const std::uint32_t corner) const {
+        const std::uint32_t slot = m_corner_slots[corner];
+        board.planes[slot / m_plane_bits].set(slot % m_plane_bits);
+    }
+
+    void BitboardLayout::insert(EdgeBoard &board, const std::uint32_t edge) const {
+        const std::uint32_t slot = m_edge_slots[edge];
+        board.planes[slot / m_plane_bits].set(slot % m_plane_bits);
+    }
+
+    void BitboardLayout::erase(CornerBoard &board, const std::uint32_t corner) const {
+        const std::uint32_t slot = m_corner_slots[corner];
+        board.planes[slot / m_plane_bits].reset(slot % m_plane_bits);
+    }
+
+    void BitboardLayout::erase(EdgeBoard &board, const std::uint32_t edge) const {
+        const std::uint32_t slot = m_edge_slots[edge];
+        board.planes[slot / m_plane_bits].reset(slot % m_plane_bits);
+    }
+
+    auto BitboardLayout::contains(const CornerBoard &board, const std::uint32_t corner) const -> bool {
+        const std::uint32_t slot = m_corner_slots[corner];
+        return board.planes[slot / m_plane_bits].test(slot % m_plane_bits);
+    }
+
+    auto BitboardLayout::contains(const EdgeBoard &board, const std::uint32_t edge) const -> bool {
+        const std::uint32_t slot = m_edge_slots[edge];
+        return board.planes[slot / m_plane_bits].test(slot % m_plane_bits);
+    }
+
+    auto BitboardLayout::get_neighbouring_corners(const CornerBoard &corners) const -> CornerBoard {
+        // A(q, r) neighbours B(q, r), B(q, r - 1) and B(q + 1, r - 1); B(q, r) the reverse
+        CornerBoard neighbours = corners;
+        std::swap(neighbours.planes[A], neighbours.planes[B]);
+        neighbours.planes[A] |= gathered(corners.planes[B], 0, -1);
+        neighbours.planes[A] |= gathered(corners.planes[B], 1, -1);
+        neighbours.planes[B] |= gathered(corners.planes[A], 0, 1);
+        neighbours.planes[B] |= gathered(corners.planes[A], -1, 1);
+        // The outward neighbours of the outer corners are off the board
+        neighbours &= m_corners;
+        return neighbours;
+    }
+
+    auto BitboardLayout::get_edge_ends(const EdgeBoard &edges) const -> CornerBoard {
+        CornerBoard ends{{edges.planes[E0], edges.planes[E0]}};
+        ends.planes[A] |= gathered(edges.planes[E1], 1, -1);
+        ends.planes[A] |= gathered(edges.planes[E2], 1, -1);
+        ends.planes[B] |= edges.planes[E1];
+        ends.planes[B] |= gathered(edges.planes[E2], 1, 0);
+        return ends;
+    }
+
+    auto BitboardLayout::get_corner_edges(const CornerBoard &corners) const -> EdgeBoard {
+        const Bitboard lower_left_a = gathered(corners.planes[A], -1, 1);
+        EdgeBoard edges{{corners.planes[A], corners.planes[B], lower_left_a}};
+        edges.planes[E0] |= corners.planes[B];
+        edges.planes[E1] |= lower_left_a;
+        edges.planes[E2] |= gathered(corners.planes[B], -1, 0);
+        // The outward edges of the outer corners are off the board
+        edges &= m_edges;
+        return edges;
+    }
+} // namespace Map
@@ -0,0 +1,102 @@
+#include "headers/board_bitboards.hh"
+#include <utility>
+
+namespace Map {
+    BoardBitboards::BoardBitboards(std::shared_ptr<const BoardTopology> topology, const size_t player_count)
+        : m_topology(std::move(topology)) {
+        const auto &layout = get_layout();
+        m_players.assign(player_count, PlayerPieces{
+                             .settlements = layout.make_corner_board(),
+                             .cities = layout.make_corner_board(),
+                             .roads = layout.make_edge_board(),
+                         });
+        m_houses = layout.make_corner_board();
+        m_roads = layout.make_edge_board();
+    }
+
+    BoardBitboards BoardBitboards::from_state(std::shared_ptr<const BoardTopology> topology, const BoardState &state,
+                                              const size_t player_count) {
+        BoardBitboards bitboards{std::move(topology), player_count};
+        const auto &board_topology = bitboards.get_topology();
+        for (CornerId corner = 0; corner < board_topology.get_corner_count(); corner++) {
+            if (state.get_house(corner).is_built()) {
+                bitboards.set_house(corner, state.get_house(corner));
+            }
+        }
+        for (EdgeId edge = 0; edge < board_topology.get_edge_count(); edge++) {
+            if (state.get_road(edge).is_built()) {
+                bitboards.set_road(edge, state.get_road(edge));
+            }
+        }
+        return bitboards;
+    }
+
+    void BoardBitboards::set_house(const CornerId corner, const House &house) {
+        const auto &layout = get_layout();
+        for (auto &pieces: m_players) {
+            layout.erase(pieces.settlements, corner);
+            layout.erase(pieces.cities, corner);
+        }
+        if (!house.is_built()) {
+            layout.erase(m_houses, corner);
+            return;
+        }
+        layout.insert(m_houses, corner);
+        auto &pieces = m_players[house.owner];
+        layout.insert(house.level == 1 ? pieces.settlements : pieces.cities, corner);
+    }
+
+    void BoardBitboards::set_road(const EdgeId edge, const Road &road) {
+        const auto &layout = get_layout();
+        for (auto &pieces: m_players) {
+            layout.erase(pieces.roads, edge);
+        }
+        if (!road.is_built()) {
+            layout.erase(m_roads, edge);
+            return;
+        }
+        layout.insert(m_roads, edge);
+        layout.insert(m_players[road.owner].roads, edge);
+    }
+
+    auto BoardBitboards::get_free_corners() const -> CornerBoard {
+        const auto &layout = get_layout();
+        CornerBoard free = layout.get_corners();
+        free.and_not(m_houses);
+        free.and_not(layout.get_neighbouring_corners(m_houses));
+        return free;
+    }
+
+    auto BoardBitboards::get_legal_settlements(const PlayerId player) const -> CornerBoard {
+        CornerBoard legal = get_free_corners();
+        legal &= get_layout().get_edge_ends(m_players[player].roads);
+        return legal;
+    }
+
+    auto BoardBitboards::get_legal_roads(const PlayerId player) const -> EdgeBoard {
+        const auto &layout = get_layout();
+        const PlayerPieces &pieces = m_players[player];
+
+        // A road continues through a corner unless an opponent has built there
+        CornerBoard own_houses = pieces.settlements;
+        own_houses |= pieces.cities;
+        CornerBoard opponent_houses = m_houses;
+        opponent_houses.and_not(own_houses);
+        CornerBoard anchors = layout.get_edge_ends(pieces.roads);
+        anchors.and_not(opponent_houses);
+        anchors |= own_houses;
+
+        EdgeBoard legal = layout.get_corner_edges(anchors);
+        legal.and_not(m_roads);
+        return legal;
+    }
+
+    auto BoardBitboards::get_legal_roads_from(const CornerId corner) const -> EdgeBoard {
+        const auto &layout = get_layout();
+        CornerBoard anchor = layout.make_corner_board();
+        layout.insert(anchor, corner);
+        EdgeBoard legal = layout.get_corner_edges(anchor);
+        legal.and_not(m_roads);
+        return legal;
+    }
+} // namespace Map
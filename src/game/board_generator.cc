@@ -0,0 +1,69 @@
+#include "headers/board_generator.hh"
+#include <stdexcept>
+#include <utility>
+
+namespace Map {
+    TileDistribution TileDistribution::standard() {
+        return TileDistribution{
+            .resources = {
+                Resource::WHEAT, Resource::WHEAT, Resource::WHEAT, Resource::WHEAT, Resource::WOOD,
+                Resource::WOOD, Resource::WOOD, Resource::WOOD, Resource::SHEEP, Resource::SHEEP,
+                Resource::SHEEP, Resource::SHEEP, Resource::BRICK, Resource::BRICK, Resource::BRICK,
+                Resource::STONE, Resource::STONE, Resource::STONE
+            },
+            .numbers = {2, 3, 3, 4, 4, 5, 5, 6, 6, 8, 8, 9, 9, 10, 10, 11, 11, 12},
+            .desert_count = 1,
+        };
+    }
+
+    BoardGenerator::BoardGenerator(const std::uint64_t seed, TileDistribution distribution)
+        : m_rng(seed), m_distribution(std::move(distribution)), m_next_tile(0) {
+        if (m_distribution.get_deck_size() == 0) {
+            throw std::invalid_argument("Tile distribution has no tiles");
+        }
+        if (m_distribution.numbers.size() != m_distribution.resources.size()) {
+            throw std::invalid_argument("Tile distribution needs one number token per producing tile");
+        }
+        m_deck.reserve(m_distribution.get_deck_size());
+        deal_deck();
+    }
+
+    auto BoardGenerator::next_tile() -> HexTile {
+        if (m_next_tile == m_deck.size()) {
+            deal_deck();
+        }
+        return m_deck[m_next_tile++];
+    }
+
+    void BoardGenerator::deal_deck() {
+        shuffle(m_distribution.resources);
+        shuffle(m_distribution.numbers);
+        m_deck.clear();
+        for (size_t i = 0; i < m_distribution.resources.size(); i++) {
+            m_deck.push_back({m_distribution.resources[i], m_distribution.numbers[i]});
+        }
+        for (size_t i = 0; i < m_distribution.desert_count; i++) {
+            m_deck.push_back({Resource::NONE, 7});
+        }
+        shuffle(m_deck);
+        m_next_tile = 0;
+    }
+
+    // Uniform draw in [0, bound) by rejection, so the result does not depend on the standard library.
+    auto BoardGenerator::draw_below(const std::uint64_t bound) -> std::uint64_t {
+        const std::uint64_t limit = std::mt19937_64::max() - std::mt19937_64::max() % bound;
+        std::uint64_t value;
+        do {
+            value = m_rng();
+        } while (value >= limit);
+        return value % bound;
+    }
+
+    // Fisher-Yates
+    template<typename T>
+    void BoardGenerator::shuffle(std::vector<T> &values) {
+        for (size_t i = values.size(); i > 1; i--) {
+            std::swap(values[i - 1], values[draw_below(i)]);
+        }
+    }
+} // namespace Map
@@ -0,0 +1,26 @@
+#include "headers/board_state.hh"
+
+namespace Map {
+    BoardState::BoardState(const BoardTopology &topology) : m_hex_resources(topology.get_hex_count(), Resource::NONE),
+                                                             m_hex_numbers(topology.get_hex_count(), 0),
+                                                             m_corner_houses(topology.get_corner_count()),
+                                                             m_edge_roads(topology.get_edge_count()) {
+    }
+
+    void BoardState::set_hex(const HexId hex, const Resource resource, const int number) {
+        m_hex_resources[hex] = resource;
+        m_hex_numbers[hex] = static_cast<std::int8_t>(number);
+    }
+
+    void BoardState::set_house(const CornerId corner, const House &house) { m_corner_houses[corner] = house; }
+
+    void BoardState::set_road(const EdgeId edge, const Road &road) { m_edge_roads[edge] = road; }
+
+    void BoardState::set_robber(const HexId hex) { m_robber = hex; }
+
+    auto BoardState::get_memory_usage() const -> size_t {
+        return sizeof(BoardState) + m_hex_resources.capacity() * sizeof(Resource) +
+               m_hex_numbers.capacity() * sizeof(std::int8_t) + m_corner_houses.capacity() * sizeof(House) +
+               m_edge_roads.capacity() * sizeof(Road);
+    }
+} // namespace Map
@@ -0,0 +1,194 @@
+
+#include "headers/board_topology.hh"
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace Map {
+    AdjacencyTable AdjacencyTable::from_pairs(const size_t node_count,
+                                              const std::vector<std::pair<std::uint32_t, std::uint32_t> > &pairs) {
+        AdjacencyTable table;
+        table.m_offsets.assign(node_count + 1, 0);
+        for (const auto &[node, _]: pairs) {
+            table.m_offsets[node + 1]++;
+        }
+        for (size_t i = 0; i < node_count; i++) {
+            table.m_offsets[i + 1] += table.m_offsets[i];
+        }
+        table.m_indices.resize(pairs.size());
+        std::vector<std::uint32_t> cursor(table.m_offsets.begin(), table.m_offsets.end() - 1);
+        for (const auto &[node, neighbour]: pairs) {
+            table.m_indices[cursor[node]++] = neighbour;
+        }
+        return table;
+    }
+
+    void AdjacencyTable::append_row(const std::span<const std::uint32_t> row) {
+        m_indices.insert(m_indices.end(), row.begin(), row.end());
+        m_offsets.push_back(static_cast<std::uint32_t>(m_indices.size()));
+    }
+
+    auto AdjacencyTable::get_node_count() const -> size_t { return m_offsets.size() - 1; }
+
+    BoardTopology::BoardTopology(const MapBounds &bounds) : m_bounds(bounds) {
+    }
+
+    BoardTopology BoardTopology::build(const MapBounds &bounds) {
+        BoardTopology topology{bounds};
+        std::vector<std::pair<CornerId, HexId> > corner_hexes;
+        std::vector<std::pair<CornerId, EdgeId> > corner_edges;
+        std::vector<std::pair<EdgeId, CornerId> > edge_corners;
+
+        // Node counts of a hexagonal board are known up front, reserving avoids rehashing and regrowth on the
+        // large boards.
+        const size_t r = bounds.radius;
+        const size_t hex_count = 3 * r * r + 3 * r + 1;
+        const size_t corner_count = 6 * (r + 1) * (r + 1);
+        const size_t edge_count = 3 * (r + 1) * (3 * r + 2);
+        topology.m_hex_coords.reserve(hex_count);
+        topology.m_corner_coords.reserve(corner_count);
+        topology.m_edge_coords.reserve(edge_count);
+        // Canonical names of the outer corners and edges use the ring of hexes just outside the board
+        const size_t lattice_width = 2 * r + 3;
+        topology.m_hex_ids.assign(lattice_width * lattice_width, NO_NODE);
+        topology.m_corner_ids.assign(2 * lattice_width * lattice_width, NO_NODE);
+        topology.m_edge_ids.assign(3 * lattice_width * lattice_width, NO_NODE);
+        corner_hexes.reserve(6 * hex_count);
+        corner_edges.reserve(2 * edge_count);
+        edge_corners.reserve(2 * edge_count);
+
+        for (const auto &coord: MapCoords(static_cast<int>(bounds.radius))) {
+            const auto hex = static_cast<HexId>(topology.m_hex_coords.size());
+            topology.m_hex_coords.push_back(coord);
+            topology.m_hex_ids[*topology.get_lattice_index(coord)] = hex;
+
+            std::array<CornerId, 6> hex_corners{};
+            for (const auto &corner_direction: HEX_CORNER_DIRECTIONS) {
+                const CornerCoord canonical_coord = canonical_corner_coord({coord, corner_direction});
+                CornerId &corner = topology.m_corner_ids[*topology.get_corner_slot(canonical_coord)];
+                if (corner == NO_NODE) {
+                    corner = static_cast<CornerId>(topology.m_corner_coords.size());
+                    topology.m_corner_coords.push_back(canonical_coord);
+                }
+                hex_corners[static_cast<int>(corner_direction)] = corner;
+                corner_hexes.emplace_back(corner, hex);
+            }
+            topology.m_hex_corners.append_row(hex_corners);
+
+            std::array<EdgeId, 6> hex_edges{};
+            for (const auto &edge_direction: HEX_EDGE_DIRECTIONS) {
+                const EdgeCoord canonical_coord = canonical_edge_coord({coord, edge_direction});
+                EdgeId &edge_slot = topology.m_edge_ids[*topology.get_edge_slot(canonical_coord)];
+                const bool inserted = edge_slot == NO_NODE;
+                if (inserted) {
+                    edge_slot = static_cast<EdgeId>(topology.m_edge_coords.size());
+                }
+                const EdgeId edge = edge_slot;
+                hex_edges[static_cast<int>(edge_direction)] = edge;
+                if (!inserted) {
+                    continue;
+                }
+                topology.m_edge_coords.push_back(canonical_coord);
+                for (const auto &corner_direction:
+                     EDGE_TO_HEX_CORNER_DIRECTION_MAPPING[static_cast<int>(edge_direction)]) {
+                    const CornerId corner = hex_corners[static_cast<int>(corner_direction)];
+                    edge_corners.emplace_back(edge, corner);
+                    corner_edges.emplace_back(corner, edge);
+                }
+            }
+            topology.m_hex_edges.append_row(hex_edges);
+        }
+
+        topology.m_corner_hexes = AdjacencyTable::from_pairs(topology.m_corner_coords.size(), corner_hexes);
+        topology.m_corner_edges = AdjacencyTable::from_pairs(topology.m_corner_coords.size(), corner_edges);
+        topology.m_edge_corners = AdjacencyTable::from_pairs(topology.m_edge_coords.size(), edge_corners);
+        topology.m_bitboard_layout = BitboardLayout{bounds.radius, topology.m_corner_coords, topology.m_edge_coords};
+        return topology;
+    }
+
+    std::shared_ptr<const BoardTopology> BoardTopology::shared(const MapBounds &bounds) {
+        static std::mutex mutex;
+        static std::unordered_map<size_t, std::weak_ptr<const BoardTopology> > topologies;
+
+        const std::lock_guard lock{mutex};
+        std::weak_ptr<const BoardTopology> &cached = topologies[bounds.radius];
+        if (auto topology = cached.lock()) {
+            return topology;
+        }
+        auto topology = std::make_shared<const BoardTopology>(build(bounds));
+        cached = topology;
+        return topology;
+    }
+
+    auto BoardTopology::get_bounds() const -> const MapBounds & { return m_bounds; }
+
+    auto BoardTopology::get_hex_coord(const HexId hex) const -> const HexCoord2 & { return m_hex_coords[hex]; }
+
+    auto BoardTopology::get_corner_coord(const CornerId corner) const -> const CornerCoord & {
+        return m_corner_coords[corner];
+    }
+
+    auto BoardTopology::get_edge_coord(const EdgeId edge) const -> const EdgeCoord & { return m_edge_coords[edge]; }
+
+    auto BoardTopology::get_lattice_index(const HexCoord2 &coord) const -> std::optional<size_t> {
+        const auto reach = static_cast<std::ptrdiff_t>(m_bounds.radius) + 1;
+        if (coord.q < -reach || coord.q > reach || coord.r < -reach || coord.r > reach) {
+            return std::nullopt;
+        }
+        const auto width = 2 * reach + 1;
+        return static_cast<size_t>((coord.r + reach) * width + coord.q + reach);
+    }
+
+    auto BoardTopology::get_corner_slot(const CornerCoord &canonical_coord) const -> std::optional<size_t> {
+        const auto index = get_lattice_index(canonical_coord.hex_coord);
+        if (!index.has_value()) {
+            return std::nullopt;
+        }
+        return 2 * *index + static_cast<size_t>(canonical_coord.corner_direction);
+    }
+
+    auto BoardTopology::get_edge_slot(const EdgeCoord &canonical_coord) const -> std::optional<size_t> {
+        const auto index = get_lattice_index(canonical_coord.hex_coord);
+        if (!index.has_value()) {
+            return std::nullopt;
+        }
+        return 3 * *index + static_cast<size_t>(canonical_coord.edge_direction);
+    }
+
+    auto BoardTopology::find_hex(const HexCoord2 &coord) const -> std::optional<HexId> {
+        const auto index = get_lattice_index(coord);
+        if (!index.has_value() || m_hex_ids[*index] == NO_NODE) {
+            return std::nullopt;
+        }
+        return m_hex_ids[*index];
+    }
+
+    auto BoardTopology::find_corner(const CornerCoord &coord) const -> std::optional<CornerId> {
+        const auto slot = get_corner_slot(canonical_corner_coord(coord));
+        if (!slot.has_value() || m_corner_ids[*slot] == NO_NODE) {
+            return std::nullopt;
+        }
+        return m_corner_ids[*slot];
+    }
+
+    auto BoardTopology::find_edge(const EdgeCoord &coord) const -> std::optional<EdgeId> {
+        const auto slot = get_edge_slot(canonical_edge_coord(coord));
+        if (!slot.has_value() || m_edge_ids[*slot] == NO_NODE) {
+            return std::nullopt;
+        }
+        return m_edge_ids[*slot];
+    }
+
+    auto BoardTopology::find_corner(const CornerKey key) const -> std::optional<CornerId> {
+        return find_corner(decode_corner(key));
+    }
+
+    auto BoardTopology::find_edge(const EdgeKey key) const -> std::optional<EdgeId> { return find_edge(decode_edge(key)); }
+
+    auto BoardTopology::get_corner_key(const CornerId corner) const -> CornerKey {
+        return encode_corner(m_corner_coords[corner]);
+    }
+
+    auto BoardTopology::get_edge_key(const EdgeId edge) const -> EdgeKey { return encode_edge(m_edge_coords[edge]); }
+} // namespace Map
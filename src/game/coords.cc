@@ -4,100 +4,6 @@
 #include <stdexcept>
 #include <string>
 
-namespace Map {
-
-    HexEdgeDirection opposite_direction(const HexEdgeDirection &direction) {
-        return static_cast<HexEdgeDirection>(static_cast<int>(direction) + 3 % 6);
-    }
-
-    HexCornerDirection opposite_direction(const HexCornerDirection &direction) {
-        return static_cast<HexCornerDirection>(static_cast<int>(direction) + 3 % 6);
-    }
-
-    CornerEdgeDirection opposite_direction(const CornerEdgeDirection &direction) {
-        return static_cast<CornerEdgeDirection>(static_cast<int>(direction) + 3 % 6);
-    }
-
-    HexCornerDirection edge_direction_to_corner_direction(const HexEdgeDirection &edge_direction,
-                                                          const CornerEdgeDirection &edge_corner_direction) {
-#define CORNER_EDGE_TO_HEX_CORNER(direction1, corner_direction1, direction2, corner_direction2)                        \
-    switch (edge_corner_direction) {                                                                                   \
-        case direction1:                                                                                               \
-            return corner_direction1;                                                                                  \
-        case direction2:                                                                                               \
-            return corner_direction2;                                                                                  \
-        default:                                                                                                       \
-            throw std::runtime_error("This edge " + to_string(edge_direction) + "does not support this corner." +      \
-                                     to_string(edge_corner_direction));                                                \
-            break;                                                                                                     \
-    }
-
-        switch (edge_direction) {
-            case HexEdgeDirection::BOTTOM_RIGHT:
-                CORNER_EDGE_TO_HEX_CORNER(CornerEdgeDirection::BOTTOM_LEFT, HexCornerDirection::BOTTOM_RIGHT,
-                                          CornerEdgeDirection::TOP_RIGHT, HexCornerDirection::RIGHT);
-            case HexEdgeDirection::BOTTOM:
-                CORNER_EDGE_TO_HEX_CORNER(CornerEdgeDirection::LEFT, HexCornerDirection::BOTTOM_LEFT,
-                                          CornerEdgeDirection::RIGHT, HexCornerDirection::BOTTOM_RIGHT);
-            case HexEdgeDirection::BOTTOM_LEFT:
-                CORNER_EDGE_TO_HEX_CORNER(CornerEdgeDirection::BOTTOM_RIGHT, HexCornerDirection::BOTTOM_LEFT,
-                                          CornerEdgeDirection::TOP_LEFT, HexCornerDirection::LEFT);
-            case HexEdgeDirection::TOP_LEFT:
-                CORNER_EDGE_TO_HEX_CORNER(CornerEdgeDirection::BOTTOM_LEFT, HexCornerDirection::LEFT,
-                                          CornerEdgeDirection::TOP_RIGHT, HexCornerDirection::TOP_LEFT);
-            case HexEdgeDirection::TOP:
-                CORNER_EDGE_TO_HEX_CORNER(CornerEdgeDirection::LEFT, HexCornerDirection::TOP_LEFT,
-                                          CornerEdgeDirection::RIGHT, HexCornerDirection::TOP_RIGHT);
-            case HexEdgeDirection::TOP_RIGHT:
-                CORNER_EDGE_TO_HEX_CORNER(CornerEdgeDirection::BOTTOM_RIGHT, HexCornerDirection::RIGHT,
-                                          CornerEdgeDirection::TOP_LEFT, HexCornerDirection::TOP_RIGHT);
-            default:
-                throw std::runtime_error("Unknown edge direction");
-        }
-#undef CORNER_EDGE_TO_HEX_CORNER
-    }
-
-    bool HexCoord2::operator==(const HexCoord2 &rhs) const { return q == rhs.q && r == rhs.r; }
-
-    HexCoord2 HexCoord2::operator+(const HexCoord2 &rhs) const { return {q + rhs.q, r + rhs.r}; }
-
-    HexCoord2 HexCoord2::get_neighbouring_hex_coord(HexEdgeDirection neighbour_direction) const {
-        switch (neighbour_direction) {
-            case HexEdgeDirection::TOP:
-                return {q, r - 1};
-            case HexEdgeDirection::TOP_RIGHT:
-                return {q + 1, r - 1};
-            case HexEdgeDirection::BOTTOM_RIGHT:
-                return {q + 1, r};
-            case HexEdgeDirection::BOTTOM:
-                return {q, r + 1};
-            case HexEdgeDirection::BOTTOM_LEFT:
-                return {q - 1, r + 1};
-            case HexEdgeDirection::TOP_LEFT:
-                return {q - 1, r};
-            default:
-                throw std::runtime_error("Unknown edge direction");
-        }
-    }
-
-    EdgeCoord HexCoord2::get_edge_coord(HexEdgeDirection edge_direction) const {
-        return EdgeCoord{*this, edge_direction};
-    }
-
-    CornerCoord HexCoord2::get_corner_coord(HexCornerDirection corner_direction) const {
-        return CornerCoord{*this, corner_direction};
-    }
-
-    bool EdgeCoord::operator==(const EdgeCoord &other) const {
-        return edge_direction == other.edge_direction && hex_coord == other.hex_coord;
-    }
-
-    bool CornerCoord::operator==(const CornerCoord &other) const {
-        return corner_direction == other.corner_direction && hex_coord == other.hex_coord;
-    }
-
-} // namespace Map
-
 std::string to_string(const Map::HexCoord2 &coord) {
     return "HexCoord2<q=" + std::to_string(coord.q) + ", " + "r = " + std::to_string(coord.r) + ">";
 }
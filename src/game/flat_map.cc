@@ -0,0 +1,44 @@
+#include "headers/flat_map.hh"
+#include <utility>
+
+namespace Map {
+    FlatMap::FlatMap(std::shared_ptr<const BoardTopology> topology, BoardState state)
+        : m_topology(std::move(topology)), m_state(std::move(state)) {
+    }
+
+    FlatMap FlatMap::from_map(const Map &map) {
+        FlatMap flat_map{map.get_shared_topology(), BoardState{map.get_topology()}};
+        for (HexId hex = 0; hex < flat_map.get_topology().get_hex_count(); hex++) {
+            const Hex *node = map.get_hex(hex);
+            flat_map.m_state.set_hex(hex, node->resource, node->number);
+            if (node->resource == Resource::NONE && flat_map.m_state.get_robber() == NO_NODE) {
+                flat_map.m_state.set_robber(hex);
+            }
+        }
+        for (CornerId corner = 0; corner < flat_map.get_topology().get_corner_count(); corner++) {
+            flat_map.m_state.set_house(corner, map.get_corner(corner)->house);
+        }
+        for (EdgeId edge = 0; edge < flat_map.get_topology().get_edge_count(); edge++) {
+            flat_map.m_state.set_road(edge, map.get_edge(edge)->road);
+        }
+        return flat_map;
+    }
+
+    FlatMap FlatMap::generate(const size_t radius, const std::uint64_t seed, const TileDistribution &distribution) {
+        auto topology = BoardTopology::shared(MapBounds::from_radius(radius));
+        BoardState state{*topology};
+        BoardGenerator generator{seed, distribution};
+        for (HexId hex = 0; hex < topology->get_hex_count(); hex++) {
+            const HexTile tile = generator.next_tile();
+            state.set_hex(hex, tile.resource, tile.number);
+            if (tile.resource == Resource::NONE && state.get_robber() == NO_NODE) {
+                state.set_robber(hex);
+            }
+        }
+        return FlatMap{std::move(topology), std::move(state)};
+    }
+
+    void FlatMap::set_house(const CornerId corner, const House &house) { m_state.set_house(corner, house); }
+
+    void FlatMap::set_road(const EdgeId edge, const Road &road) { m_state.set_road(edge, road); }
+} // namespace Map
@@ -3,6 +3,7 @@
 //
 
 #include "headers/game_sequence.hh"
+#include <stdexcept>
 
 
 namespace Game {
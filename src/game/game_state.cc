@@ -1,14 +1,52 @@
 
 #include "game_state.hh"
+#include "flat_map.hh"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace Game {
-    GameState::GameState(Map::Map map) : m_map(std::move(map)),
-                                         m_player_resources{
-                                             {Map::Resource::WHEAT, 20}, {Map::Resource::WOOD, 20},
-                                             {Map::Resource::BRICK, 20},
-                                             {Map::Resource::SHEEP, 20}, {Map::Resource::STONE, 20},
-                                         } {
+    GameState::GameState(Map::Map map, const size_t player_count, const std::uint32_t roll_seed)
+        : m_roll_manager(roll_seed),
+          m_player_resources(player_count, ResourceBundle{
+                                 {Map::Resource::WHEAT, 20}, {Map::Resource::WOOD, 20},
+                                 {Map::Resource::BRICK, 20},
+                                 {Map::Resource::SHEEP, 20}, {Map::Resource::STONE, 20},
+                             }),
+          m_affordable(player_count, 0),
+          m_map(std::move(map)),
+          m_pieces(m_map.get_shared_topology(), player_count),
+          m_legal_moves(m_pieces),
+          m_production(m_map.get_shared_topology(), Map::FlatMap::from_map(m_map).get_state()),
+          m_road_network(m_map.get_shared_topology(), player_count),
+          m_production_deltas(player_count),
+          m_no_corners(m_map.get_topology().get_bitboard_layout().make_corner_board()),
+          m_no_edges(m_map.get_topology().get_bitboard_layout().make_edge_board()) {
+        for (Map::CornerId corner = 0; corner < m_map.get_topology().get_corner_count(); corner++) {
+            m_pieces.set_house(corner, m_map.get_corner(corner)->house);
+            m_road_network.set_house(corner, m_map.get_corner(corner)->house);
+        }
+        for (Map::EdgeId edge = 0; edge < m_map.get_topology().get_edge_count(); edge++) {
+            m_pieces.set_road(edge, m_map.get_edge(edge)->road);
+            m_road_network.set_road(edge, m_map.get_edge(edge)->road);
+        }
+        m_legal_moves = LegalMoves{m_pieces};
+        // The robber starts on the first desert
+        for (Map::HexId hex = 0; hex < m_map.get_topology().get_hex_count(); hex++) {
+            if (m_map.get_hex(hex)->resource == Map::Resource::NONE) {
+                m_robber = hex;
+                break;
+            }
+        }
+        for (PlayerId player = 0; player < static_cast<PlayerId>(player_count); player++) {
+            update_affordable(player);
+        }
+        // The pieces the game starts with are never undone
+        m_road_network.clear_history();
         m_roll_manager.initialize_rolls();
+        m_hash = compute_hash();
     }
 
     auto GameState::can_trade(Map::Resource &resource_to_be_sold) const -> bool {
@@ -25,12 +63,344 @@ namespace Game {
 
     auto GameState::get_map() const -> const Map::Map & { return m_map; }
 
+    void GameState::update_affordable(const PlayerId player) {
+        m_affordable[player] = Game::get_affordable_recipes(m_player_resources[player]);
+    }
+
+    void GameState::add_resources(const PlayerId player, const Map::Resource resource, const int amount) {
+        add_resources(player, ResourceBundle{{resource, amount}});
+    }
+
+    void GameState::add_resources(const PlayerId player, const ResourceBundle &resources) {
+        m_undo_log.push_back({.kind = UndoEntry::Kind::RESOURCES, .player = player, .resources = resources});
+        write_resources(player, m_player_resources[player] + resources);
+    }
+
+    void GameState::write_resources(const PlayerId player, const ResourceBundle &resources) {
+        ResourceBundle &hand = m_player_resources[player];
+        for (const Map::Resource resource: Map::RESOURCES) {
+            if (hand[resource] != resources[resource]) {
+                m_hash ^= Zobrist::get_resource_key(player, resource, hand[resource]) ^
+                        Zobrist::get_resource_key(player, resource, resources[resource]);
+            }
+        }
+        hand = resources;
+        update_affordable(player);
+    }
+
+    void GameState::set_robber(const Map::HexId hex) {
+        m_undo_log.push_back({.kind = UndoEntry::Kind::ROBBER, .node = m_robber});
+        write_robber(hex);
+    }
+
+    void GameState::write_robber(const Map::HexId hex) {
+        if (m_robber != Map::NO_NODE) {
+            m_hash ^= Zobrist::get_robber_key(m_robber);
+        }
+        if (hex != Map::NO_NODE) {
+            m_hash ^= Zobrist::get_robber_key(hex);
+        }
+        m_robber = hex;
+    }
+
+    void GameState::set_turn(const PlayerId player, const GamePhase phase) {
+        m_undo_log.push_back({
+            .kind = UndoEntry::Kind::TURN, .player = m_current_player, .node = static_cast<std::uint32_t>(m_phase),
+        });
+        write_turn(player, phase);
+    }
+
+    void GameState::write_turn(const PlayerId player, const GamePhase phase) {
+        m_hash ^= Zobrist::get_turn_key(m_current_player, m_phase) ^ Zobrist::get_turn_key(player, phase);
+        m_current_player = player;
+        m_phase = phase;
+    }
+
+    void GameState::set_longest_road_holder(const PlayerId player) {
+        m_undo_log.push_back({.kind = UndoEntry::Kind::LONGEST_ROAD, .player = m_longest_road_holder});
+        write_longest_road_holder(player);
+    }
+
+    void GameState::write_longest_road_holder(const PlayerId player) {
+        m_hash ^= Zobrist::get_longest_road_key(m_longest_road_holder) ^ Zobrist::get_longest_road_key(player);
+        m_longest_road_holder = player;
+    }
+
+    auto GameState::compute_hash() const -> ZobristHash {
+        const auto &topology = m_map.get_topology();
+        ZobristHash hash = Zobrist::get_turn_key(m_current_player, m_phase) ^
+                           Zobrist::get_longest_road_key(m_longest_road_holder);
+        if (m_robber != Map::NO_NODE) {
+            hash ^= Zobrist::get_robber_key(m_robber);
+        }
+        for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+            hash ^= Zobrist::get_house_key(corner, m_map.get_corner(corner)->house);
+        }
+        for (Map::EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+            hash ^= Zobrist::get_road_key(edge, m_map.get_edge(edge)->road);
+        }
+        for (PlayerId player = 0; player < static_cast<PlayerId>(get_player_count()); player++) {
+            for (const Map::Resource resource: Map::RESOURCES) {
+                hash ^= Zobrist::get_resource_key(player, resource, m_player_resources[player][resource]);
+            }
+        }
+        return hash;
+    }
+
+    void GameState::produce(const int roll) {
+        std::ranges::fill(m_production_deltas, ResourceBundle{});
+        m_production.produce(roll, m_robber, m_production_deltas);
+        for (PlayerId player = 0; player < static_cast<PlayerId>(get_player_count()); player++) {
+            if (!m_production_deltas[player].is_empty()) {
+                add_resources(player, m_production_deltas[player]);
+            }
+        }
+    }
+
+    auto GameState::roll_dice() -> int { return draw_roll(0); }
+
+    auto GameState::roll_dice(const int value) -> int {
+        const auto position = m_roll_manager.find(value);
+        if (!position) {
+            throw std::invalid_argument("No roll of " + std::to_string(value) + " is left in the deck");
+        }
+        return draw_roll(*position);
+    }
+
+    auto GameState::draw_roll(const size_t position) -> int {
+        if (m_roll_manager.will_reshuffle()) {
+            m_saved_roll_decks.push_back(m_roll_manager);
+            m_undo_log.push_back({.kind = UndoEntry::Kind::RESHUFFLE});
+        } else {
+            m_undo_log.push_back({.kind = UndoEntry::Kind::ROLL, .node = static_cast<std::uint32_t>(position)});
+        }
+        const int roll = m_roll_manager.draw(position).get_roll();
+        produce(roll);
+        return roll;
+    }
+
+    void GameState::set_roll_manager(const RollManager &deck) {
+        m_saved_roll_decks.push_back(m_roll_manager);
+        m_undo_log.push_back({.kind = UndoEntry::Kind::RESHUFFLE});
+        m_roll_manager = deck;
+    }
+
+    auto GameState::clone() const -> GameState {
+        GameState copy{m_map.clone(), get_player_count(), 0};
+        copy.m_roll_manager = m_roll_manager;
+        copy.m_player_resources = m_player_resources;
+        copy.m_affordable = m_affordable;
+        copy.m_robber = m_robber;
+        copy.m_last_built_corner = m_last_built_corner;
+        copy.m_current_player = m_current_player;
+        copy.m_phase = m_phase;
+        copy.m_longest_road_holder = m_longest_road_holder;
+        copy.m_hash = m_hash;
+        return copy;
+    }
+
+    auto GameState::get_building_points(const PlayerId player) const -> std::uint32_t {
+        return static_cast<std::uint32_t>(m_pieces.get_settlements(player).count() +
+                                          2 * m_pieces.get_cities(player).count());
+    }
+
+    void GameState::place_house(const Map::CornerId corner, const House &house) {
+        m_undo_log.push_back({
+            .kind = UndoEntry::Kind::HOUSE, .house = m_map.get_corner(corner)->house, .node = corner,
+            .last_built_corner = m_last_built_corner, .road_network_mark = m_road_network.get_history_mark(),
+        });
+        write_house(corner, house);
+        if (house.is_built()) {
+            m_last_built_corner = corner;
+        }
+    }
+
+    void GameState::write_house(const Map::CornerId corner, const House &house) {
+        House &previous = m_map.get_corner(corner)->house;
+        m_hash ^= Zobrist::get_house_key(corner, previous) ^ Zobrist::get_house_key(corner, house);
+        previous = house;
+        m_pieces.set_house(corner, house);
+        m_production.set_house(corner, house);
+        m_road_network.set_house(corner, house);
+        m_legal_moves.update_around_corner(m_pieces, corner);
+    }
+
+    void GameState::place_road(const Map::EdgeId edge, const Road &road) {
+        m_undo_log.push_back({
+            .kind = UndoEntry::Kind::ROAD, .road = m_map.get_edge(edge)->road, .node = edge,
+            .road_network_mark = m_road_network.get_history_mark(),
+        });
+        write_road(edge, road);
+    }
+
+    void GameState::write_road(const Map::EdgeId edge, const Road &road) {
+        Road &previous = m_map.get_edge(edge)->road;
+        m_hash ^= Zobrist::get_road_key(edge, previous) ^ Zobrist::get_road_key(edge, road);
+        previous = road;
+        m_pieces.set_road(edge, road);
+        m_road_network.set_road(edge, road);
+        m_legal_moves.update_around_edge(m_pieces, edge);
+    }
+
+    auto GameState::get_setup_roads() const -> Map::EdgeBoard {
+        if (m_last_built_corner == Map::NO_NODE) {
+            return m_no_edges;
+        }
+        return m_pieces.get_legal_roads_from(m_last_built_corner);
+    }
+
+    auto GameState::check_legal_moves() const -> std::optional<std::string> {
+        return m_legal_moves.find_inconsistency(m_pieces);
+    }
+
+    void GameState::undo(const UndoMark mark) {
+        while (m_undo_log.size() > mark) {
+            const UndoEntry entry = m_undo_log.back();
+            m_undo_log.pop_back();
+            switch (entry.kind) {
+                // The networks are rolled back first, so they already hold the piece put back and skip the
+                // rebuild that removing a road or a house could cost
+                case UndoEntry::Kind::HOUSE:
+                    m_road_network.rollback(entry.road_network_mark);
+                    write_house(entry.node, entry.house);
+                    m_last_built_corner = entry.last_built_corner;
+                    break;
+                case UndoEntry::Kind::ROAD:
+                    m_road_network.rollback(entry.road_network_mark);
+                    write_road(entry.node, entry.road);
+                    break;
+                case UndoEntry::Kind::RESOURCES:
+                    write_resources(entry.player, m_player_resources[entry.player] - entry.resources);
+                    break;
+                case UndoEntry::Kind::ROBBER:
+                    write_robber(entry.node);
+                    break;
+                case UndoEntry::Kind::ROLL:
+                    m_roll_manager.undraw(entry.node);
+                    break;
+                case UndoEntry::Kind::RESHUFFLE:
+                    m_roll_manager = std::move(m_saved_roll_decks.back());
+                    m_saved_roll_decks.pop_back();
+                    break;
+                case UndoEntry::Kind::TURN:
+                    write_turn(entry.player, static_cast<GamePhase>(entry.node));
+                    break;
+                case UndoEntry::Kind::LONGEST_ROAD:
+                    write_longest_road_holder(entry.player);
+                    break;
+            }
+        }
+    }
+
+    void GameState::clear_undo_log() {
+        m_undo_log.clear();
+        m_saved_roll_decks.clear();
+        m_road_network.clear_history();
+    }
+
+    void GameState::snapshot(GameStateSnapshot &snapshot) const {
+        const auto nodes = m_map.get_node_bytes();
+        snapshot.m_node_memory = nodes.data();
+        snapshot.m_map_nodes.assign(nodes.begin(), nodes.end());
+        snapshot.m_player_resources = m_player_resources;
+        snapshot.m_affordable = m_affordable;
+        // Assigning into an engaged optional copies into the buffers already there
+        snapshot.m_pieces ? void(*snapshot.m_pieces = m_pieces) : void(snapshot.m_pieces.emplace(m_pieces));
+        snapshot.m_legal_moves ? void(*snapshot.m_legal_moves = m_legal_moves)
+                               : void(snapshot.m_legal_moves.emplace(m_legal_moves));
+        snapshot.m_production ? void(*snapshot.m_production = m_production)
+                              : void(snapshot.m_production.emplace(m_production));
+        snapshot.m_road_network ? void(*snapshot.m_road_network = m_road_network)
+                                : void(snapshot.m_road_network.emplace(m_road_network));
+        snapshot.m_roll_manager = m_roll_manager;
+        snapshot.m_robber = m_robber;
+        snapshot.m_last_built_corner = m_last_built_corner;
+        snapshot.m_current_player = m_current_player;
+        snapshot.m_phase = m_phase;
+        snapshot.m_longest_road_holder = m_longest_road_holder;
+        snapshot.m_hash = m_hash;
+    }
+
+    auto GameState::snapshot() const -> GameStateSnapshot {
+        GameStateSnapshot snapshot;
+        this->snapshot(snapshot);
+        return snapshot;
+    }
+
+    void GameState::restore(const GameStateSnapshot &snapshot) {
+        const auto nodes = m_map.get_node_bytes();
+        if (snapshot.m_node_memory != nodes.data() || snapshot.m_map_nodes.size() != nodes.size()) {
+            throw std::invalid_argument("The snapshot was taken from another game");
+        }
+        std::memcpy(nodes.data(), snapshot.m_map_nodes.data(), nodes.size());
+        m_player_resources = snapshot.m_player_resources;
+        m_affordable = snapshot.m_affordable;
+        m_pieces = *snapshot.m_pieces;
+        m_legal_moves = *snapshot.m_legal_moves;
+        m_production = *snapshot.m_production;
+        m_road_network = *snapshot.m_road_network;
+        m_roll_manager = snapshot.m_roll_manager;
+        m_robber = snapshot.m_robber;
+        m_last_built_corner = snapshot.m_last_built_corner;
+        m_current_player = snapshot.m_current_player;
+        m_phase = snapshot.m_phase;
+        m_longest_road_holder = snapshot.m_longest_road_holder;
+        m_hash = snapshot.m_hash;
+        clear_undo_log();
+    }
+
     auto get_game_state() -> GameState & {
         static GameState game_state(Map::Map::build_map_of_size(2));
         return game_state;
     }
 
 
+    RollManager::RollManager(const std::uint32_t seed) : random_engine(seed) {
+    }
+
     void RollManager::initialize_rolls() {
-    };
+        size_t roll = 0;
+        for (int first = 1; first <= 6; first++) {
+            for (int second = 1; second <= 6; second++) {
+                rolls[roll++] = static_cast<std::int8_t>(first + second);
+            }
+        }
+        std::ranges::shuffle(rolls, random_engine);
+        drawn = 0;
+    }
+
+    auto RollManager::draw() -> Roll { return draw(0); }
+
+    auto RollManager::draw(const size_t position) -> Roll {
+        // Bring the roll to the top, keeping the order of the ones above it
+        const auto next = rolls.begin() + drawn;
+        const auto offset = static_cast<std::ptrdiff_t>(position);
+        std::rotate(next, next + offset, next + offset + 1);
+        const Roll roll{rolls[drawn++]};
+        if (get_queue_size() < RESHUFFLE_BELOW) {
+            // Shuffle the discard pile and move it behind the rolls left
+            std::shuffle(rolls.begin(), next + 1, random_engine);
+            std::rotate(rolls.begin(), next + 1, rolls.end());
+            drawn = 0;
+        }
+        return roll;
+    }
+
+    void RollManager::undraw(const size_t position) {
+        drawn--;
+        const auto next = rolls.begin() + drawn;
+        std::rotate(next, next + 1, next + static_cast<std::ptrdiff_t>(position) + 1);
+    }
+
+    auto RollManager::find(const int value) const -> std::optional<size_t> {
+        const auto roll = std::find(rolls.begin() + drawn, rolls.end(), value);
+        if (roll == rolls.end()) {
+            return std::nullopt;
+        }
+        return static_cast<size_t>(roll - (rolls.begin() + drawn));
+    }
+
+    auto RollManager::count(const int value) const -> size_t {
+        return static_cast<size_t>(std::count(rolls.begin() + drawn, rolls.end(), value));
+    }
 } // namespace Game
@@ -0,0 +1,78 @@
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "game_state.hh"
+#include "map.hh"
+
+namespace Game {
+    // Where an Autosaver sends each encoded save. Called on the autosave thread, one save at a time.
+    using SaveWriter = std::function<void(std::span<const std::byte>)>;
+
+    // Saves a game in the background. The caller of save() only pays for a snapshot of the state into a buffer
+    // reused from an earlier save: flat copies, no allocation. Encoding the save and writing it to disk happen on
+    // a thread the autosaver owns.
+    //
+    // The queue is bounded: at most `queue_depth` snapshots exist, the one being written and those waiting. When
+    // none is free, a new save takes the place of the newest one waiting, which it supersedes. A slow disk makes
+    // the autosave skip states instead of stalling the game or building up a backlog.
+    class Autosaver {
+        // Only the tiles are read from it, which stay the same for the whole game
+        Map::Map m_board;
+        SaveWriter m_writer;
+        std::vector<GameStateSnapshot> m_slots;
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_changed;
+        // Indexes of the slots free to take, and of those waiting to be written, oldest first
+        std::vector<size_t> m_free;
+        std::vector<size_t> m_pending;
+        bool m_writing = false;
+        std::uint64_t m_written = 0;
+        std::uint64_t m_superseded = 0;
+        std::exception_ptr m_error;
+
+        // Last, so the thread is stopped and joined before anything it uses is destroyed
+        std::jthread m_thread;
+
+        void run(const std::stop_token &stop);
+
+    public:
+        // Autosaves `state` to `path` with write_save_file.
+        Autosaver(const GameState &state, const std::filesystem::path &path, size_t queue_depth = 2);
+
+        // Autosaves `state` through `writer`. Throws std::invalid_argument for a queue depth of 0.
+        Autosaver(const GameState &state, SaveWriter writer, size_t queue_depth = 2);
+
+        Autosaver(const Autosaver &) = delete;
+
+        auto operator=(const Autosaver &) -> Autosaver & = delete;
+
+        // Writes the saves still waiting, then stops the thread.
+        ~Autosaver() = default;
+
+        // Snapshots `state`, which must be the game the autosaver was made for, and queues it to be written.
+        // Returns false when the save was dropped because every slot is being written, which only happens with a
+        // queue depth of 1.
+        auto save(const GameState &state) -> bool;
+
+        // Blocks until every save queued so far is written. Rethrows the first error the writer threw since the
+        // last call.
+        void wait();
+
+        [[nodiscard]] auto get_written_count() -> std::uint64_t;
+
+        // Saves replaced by a newer one before they were written.
+        [[nodiscard]] auto get_superseded_count() -> std::uint64_t;
+    };
+} // namespace Game
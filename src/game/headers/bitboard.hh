@@ -0,0 +1,220 @@
+
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "coords.hh"
+
+namespace Map {
+    // Fixed length bit set over 64-bit words. Every whole-board operation is a plain loop over the words, so it
+    // vectorizes on large boards and is one or two instructions on the standard one. Sets of up to
+    // INLINE_WORDS words live inline, so the temporaries of a board-wide query on a small board never allocate.
+    class Bitboard {
+    public:
+        static constexpr size_t INLINE_WORDS = 2;
+
+    private:
+        size_t m_bit_count = 0;
+        size_t m_word_count = 0;
+        std::array<std::uint64_t, INLINE_WORDS> m_inline{};
+        std::unique_ptr<std::uint64_t[]> m_heap;
+
+        [[nodiscard]] auto words() -> std::uint64_t * { return m_heap ? m_heap.get() : m_inline.data(); }
+
+        [[nodiscard]] auto words() const -> const std::uint64_t * { return m_heap ? m_heap.get() : m_inline.data(); }
+
+        void clear_tail();
+
+    public:
+        Bitboard() = default;
+
+        explicit Bitboard(size_t bit_count);
+
+        Bitboard(const Bitboard &other);
+
+        Bitboard(Bitboard &&other) noexcept;
+
+        auto operator=(const Bitboard &other) -> Bitboard &;
+
+        auto operator=(Bitboard &&other) noexcept -> Bitboard &;
+
+        ~Bitboard() = default;
+
+        [[nodiscard]] auto get_bit_count() const -> size_t { return m_bit_count; }
+
+        [[nodiscard]] auto get_words() const -> std::span<const std::uint64_t> { return {words(), m_word_count}; }
+
+        [[nodiscard]] auto test(const size_t bit) const -> bool { return (words()[bit / 64] >> (bit % 64) & 1) != 0; }
+
+        void set(const size_t bit) { words()[bit / 64] |= std::uint64_t{1} << (bit % 64); }
+
+        void reset(const size_t bit) { words()[bit / 64] &= ~(std::uint64_t{1} << (bit % 64)); }
+
+        [[nodiscard]] auto count() const -> size_t;
+
+        [[nodiscard]] auto any() const -> bool;
+
+        // Bit i of the result is bit i + offset of this board, zero where that is out of range.
+        [[nodiscard]] auto gathered(std::ptrdiff_t offset) const -> Bitboard;
+
+        auto operator|=(const Bitboard &other) -> Bitboard &;
+
+        auto operator&=(const Bitboard &other) -> Bitboard &;
+
+        // this &= ~other
+        auto and_not(const Bitboard &other) -> Bitboard &;
+
+        auto operator==(const Bitboard &other) const -> bool;
+
+        template<typename Func>
+        void for_each_set_bit(Func &&func) const {
+            const std::uint64_t *data = words();
+            for (size_t word = 0; word < m_word_count; word++) {
+                for (std::uint64_t bits = data[word]; bits != 0; bits &= bits - 1) {
+                    func(word * 64 + static_cast<size_t>(std::countr_zero(bits)));
+                }
+            }
+        }
+    };
+
+    // A set of corners or edges as one bit plane per canonical direction (see coord_keys.hh): corners use the
+    // RIGHT and BOTTOM_RIGHT planes, edges the BOTTOM_RIGHT, BOTTOM and BOTTOM_LEFT planes. Within a plane the
+    // bit of a node depends only on the axial coordinate of its canonical hex, so moving to a neighbouring node
+    // is a plane change plus a constant shift.
+    template<size_t plane_count>
+    struct NodeBoard {
+        std::array<Bitboard, plane_count> planes;
+
+        auto operator|=(const NodeBoard &other) -> NodeBoard & {
+            for (size_t plane = 0; plane < plane_count; plane++) {
+                planes[plane] |= other.planes[plane];
+            }
+            return *this;
+        }
+
+        auto operator&=(const NodeBoard &other) -> NodeBoard & {
+            for (size_t plane = 0; plane < plane_count; plane++) {
+                planes[plane] &= other.planes[plane];
+            }
+            return *this;
+        }
+
+        auto and_not(const NodeBoard &other) -> NodeBoard & {
+            for (size_t plane = 0; plane < plane_count; plane++) {
+                planes[plane].and_not(other.planes[plane]);
+            }
+            return *this;
+        }
+
+        [[nodiscard]] auto count() const -> size_t {
+            size_t total = 0;
+            for (const auto &plane: planes) {
+                total += plane.count();
+            }
+            return total;
+        }
+
+        [[nodiscard]] auto any() const -> bool {
+            for (const auto &plane: planes) {
+                if (plane.any()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        auto operator==(const NodeBoard &other) const -> bool = default;
+    };
+
+    using CornerBoard = NodeBoard<2>;
+    using EdgeBoard = NodeBoard<3>;
+
+    // Where each corner and edge of a board sits in a CornerBoard or EdgeBoard, and the masks of the nodes that
+    // are on the board.
+    //
+    // Every plane is a row major lattice over the canonical hexes, which reach one ring past the board. Rows get
+    // one spare column, so shifting a row by one hex either way lands in a column that is always empty instead
+    // of wrapping onto a node of the next row. The standard board needs 8 x 7 bits per plane: a single word.
+    class BitboardLayout {
+        std::ptrdiff_t m_reach = 0;
+        std::ptrdiff_t m_width = 0;
+        size_t m_plane_bits = 0;
+
+        // id -> plane * plane_bits + bit
+        std::vector<std::uint32_t> m_corner_slots;
+        std::vector<std::uint32_t> m_edge_slots;
+        // plane * plane_bits + bit -> id, UINT32_MAX for the slots off the board
+        std::vector<std::uint32_t> m_corner_ids;
+        std::vector<std::uint32_t> m_edge_ids;
+
+        CornerBoard m_corners;
+        EdgeBoard m_edges;
+
+        [[nodiscard]] auto get_bit(const HexCoord2 &coord) const -> size_t;
+
+        [[nodiscard]] auto gathered(const Bitboard &plane, int dq, int dr) const -> Bitboard;
+
+    public:
+        BitboardLayout() = default;
+
+        // `canonical_corners` and `canonical_edges` list the canonical coordinates of the nodes by id.
+        BitboardLayout(size_t radius, std::span<const CornerCoord> canonical_corners,
+                       std::span<const EdgeCoord> canonical_edges);
+
+        [[nodiscard]] auto get_plane_bits() const -> size_t { return m_plane_bits; }
+
+        [[nodiscard]] auto make_corner_board() const -> CornerBoard;
+
+        [[nodiscard]] auto make_edge_board() const -> EdgeBoard;
+
+        // Every corner of the board.
+        [[nodiscard]] auto get_corners() const -> const CornerBoard & { return m_corners; }
+
+        // Every edge of the board.
+        [[nodiscard]] auto get_edges() const -> const EdgeBoard & { return m_edges; }
+
+        void insert(CornerBoard &board, std::uint32_t corner) const;
+
+        void insert(EdgeBoard &board, std::uint32_t edge) const;
+
+        void erase(CornerBoard &board, std::uint32_t corner) const;
+
+        void erase(EdgeBoard &board, std::uint32_t edge) const;
+
+        [[nodiscard]] auto contains(const CornerBoard &board, std::uint32_t corner) const -> bool;
+
+        [[nodiscard]] auto contains(const EdgeBoard &board, std::uint32_t edge) const -> bool;
+
+        // Corners sharing an edge with a corner of `corners`.
+        [[nodiscard]] auto get_neighbouring_corners(const CornerBoard &corners) const -> CornerBoard;
+
+        // Corners at either end of an edge of `edges`.
+        [[nodiscard]] auto get_edge_ends(const EdgeBoard &edges) const -> CornerBoard;
+
+        // Edges with an end in `corners`.
+        [[nodiscard]] auto get_corner_edges(const CornerBoard &corners) const -> EdgeBoard;
+
+        template<typename Func>
+        void for_each_corner(const CornerBoard &board, Func &&func) const {
+            for (size_t plane = 0; plane < board.planes.size(); plane++) {
+                board.planes[plane].for_each_set_bit([&](const size_t bit) {
+                    func(m_corner_ids[plane * m_plane_bits + bit]);
+                });
+            }
+        }
+
+        template<typename Func>
+        void for_each_edge(const EdgeBoard &board, Func &&func) const {
+            for (size_t plane = 0; plane < board.planes.size(); plane++) {
+                board.planes[plane].for_each_set_bit([&](const size_t bit) {
+                    func(m_edge_ids[plane * m_plane_bits + bit]);
+                });
+            }
+        }
+    };
+} // namespace Map
@@ -0,0 +1,80 @@
+
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "bitboard.hh"
+#include "board_state.hh"
+#include "board_topology.hh"
+#include "game.hh"
+
+namespace Map {
+    // The pieces on a board as one corner and edge bitboard per player, so the placement rules are evaluated for
+    // the whole board at once with a few plane-wide AND/OR/shift passes instead of a walk per node. Mirrors the
+    // houses and roads of a BoardState; the caller keeps the two in step through set_house and set_road.
+    class BoardBitboards {
+        struct PlayerPieces {
+            CornerBoard settlements;
+            CornerBoard cities;
+            EdgeBoard roads;
+        };
+
+        std::shared_ptr<const BoardTopology> m_topology;
+        std::vector<PlayerPieces> m_players;
+        CornerBoard m_houses;
+        EdgeBoard m_roads;
+
+        [[nodiscard]] auto get_layout() const -> const BitboardLayout & { return m_topology->get_bitboard_layout(); }
+
+    public:
+        BoardBitboards(std::shared_ptr<const BoardTopology> topology, size_t player_count);
+
+        static BoardBitboards from_state(std::shared_ptr<const BoardTopology> topology, const BoardState &state,
+                                         size_t player_count);
+
+        [[nodiscard]] auto get_topology() const -> const BoardTopology & { return *m_topology; }
+
+        [[nodiscard]] auto get_player_count() const -> size_t { return m_players.size(); }
+
+        // Replaces whatever house stood on `corner`; an empty house clears it.
+        void set_house(CornerId corner, const House &house);
+
+        // Replaces whatever road lay on `edge`; an empty road clears it.
+        void set_road(EdgeId edge, const Road &road);
+
+        [[nodiscard]] auto get_houses() const -> const CornerBoard & { return m_houses; }
+
+        [[nodiscard]] auto get_roads() const -> const EdgeBoard & { return m_roads; }
+
+        [[nodiscard]] auto get_settlements(const PlayerId player) const -> const CornerBoard & {
+            return m_players[player].settlements;
+        }
+
+        [[nodiscard]] auto get_cities(const PlayerId player) const -> const CornerBoard & {
+            return m_players[player].cities;
+        }
+
+        [[nodiscard]] auto get_roads(const PlayerId player) const -> const EdgeBoard & {
+            return m_players[player].roads;
+        }
+
+        // Empty corners with no house on a neighbouring corner, where a settlement may go during setup.
+        [[nodiscard]] auto get_free_corners() const -> CornerBoard;
+
+        // Free corners at the end of one of the player's roads.
+        [[nodiscard]] auto get_legal_settlements(PlayerId player) const -> CornerBoard;
+
+        // Empty edges touching one of the player's houses, or one of the player's roads at a corner without an
+        // opponent's house.
+        [[nodiscard]] auto get_legal_roads(PlayerId player) const -> EdgeBoard;
+
+        // Empty edges at `corner`, where the setup road next to a freshly placed settlement may go.
+        [[nodiscard]] auto get_legal_roads_from(CornerId corner) const -> EdgeBoard;
+
+        // Settlements of the player, which may become cities.
+        [[nodiscard]] auto get_legal_upgrades(const PlayerId player) const -> const CornerBoard & {
+            return get_settlements(player);
+        }
+    };
+} // namespace Map
@@ -0,0 +1,54 @@
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "map.hh"
+
+namespace Map {
+    struct HexTile {
+        Resource resource;
+        int number;
+    };
+
+    // The tile set of one standard sized board. Larger boards are dealt from as many shuffled copies of the set
+    // as they need, so every run of `get_deck_size()` hexes keeps the proportions of the set.
+    struct TileDistribution {
+        // Producing tiles of one deck; `numbers[i]` is not tied to `resources[i]`, both are shuffled on their own.
+        std::vector<Resource> resources;
+        std::vector<int> numbers;
+        // Tiles without resource, they get the 7 token.
+        size_t desert_count = 1;
+
+        // 4 wheat, wood and sheep, 3 brick and stone, one desert and the 18 standard number tokens.
+        static TileDistribution standard();
+
+        [[nodiscard]] auto get_deck_size() const -> size_t { return resources.size() + desert_count; }
+    };
+
+    // Deals hex tiles from a seeded RNG. The same seed and distribution always deal the same tiles, on every
+    // platform: only the engine is taken from <random>, the shuffles are implemented here. Memory use is one deck,
+    // independent of the board size.
+    class BoardGenerator {
+        std::mt19937_64 m_rng;
+        TileDistribution m_distribution;
+        std::vector<HexTile> m_deck;
+        size_t m_next_tile;
+
+        void deal_deck();
+
+        auto draw_below(std::uint64_t bound) -> std::uint64_t;
+
+        template<typename T>
+        void shuffle(std::vector<T> &values);
+
+    public:
+        // Throws std::invalid_argument if the distribution has no tiles or if the number of tokens does not match
+        // the number of producing tiles.
+        BoardGenerator(std::uint64_t seed, TileDistribution distribution);
+
+        auto next_tile() -> HexTile;
+    };
+} // namespace Map
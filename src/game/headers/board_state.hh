@@ -0,0 +1,48 @@
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "board_topology.hh"
+#include "game.hh"
+#include "map.hh"
+
+namespace Map {
+    // Everything about a board that changes from one game to the next: the dealt tiles, the pieces and the
+    // robber. The graph itself lives in the shared BoardTopology, so a standard board costs a few hundred bytes.
+    class BoardState {
+        std::vector<Resource> m_hex_resources;
+        std::vector<std::int8_t> m_hex_numbers;
+        std::vector<House> m_corner_houses;
+        std::vector<Road> m_edge_roads;
+        HexId m_robber = NO_NODE;
+
+    public:
+        BoardState() = default;
+
+        // Empty board: no tiles dealt, no pieces, no robber.
+        explicit BoardState(const BoardTopology &topology);
+
+        [[nodiscard]] auto get_hex_resource(const HexId hex) const -> Resource { return m_hex_resources[hex]; }
+
+        [[nodiscard]] auto get_hex_number(const HexId hex) const -> int { return m_hex_numbers[hex]; }
+
+        [[nodiscard]] auto get_house(const CornerId corner) const -> const House & { return m_corner_houses[corner]; }
+
+        [[nodiscard]] auto get_road(const EdgeId edge) const -> const Road & { return m_edge_roads[edge]; }
+
+        [[nodiscard]] auto get_robber() const -> HexId { return m_robber; }
+
+        void set_hex(HexId hex, Resource resource, int number);
+
+        void set_house(CornerId corner, const House &house);
+
+        void set_road(EdgeId edge, const Road &road);
+
+        void set_robber(HexId hex);
+
+        // Bytes owned by this state, inline and on the heap.
+        [[nodiscard]] auto get_memory_usage() const -> size_t;
+    };
+} // namespace Map
@@ -0,0 +1,140 @@
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "bitboard.hh"
+#include "coord_keys.hh"
+#include "coords.hh"
+#include "map_bounds.hh"
+
+namespace Map {
+    using HexId = std::uint32_t;
+    using CornerId = std::uint32_t;
+    using EdgeId = std::uint32_t;
+
+    // Id of a node that is not on the board.
+    constexpr std::uint32_t NO_NODE = UINT32_MAX;
+
+    // Compressed sparse row adjacency: the neighbours of node i are
+    // indices[offsets[i], offsets[i + 1]), stored back to back for all nodes.
+    class AdjacencyTable {
+        std::vector<std::uint32_t> m_offsets{0};
+        std::vector<std::uint32_t> m_indices;
+
+    public:
+        AdjacencyTable() = default;
+
+        // Builds the table from (node, neighbour) pairs. Neighbours keep the order in which they were given.
+        static AdjacencyTable from_pairs(size_t node_count,
+                                         const std::vector<std::pair<std::uint32_t, std::uint32_t> > &pairs);
+
+        void append_row(std::span<const std::uint32_t> row);
+
+        [[nodiscard]] auto get_row(const std::uint32_t node) const -> std::span<const std::uint32_t> {
+            return {m_indices.data() + m_offsets[node], m_indices.data() + m_offsets[node + 1]};
+        }
+
+        [[nodiscard]] auto get_node_count() const -> size_t;
+    };
+
+    // Index based view of the board graph. Every hex, corner and edge gets a dense id in [0, count), so node data
+    // can be stored in flat arrays indexed by id and every neighbour walk is a contiguous read.
+    class BoardTopology {
+        MapBounds m_bounds;
+
+        std::vector<HexCoord2> m_hex_coords;
+        std::vector<CornerCoord> m_corner_coords;
+        std::vector<EdgeCoord> m_edge_coords;
+
+        // Coordinate -> id lookup over the axial square reaching one ring past the board: one slot per hex, two per
+        // hex for the canonical corners and three for the canonical edges (see coord_keys.hh). Building and lookup
+        // are plain array accesses, so the build stays linear on large boards.
+        std::vector<HexId> m_hex_ids;
+        std::vector<CornerId> m_corner_ids;
+        std::vector<EdgeId> m_edge_ids;
+
+        AdjacencyTable m_hex_corners;
+        AdjacencyTable m_hex_edges;
+        AdjacencyTable m_corner_edges;
+        AdjacencyTable m_corner_hexes;
+        AdjacencyTable m_edge_corners;
+
+        BitboardLayout m_bitboard_layout;
+
+        explicit BoardTopology(const MapBounds &bounds);
+
+        // Slot of `coord` in the lookup square, std::nullopt if the hex is outside of it.
+        [[nodiscard]] auto get_lattice_index(const HexCoord2 &coord) const -> std::optional<size_t>;
+
+        [[nodiscard]] auto get_corner_slot(const CornerCoord &canonical_coord) const -> std::optional<size_t>;
+
+        [[nodiscard]] auto get_edge_slot(const EdgeCoord &canonical_coord) const -> std::optional<size_t>;
+
+    public:
+        static BoardTopology build(const MapBounds &bounds);
+
+        // Topology of `bounds`, built on first use and shared by every caller while any of them holds it.
+        // Thread safe.
+        static std::shared_ptr<const BoardTopology> shared(const MapBounds &bounds);
+
+        [[nodiscard]] auto get_bounds() const -> const MapBounds &;
+
+        [[nodiscard]] auto get_hex_count() const -> size_t { return m_hex_coords.size(); }
+
+        [[nodiscard]] auto get_corner_count() const -> size_t { return m_corner_coords.size(); }
+
+        [[nodiscard]] auto get_edge_count() const -> size_t { return m_edge_coords.size(); }
+
+        [[nodiscard]] auto get_hex_coord(HexId hex) const -> const HexCoord2 &;
+
+        [[nodiscard]] auto get_corner_coord(CornerId corner) const -> const CornerCoord &;
+
+        [[nodiscard]] auto get_edge_coord(EdgeId edge) const -> const EdgeCoord &;
+
+        [[nodiscard]] auto get_corner_key(CornerId corner) const -> CornerKey;
+
+        [[nodiscard]] auto get_edge_key(EdgeId edge) const -> EdgeKey;
+
+        [[nodiscard]] auto find_hex(const HexCoord2 &coord) const -> std::optional<HexId>;
+
+        // Accepts any of the coordinates naming the corner, not only the canonical one.
+        [[nodiscard]] auto find_corner(const CornerCoord &coord) const -> std::optional<CornerId>;
+
+        // Accepts any of the coordinates naming the edge, not only the canonical one.
+        [[nodiscard]] auto find_edge(const EdgeCoord &coord) const -> std::optional<EdgeId>;
+
+        [[nodiscard]] auto find_corner(CornerKey key) const -> std::optional<CornerId>;
+
+        [[nodiscard]] auto find_edge(EdgeKey key) const -> std::optional<EdgeId>;
+
+        // Corners of a hex, in HEX_CORNER_DIRECTIONS order.
+        [[nodiscard]] auto get_hex_corners(const HexId hex) const -> std::span<const CornerId> {
+            return m_hex_corners.get_row(hex);
+        }
+
+        // Edges of a hex, in HEX_EDGE_DIRECTIONS order.
+        [[nodiscard]] auto get_hex_edges(const HexId hex) const -> std::span<const EdgeId> {
+            return m_hex_edges.get_row(hex);
+        }
+
+        [[nodiscard]] auto get_corner_edges(const CornerId corner) const -> std::span<const EdgeId> {
+            return m_corner_edges.get_row(corner);
+        }
+
+        [[nodiscard]] auto get_corner_hexes(const CornerId corner) const -> std::span<const HexId> {
+            return m_corner_hexes.get_row(corner);
+        }
+
+        [[nodiscard]] auto get_edge_corners(const EdgeId edge) const -> std::span<const CornerId> {
+            return m_edge_corners.get_row(edge);
+        }
+
+        // Bit positions of the corners and edges in a CornerBoard or EdgeBoard of this board.
+        [[nodiscard]] auto get_bitboard_layout() const -> const BitboardLayout & { return m_bitboard_layout; }
+    };
+} // namespace Map
@@ -0,0 +1,104 @@
+
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "coords.hh"
+
+namespace Map {
+    // Single integer names for lattice coordinates.
+    //
+    // Every corner is the RIGHT or BOTTOM_RIGHT corner of exactly one hex, and every edge the BOTTOM_RIGHT,
+    // BOTTOM or BOTTOM_LEFT edge of exactly one hex, whether or not that hex is on the board. Renaming a
+    // coordinate to that canonical form is a table lookup, and the canonical form packs into 32 bits:
+    //
+    //   hex key    [q + bias : 15][r + bias : 15]
+    //   corner key [hex key : 30][corner : 1]       0 = RIGHT, 1 = BOTTOM_RIGHT
+    //   edge key   [hex key : 30][edge : 2]         0 = BOTTOM_RIGHT, 1 = BOTTOM, 2 = BOTTOM_LEFT
+    //
+    // Two coordinates name the same node exactly when their keys are equal.
+    using HexKey = std::uint32_t;
+    using CornerKey = std::uint32_t;
+    using EdgeKey = std::uint32_t;
+
+    constexpr int COORD_KEY_BITS = 15;
+    // Axial components must lie in [-COORD_KEY_BIAS, COORD_KEY_BIAS).
+    constexpr int COORD_KEY_BIAS = 1 << (COORD_KEY_BITS - 1);
+
+    namespace detail {
+        struct CanonicalCorner {
+            HexCoord2 hex_offset;
+            HexCornerDirection corner_direction;
+        };
+
+        struct CanonicalEdge {
+            HexCoord2 hex_offset;
+            HexEdgeDirection edge_direction;
+        };
+
+        // Indexed by HexCornerDirection
+        inline constexpr std::array<CanonicalCorner, 6> CANONICAL_CORNERS{{
+            {{0, 0}, HexCornerDirection::RIGHT},
+            {{0, 0}, HexCornerDirection::BOTTOM_RIGHT},
+            {{-1, 1}, HexCornerDirection::RIGHT},
+            {{-1, 0}, HexCornerDirection::BOTTOM_RIGHT},
+            {{-1, 0}, HexCornerDirection::RIGHT},
+            {{0, -1}, HexCornerDirection::BOTTOM_RIGHT},
+        }};
+
+        // Indexed by HexEdgeDirection: the top edges belong to the neighbour across them.
+        inline constexpr std::array<CanonicalEdge, 6> CANONICAL_EDGES{{
+            {{0, 0}, HexEdgeDirection::BOTTOM_RIGHT},
+            {{0, 0}, HexEdgeDirection::BOTTOM},
+            {{0, 0}, HexEdgeDirection::BOTTOM_LEFT},
+            {{-1, 0}, HexEdgeDirection::BOTTOM_RIGHT},
+            {{0, -1}, HexEdgeDirection::BOTTOM},
+            {{1, -1}, HexEdgeDirection::BOTTOM_LEFT},
+        }};
+    } // namespace detail
+
+    constexpr CornerCoord canonical_corner_coord(const CornerCoord &coord) {
+        const auto &canonical = detail::CANONICAL_CORNERS[static_cast<int>(coord.corner_direction)];
+        return {coord.hex_coord + canonical.hex_offset, canonical.corner_direction};
+    }
+
+    constexpr EdgeCoord canonical_edge_coord(const EdgeCoord &coord) {
+        const auto &canonical = detail::CANONICAL_EDGES[static_cast<int>(coord.edge_direction)];
+        return {coord.hex_coord + canonical.hex_offset, canonical.edge_direction};
+    }
+
+    constexpr HexKey encode_hex(const HexCoord2 &coord) {
+        return static_cast<HexKey>(coord.q + COORD_KEY_BIAS) << COORD_KEY_BITS |
+               static_cast<HexKey>(coord.r + COORD_KEY_BIAS);
+    }
+
+    constexpr HexCoord2 decode_hex(const HexKey key) {
+        constexpr HexKey mask = (HexKey{1} << COORD_KEY_BITS) - 1;
+        return {
+            static_cast<int>(key >> COORD_KEY_BITS) - COORD_KEY_BIAS,
+            static_cast<int>(key & mask) - COORD_KEY_BIAS,
+        };
+    }
+
+    // Accepts any of the coordinates naming the corner.
+    constexpr CornerKey encode_corner(const CornerCoord &coord) {
+        const CornerCoord canonical = canonical_corner_coord(coord);
+        return encode_hex(canonical.hex_coord) << 1 | static_cast<CornerKey>(canonical.corner_direction);
+    }
+
+    // Canonical coordinate of the corner.
+    constexpr CornerCoord decode_corner(const CornerKey key) {
+        return {decode_hex(key >> 1), static_cast<HexCornerDirection>(key & 1)};
+    }
+
+    // Accepts any of the coordinates naming the edge.
+    constexpr EdgeKey encode_edge(const EdgeCoord &coord) {
+        const EdgeCoord canonical = canonical_edge_coord(coord);
+        return encode_hex(canonical.hex_coord) << 2 | static_cast<EdgeKey>(canonical.edge_direction);
+    }
+
+    // Canonical coordinate of the edge.
+    constexpr EdgeCoord decode_edge(const EdgeKey key) {
+        return {decode_hex(key >> 2), static_cast<HexEdgeDirection>(key & 3)};
+    }
+} // namespace Map
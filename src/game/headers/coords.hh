@@ -1,8 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <ostream>
+#include <stdexcept>
 #include <string>
-#include <vector>
 
 
 namespace Map {
@@ -15,18 +17,21 @@ namespace Map {
                 TOP_RIGHT,
         };
 
-        const std::vector HEX_EDGE_DIRECTIONS{
+        inline constexpr std::array HEX_EDGE_DIRECTIONS{
                 HexEdgeDirection::BOTTOM_RIGHT, HexEdgeDirection::BOTTOM, HexEdgeDirection::BOTTOM_LEFT,
                 HexEdgeDirection::TOP_LEFT, HexEdgeDirection::TOP, HexEdgeDirection::TOP_RIGHT,
         };
 
-        HexEdgeDirection opposite_direction(const HexEdgeDirection &hex_edge);
+        // All three direction enums go round the hex clockwise, so the opposite direction is half a turn away.
+        constexpr HexEdgeDirection opposite_direction(const HexEdgeDirection &direction) {
+                return static_cast<HexEdgeDirection>((static_cast<int>(direction) + 3) % 6);
+        }
 
         enum class CornerEdgeDirection { RIGHT = 0, BOTTOM_RIGHT, BOTTOM_LEFT, LEFT, TOP_LEFT, TOP_RIGHT };
 
-        // Note: Can be optimized. The RIGHT, BOTTOM_LEFT AND TOP_LEFT behave in the
-        // same way Same as BOTTOM_RIGHT, LEFT and TOP_RIGHT
-        const std::vector<std::vector<CornerEdgeDirection> > CORNER_TO_EDGE_DIRECTION_MAPPING{
+        // Edges leaving a corner, indexed by HexCornerDirection. The RIGHT, BOTTOM_LEFT and TOP_LEFT corners have
+        // the same shape, as do the BOTTOM_RIGHT, LEFT and TOP_RIGHT corners.
+        inline constexpr std::array<std::array<CornerEdgeDirection, 3>, 6> CORNER_TO_EDGE_DIRECTION_MAPPING{{
                 // HexCornerDirection::RIGHT
                 {
                         CornerEdgeDirection::RIGHT,
@@ -63,11 +68,11 @@ namespace Map {
                         CornerEdgeDirection::LEFT,
                         CornerEdgeDirection::TOP_RIGHT,
                 },
-        };
+        }};
 
-        // Note: Can be optimized. The RIGHT, BOTTOM_LEFT AND TOP_LEFT behave in the
-        // same way Same as BOTTOM_RIGHT, LEFT and TOP_RIGHT
-        const std::vector<std::vector<CornerEdgeDirection> > EDGE_TO_CORNER_DIRECTION_MAPPING{
+        // The two ends of an edge, indexed by HexEdgeDirection, seen from the edge. The first end is the corner
+        // clockwise after the edge, the second the corner before it.
+        inline constexpr std::array<std::array<CornerEdgeDirection, 2>, 6> EDGE_TO_CORNER_DIRECTION_MAPPING{{
                 // HexEdgeDirection::BOTTOM_RIGHT
                 {
                         CornerEdgeDirection::BOTTOM_LEFT,
@@ -75,18 +80,18 @@ namespace Map {
                 },
                 // HexEdgeDirection::BOTTOM
                 {
-                        CornerEdgeDirection::RIGHT,
                         CornerEdgeDirection::LEFT,
+                        CornerEdgeDirection::RIGHT,
                 },
                 // HexEdgeDirection::BOTTOM_LEFT
                 {
-                        CornerEdgeDirection::BOTTOM_RIGHT,
                         CornerEdgeDirection::TOP_LEFT,
+                        CornerEdgeDirection::BOTTOM_RIGHT,
                 },
                 // HexEdgeDirection::TOP_LEFT
                 {
-                        CornerEdgeDirection::BOTTOM_LEFT,
                         CornerEdgeDirection::TOP_RIGHT,
+                        CornerEdgeDirection::BOTTOM_LEFT,
                 },
                 // HexEdgeDirection::TOP
                 {
@@ -98,9 +103,11 @@ namespace Map {
                         CornerEdgeDirection::BOTTOM_RIGHT,
                         CornerEdgeDirection::TOP_LEFT,
                 },
-        };
+        }};
 
-        CornerEdgeDirection opposite_direction(const CornerEdgeDirection &);
+        constexpr CornerEdgeDirection opposite_direction(const CornerEdgeDirection &direction) {
+                return static_cast<CornerEdgeDirection>((static_cast<int>(direction) + 3) % 6);
+        }
 
         enum class HexCornerDirection {
                 RIGHT = 0,
@@ -111,15 +118,41 @@ namespace Map {
                 TOP_RIGHT,
         };
 
-        const std::vector HEX_CORNER_DIRECTIONS{
+        inline constexpr std::array HEX_CORNER_DIRECTIONS{
                 HexCornerDirection::RIGHT, HexCornerDirection::BOTTOM_RIGHT, HexCornerDirection::BOTTOM_LEFT,
                 HexCornerDirection::LEFT, HexCornerDirection::TOP_LEFT, HexCornerDirection::TOP_RIGHT,
         };
 
-        HexCornerDirection opposite_direction(const HexCornerDirection &);
-
-        HexCornerDirection edge_direction_to_corner_direction(const HexEdgeDirection &edge_direction,
-                                                              const CornerEdgeDirection &edge_corner_direction);
+        constexpr HexCornerDirection opposite_direction(const HexCornerDirection &direction) {
+                return static_cast<HexCornerDirection>((static_cast<int>(direction) + 3) % 6);
+        }
+
+        // Hex corner sitting at the `edge_corner_direction` end of the hex edge `edge_direction`. Edge i of a hex
+        // runs from corner i to corner i + 1; the end two steps clockwise of the edge is corner i + 1 and the end
+        // one step counter-clockwise is corner i.
+        constexpr HexCornerDirection edge_direction_to_corner_direction(const HexEdgeDirection &edge_direction,
+                                                                        const CornerEdgeDirection &edge_corner_direction) {
+                const int edge = static_cast<int>(edge_direction);
+                const int turn = (static_cast<int>(edge_corner_direction) - edge + 6) % 6;
+                if (turn != 2 && turn != 5) {
+                        throw std::invalid_argument("This edge does not support this corner.");
+                }
+                return static_cast<HexCornerDirection>((edge + (turn == 2)) % 6);
+        }
+
+        // Hex corners at the ends of each hex edge, in EDGE_TO_CORNER_DIRECTION_MAPPING order. Lets adjacency
+        // generation walk both tables side by side instead of resolving every pair.
+        inline constexpr std::array<std::array<HexCornerDirection, 2>, 6> EDGE_TO_HEX_CORNER_DIRECTION_MAPPING = [] {
+                std::array<std::array<HexCornerDirection, 2>, 6> mapping{};
+                for (const auto edge_direction: HEX_EDGE_DIRECTIONS) {
+                        const int edge = static_cast<int>(edge_direction);
+                        for (size_t end = 0; end < 2; end++) {
+                                mapping[edge][end] = edge_direction_to_corner_direction(
+                                        edge_direction, EDGE_TO_CORNER_DIRECTION_MAPPING[edge][end]);
+                        }
+                }
+                return mapping;
+        }();
 
         struct EdgeCoord;
         struct CornerCoord;
@@ -128,30 +161,52 @@ namespace Map {
                 int q;
                 int r;
 
-                bool operator==(const HexCoord2 &rhs) const;
+                constexpr bool operator==(const HexCoord2 &rhs) const = default;
 
-                HexCoord2 operator+(const HexCoord2 &rhs) const;
+                constexpr HexCoord2 operator+(const HexCoord2 &rhs) const { return {q + rhs.q, r + rhs.r}; }
 
-                [[nodiscard]] HexCoord2 get_neighbouring_hex_coord(HexEdgeDirection neighbour_direction) const;
+                [[nodiscard]] constexpr HexCoord2 get_neighbouring_hex_coord(HexEdgeDirection neighbour_direction) const;
 
-                [[nodiscard]] EdgeCoord get_edge_coord(HexEdgeDirection edge_direction) const;
+                [[nodiscard]] constexpr EdgeCoord get_edge_coord(HexEdgeDirection edge_direction) const;
 
-                [[nodiscard]] CornerCoord get_corner_coord(HexCornerDirection corner_direction) const;
+                [[nodiscard]] constexpr CornerCoord get_corner_coord(HexCornerDirection corner_direction) const;
         };
 
+        // Axial offset to the neighbouring hex, indexed by HexEdgeDirection.
+        inline constexpr std::array<HexCoord2, 6> HEX_NEIGHBOUR_OFFSETS{{
+                {1, 0},  // BOTTOM_RIGHT
+                {0, 1},  // BOTTOM
+                {-1, 1}, // BOTTOM_LEFT
+                {-1, 0}, // TOP_LEFT
+                {0, -1}, // TOP
+                {1, -1}, // TOP_RIGHT
+        }};
+
         struct EdgeCoord {
                 HexCoord2 hex_coord;
                 HexEdgeDirection edge_direction;
 
-                bool operator==(const EdgeCoord &other) const;
+                constexpr bool operator==(const EdgeCoord &other) const = default;
         };
 
         struct CornerCoord {
                 HexCoord2 hex_coord;
                 HexCornerDirection corner_direction;
 
-                bool operator==(const CornerCoord &other) const;
+                constexpr bool operator==(const CornerCoord &other) const = default;
         };
+
+        constexpr HexCoord2 HexCoord2::get_neighbouring_hex_coord(const HexEdgeDirection neighbour_direction) const {
+                return *this + HEX_NEIGHBOUR_OFFSETS[static_cast<int>(neighbour_direction)];
+        }
+
+        constexpr EdgeCoord HexCoord2::get_edge_coord(const HexEdgeDirection edge_direction) const {
+                return EdgeCoord{*this, edge_direction};
+        }
+
+        constexpr CornerCoord HexCoord2::get_corner_coord(const HexCornerDirection corner_direction) const {
+                return CornerCoord{*this, corner_direction};
+        }
 } // namespace Map
 
 std::string to_string(const Map::HexCoord2 &coord);
@@ -1,43 +1,37 @@
 #pragma once
 
+#include <cstdint>
+
+#include "coord_keys.hh"
 #include "coords.hh"
 
-template<>
-struct std::hash<Map::HexCoord2> {
-    size_t operator()(const Map::HexCoord2 &s) const noexcept {
-        size_t seed = 0;
-        seed ^= std::hash<int>{}(s.q) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        seed ^= std::hash<int>{}(s.r) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
+namespace Map::detail {
+    // Fibonacci hashing of a packed coordinate: spreads neighbouring keys over the whole word.
+    constexpr size_t mix_coord_key(const std::uint64_t key) {
+        return static_cast<size_t>((key + 1) * 0x9E3779B97F4A7C15ull);
     }
-};
+} // namespace Map::detail
 
 template<>
-struct std::hash<Map::HexCornerDirection> {
-    size_t operator()(const Map::HexCornerDirection &s) const noexcept {
-        size_t seed = 0;
-        seed ^= std::hash<int>{}(static_cast<int>(s)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
+struct std::hash<Map::HexCoord2> {
+    size_t operator()(const Map::HexCoord2 &s) const noexcept {
+        return Map::detail::mix_coord_key(Map::encode_hex(s));
     }
 };
 
-
+// Corner and edge coordinates hash their own naming, not the canonical one, to stay consistent with operator==.
 template<>
 struct std::hash<Map::EdgeCoord> {
     size_t operator()(const Map::EdgeCoord &s) const noexcept {
-        size_t seed = 0;
-        seed ^= std::hash<Map::HexCoord2>{}(s.hex_coord) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        seed ^= std::hash<Map::HexEdgeDirection>{}(s.edge_direction) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
+        return Map::detail::mix_coord_key(std::uint64_t{Map::encode_hex(s.hex_coord)} << 3 |
+                                          static_cast<std::uint64_t>(s.edge_direction));
     }
 };
 
 template<>
 struct std::hash<Map::CornerCoord> {
     size_t operator()(const Map::CornerCoord &s) const noexcept {
-        size_t seed = 0;
-        seed ^= std::hash<Map::HexCoord2>{}(s.hex_coord) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        seed ^= std::hash<Map::HexCornerDirection>{}(s.corner_direction) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
+        return Map::detail::mix_coord_key(std::uint64_t{Map::encode_hex(s.hex_coord)} << 3 |
+                                          static_cast<std::uint64_t>(s.corner_direction));
     }
 };
@@ -0,0 +1,101 @@
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace Map {
+    // Fixed size, direction indexed neighbour table. The six directions of an enum are folded onto `slot_count`
+    // slots (6 for hexes, 3 for corners, 2 for edges): the directions a node can have never share a slot.
+    //
+    // Iterating yields the (direction, neighbour) pairs of the filled slots, so `slots | std::views::values`
+    // walks the neighbours without allocating. The table is trivially copyable so whole boards can be memcpy'd.
+    template<typename Direction, typename Node, size_t slot_count>
+    class DirectionSlots {
+    public:
+        using Entry = std::pair<Direction, Node *>;
+
+    private:
+        std::array<Direction, slot_count> m_directions{};
+        std::array<Node *, slot_count> m_nodes{};
+
+        static constexpr auto slot_of(const Direction direction) -> size_t {
+            return static_cast<size_t>(direction) * slot_count / 6;
+        }
+
+    public:
+        class Iterator {
+            const DirectionSlots *m_slots = nullptr;
+            size_t m_slot = 0;
+
+            void skip_empty() {
+                while (m_slot != slot_count && m_slots->m_nodes[m_slot] == nullptr) {
+                    ++m_slot;
+                }
+            }
+
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = Entry;
+            using reference = Entry;
+
+            Iterator() = default;
+
+            Iterator(const DirectionSlots *slots, const size_t slot) : m_slots(slots), m_slot(slot) {
+                skip_empty();
+            }
+
+            reference operator*() const { return {m_slots->m_directions[m_slot], m_slots->m_nodes[m_slot]}; }
+
+            Iterator &operator++() {
+                ++m_slot;
+                skip_empty();
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            friend bool operator==(const Iterator &a, const Iterator &b) { return a.m_slot == b.m_slot; }
+        };
+
+        [[nodiscard]] auto get(const Direction direction) const -> Node * {
+            const size_t slot = slot_of(direction);
+            return m_directions[slot] == direction ? m_nodes[slot] : nullptr;
+        }
+
+        void set(const Direction direction, Node *node) {
+            const size_t slot = slot_of(direction);
+            m_directions[slot] = direction;
+            m_nodes[slot] = node;
+        }
+
+        // Moves every neighbour pointer from the node array starting at `old_base` to the same index in the node
+        // array starting at `new_base`.
+        void rebase(const Node *old_base, Node *new_base) {
+            for (auto &node: m_nodes) {
+                if (node != nullptr) {
+                    node = new_base + (node - old_base);
+                }
+            }
+        }
+
+        [[nodiscard]] auto size() const -> size_t {
+            size_t filled = 0;
+            for (const auto *node: m_nodes) {
+                filled += node != nullptr;
+            }
+            return filled;
+        }
+
+        [[nodiscard]] auto begin() const -> Iterator { return {this, 0}; }
+
+        [[nodiscard]] auto end() const -> Iterator { return {this, slot_count}; }
+    };
+} // namespace Map
@@ -0,0 +1,127 @@
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace Game {
+    // Number of values of an enum whose enumerators run from 0 to count - 1. Taken from a trailing COUNT
+    // enumerator when there is one, otherwise from a constexpr `enum_count(Enum)` found next to the enum by
+    // argument dependent lookup.
+    template<typename Enum>
+        requires std::is_enum_v<Enum>
+    constexpr size_t enum_count() {
+        if constexpr (requires { Enum::COUNT; }) {
+            return static_cast<size_t>(Enum::COUNT);
+        } else {
+            return enum_count(Enum{});
+        }
+    }
+
+    // Dense map from every value of an enum to a V, stored as a std::array indexed by the enumerator: lookups
+    // are an array index, nothing is hashed and nothing is allocated. Every key always has a value, default
+    // constructed until set.
+    //
+    // Iterating yields (key, value) pairs in enumerator order, so `for (auto &[key, value]: map)` works as it
+    // does over an std::unordered_map.
+    template<typename Key, typename Value>
+    class EnumMap {
+    public:
+        static constexpr size_t SIZE = enum_count<Key>();
+
+    private:
+        std::array<Value, SIZE> m_values{};
+
+        template<typename Owner, typename Reference>
+        class Iterator {
+            Owner *m_map = nullptr;
+            size_t m_index = 0;
+
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = std::pair<Key, Reference>;
+            using reference = value_type;
+
+            constexpr Iterator() = default;
+
+            constexpr Iterator(Owner *map, const size_t index) : m_map(map), m_index(index) {
+            }
+
+            constexpr reference operator*() const {
+                return {static_cast<Key>(m_index), m_map->m_values[m_index]};
+            }
+
+            constexpr Iterator &operator++() {
+                ++m_index;
+                return *this;
+            }
+
+            constexpr Iterator operator++(int) {
+                Iterator previous = *this;
+                ++*this;
+                return previous;
+            }
+
+            friend constexpr bool operator==(const Iterator &a, const Iterator &b) { return a.m_index == b.m_index; }
+        };
+
+    public:
+        using iterator = Iterator<EnumMap, Value &>;
+        using const_iterator = Iterator<const EnumMap, const Value &>;
+
+        constexpr EnumMap() = default;
+
+        // Keys left out keep a default constructed value.
+        constexpr EnumMap(const std::initializer_list<std::pair<Key, Value> > entries) {
+            for (const auto &[key, value]: entries) {
+                m_values[static_cast<size_t>(key)] = value;
+            }
+        }
+
+        [[nodiscard]] constexpr auto operator[](const Key key) -> Value & { return m_values[static_cast<size_t>(key)]; }
+
+        [[nodiscard]] constexpr auto operator[](const Key key) const -> const Value & {
+            return m_values[static_cast<size_t>(key)];
+        }
+
+        // Bounds checked, for keys that did not come from the enumerators.
+        [[nodiscard]] constexpr auto at(const Key key) -> Value & {
+            check(key);
+            return (*this)[key];
+        }
+
+        [[nodiscard]] constexpr auto at(const Key key) const -> const Value & {
+            check(key);
+            return (*this)[key];
+        }
+
+        [[nodiscard]] static constexpr auto size() -> size_t { return SIZE; }
+
+        [[nodiscard]] constexpr auto values() -> std::array<Value, SIZE> & { return m_values; }
+
+        [[nodiscard]] constexpr auto values() const -> const std::array<Value, SIZE> & { return m_values; }
+
+        constexpr auto operator==(const EnumMap &other) const -> bool = default;
+
+        [[nodiscard]] constexpr auto begin() -> iterator { return {this, 0}; }
+
+        [[nodiscard]] constexpr auto end() -> iterator { return {this, SIZE}; }
+
+        [[nodiscard]] constexpr auto begin() const -> const_iterator { return {this, 0}; }
+
+        [[nodiscard]] constexpr auto end() const -> const_iterator { return {this, SIZE}; }
+
+    private:
+        static constexpr void check(const Key key) {
+            if (static_cast<size_t>(key) >= SIZE) {
+                throw std::out_of_range("Key outside of the enum range");
+            }
+        }
+    };
+} // namespace Game
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "board_generator.hh"
+#include "board_state.hh"
+#include "board_topology.hh"
+#include "map.hh"
+
+namespace Map {
+    // Flat mode of a Map: the topology is index based and shared by every board of the same shape, and every per
+    // node value lives in the BoardState, in contiguous arrays indexed by the node id. Copying a FlatMap starts a
+    // new game on the same board for the cost of copying its state.
+    class FlatMap {
+        std::shared_ptr<const BoardTopology> m_topology;
+        BoardState m_state;
+
+    public:
+        FlatMap(std::shared_ptr<const BoardTopology> topology, BoardState state);
+
+        static FlatMap from_map(const Map &map);
+
+        // Deals a board straight into a BoardState, without building the pointer based Map. The robber starts on
+        // the first desert.
+        static FlatMap generate(size_t radius, std::uint64_t seed,
+                                const TileDistribution &distribution = TileDistribution::standard());
+
+        [[nodiscard]] auto get_topology() const -> const BoardTopology & { return *m_topology; }
+
+        [[nodiscard]] auto get_shared_topology() const -> const std::shared_ptr<const BoardTopology> & {
+            return m_topology;
+        }
+
+        [[nodiscard]] auto get_state() const -> const BoardState & { return m_state; }
+
+        [[nodiscard]] auto get_state() -> BoardState & { return m_state; }
+
+        [[nodiscard]] auto get_hex_resource(const HexId hex) const -> Resource { return m_state.get_hex_resource(hex); }
+
+        [[nodiscard]] auto get_hex_number(const HexId hex) const -> int { return m_state.get_hex_number(hex); }
+
+        [[nodiscard]] auto get_house(const CornerId corner) const -> const House & { return m_state.get_house(corner); }
+
+        [[nodiscard]] auto get_road(const EdgeId edge) const -> const Road & { return m_state.get_road(edge); }
+
+        void set_house(CornerId corner, const House &house);
+
+        void set_road(EdgeId edge, const Road &road);
+    };
+} // namespace Map
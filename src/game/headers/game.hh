@@ -4,13 +4,26 @@
 
 #ifndef COLOLITE_GAME_HH
 #define COLOLITE_GAME_HH
+#include <cstdint>
 
+using PlayerId = std::int8_t;
+
+constexpr PlayerId NO_PLAYER = -1;
+
+// Piece state is stored inline in the board nodes, an empty House/Road means nothing is built there.
 struct House {
-    int level = 1;
+    PlayerId owner = NO_PLAYER;
+    // 1 for a settlement, 2 for a city, 0 when nothing is built
+    std::uint8_t level = 0;
+
+    [[nodiscard]] bool is_built() const { return level != 0; }
 };
 
 
-class Road {
+struct Road {
+    PlayerId owner = NO_PLAYER;
+
+    [[nodiscard]] bool is_built() const { return owner != NO_PLAYER; }
 };
 
 class Roll {
@@ -15,6 +15,10 @@ namespace Game {
         FREE_ROAD,
         ROLL,
         PLAYER_TURN,
+        // After a 7, before the rest of the turn
+        MOVE_ROBBER,
+        // After the robber moved next to an opponent holding cards, before the card taken is known
+        STEAL,
     };
 
     namespace GamePhaseParameters {
@@ -1,33 +1,201 @@
 
 #pragma once
 
-#include <deque>
+#include <cstdint>
+#include <array>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "bitboard.hh"
+#include "board_bitboards.hh"
 #include "game.hh"
 #include "game_sequence.hh"
+#include "legal_moves.hh"
 #include "map.hh"
+#include "production_index.hh"
+#include "resource_bundle.hh"
+#include "road_network.hh"
+#include "zobrist.hh"
 
 namespace Game {
+    // Dice as a deck of the 36 outcomes of two dice. Rolls are drawn without replacement and the discard pile is
+    // shuffled back in once fewer than five remain, so a game sees close to the expected number of each roll.
+    //
+    // The whole deck is one fixed array: the discard pile in the order it was drawn, then the rolls to come. So
+    // drawing, undoing a draw and copying the deck never allocate.
     struct RollManager {
-        std::deque<Roll> rolls_queue;
-        std::vector<Roll> discard_pile;
+        static constexpr size_t DECK_SIZE = 36;
+        static constexpr size_t RESHUFFLE_BELOW = 5;
+
+        std::array<std::int8_t, DECK_SIZE> rolls{};
+        // rolls[0, drawn) is the discard pile, rolls[drawn, DECK_SIZE) the queue
+        std::uint8_t drawn = 0;
+        std::minstd_rand random_engine;
 
         RollManager() = default;
 
+        explicit RollManager(std::uint32_t seed);
+
         void initialize_rolls();
+
+        auto draw() -> Roll;
+
+        // Draws the roll at `position` in the queue instead of the one on top.
+        auto draw(size_t position) -> Roll;
+
+        // Position of the first roll of `value` in the queue, std::nullopt when none is left before the reshuffle.
+        [[nodiscard]] auto find(int value) const -> std::optional<size_t>;
+
+        // Rolls of `value` left in the queue.
+        [[nodiscard]] auto count(int value) const -> size_t;
+
+        [[nodiscard]] auto get_queue_size() const -> size_t { return DECK_SIZE - drawn; }
+
+        // Value of the roll at `position` in the queue, 0 being the next one.
+        [[nodiscard]] auto peek(const size_t position) const -> int { return rolls[drawn + position]; }
+
+        // Whether the next draw shuffles the discard pile back in.
+        [[nodiscard]] auto will_reshuffle() const -> bool { return get_queue_size() <= RESHUFFLE_BELOW; }
+
+        // Puts the last roll drawn back where it was drawn from. Only valid when that draw did not reshuffle.
+        void undraw(size_t position = 0);
+    };
+
+    // Reverse of one GameState mutation: what to put back to undo it.
+    struct UndoEntry {
+        enum class Kind : std::uint8_t {
+            // House `house` back on corner `node`, `last_built_corner` back as the last built corner, and the road
+            // networks back to `road_network_mark`
+            HOUSE,
+            // Road `road` back on edge `node`, and the road networks back to `road_network_mark`
+            ROAD,
+            // Take `resources` back from `player`
+            RESOURCES,
+            // Robber back on hex `node`
+            ROBBER,
+            // Put the last roll drawn back on the deck, at position `node`
+            ROLL,
+            // Restore the roll deck saved before a reshuffle or set_roll_manager
+            RESHUFFLE,
+            // Turn back to `player`, in the phase stored in `node`
+            TURN,
+            // Longest road back to `player`
+            LONGEST_ROAD,
+        };
+
+        Kind kind;
+        PlayerId player = NO_PLAYER;
+        House house{};
+        Road road{};
+        std::uint32_t node = 0;
+        std::uint32_t last_built_corner = 0;
+        ResourceBundle resources{};
+        size_t road_network_mark = 0;
+    };
+
+    using UndoMark = size_t;
+
+    // Copy of everything in a GameState that changes during a game. Taking another snapshot into the same
+    // object reuses its buffers, so after the first one a snapshot or restore is a handful of flat copies and
+    // allocates nothing.
+    class GameStateSnapshot {
+        friend class GameState;
+
+        const std::byte *m_node_memory = nullptr;
+        std::vector<std::byte> m_map_nodes;
+        std::vector<ResourceBundle> m_player_resources;
+        std::vector<RecipeMask> m_affordable;
+        std::optional<Map::BoardBitboards> m_pieces;
+        std::optional<LegalMoves> m_legal_moves;
+        std::optional<ProductionIndex> m_production;
+        std::optional<RoadNetwork> m_road_network;
+        RollManager m_roll_manager;
+        Map::HexId m_robber = Map::NO_NODE;
+        Map::CornerId m_last_built_corner = Map::NO_NODE;
+        PlayerId m_current_player = 0;
+        GamePhase m_phase = GamePhase::FREE_BUILDING;
+        PlayerId m_longest_road_holder = NO_PLAYER;
+        ZobristHash m_hash = 0;
+
+    public:
+        // What the snapshot holds, to read it without restoring it, as the autosave does on its own thread. Only
+        // valid once a snapshot has been taken into it.
+        [[nodiscard]] auto get_player_count() const -> size_t { return m_player_resources.size(); }
+
+        [[nodiscard]] auto get_resources(const PlayerId player) const -> const ResourceBundle & {
+            return m_player_resources[player];
+        }
+
+        [[nodiscard]] auto get_pieces() const -> const Map::BoardBitboards & { return *m_pieces; }
+
+        [[nodiscard]] auto get_roll_manager() const -> const RollManager & { return m_roll_manager; }
+
+        [[nodiscard]] auto get_robber() const -> Map::HexId { return m_robber; }
+
+        [[nodiscard]] auto get_last_built_corner() const -> Map::CornerId { return m_last_built_corner; }
+
+        [[nodiscard]] auto get_current_player() const -> PlayerId { return m_current_player; }
+
+        [[nodiscard]] auto get_phase() const -> GamePhase { return m_phase; }
+
+        [[nodiscard]] auto get_longest_road_holder() const -> PlayerId { return m_longest_road_holder; }
+
+        [[nodiscard]] auto get_hash() const -> ZobristHash { return m_hash; }
     };
 
-    using PlayerResources = std::unordered_map<Map::Resource, int>;
+    constexpr size_t DEFAULT_PLAYER_COUNT = 4;
 
     class GameState {
         GameSequence m_game_sequence;
         RollManager m_roll_manager;
-        PlayerResources m_player_resources;
+        std::vector<ResourceBundle> m_player_resources;
+        // What each player holds enough resources for, refreshed whenever their resources change
+        std::vector<RecipeMask> m_affordable;
         Map::Map m_map;
-        Map::Corner *m_last_built_corner = nullptr;
+        Map::BoardBitboards m_pieces;
+        LegalMoves m_legal_moves;
+        ProductionIndex m_production;
+        RoadNetwork m_road_network;
+        std::vector<ResourceBundle> m_production_deltas;
+        Map::HexId m_robber = Map::NO_NODE;
+        Map::CornerBoard m_no_corners;
+        Map::EdgeBoard m_no_edges;
+        Map::CornerId m_last_built_corner = Map::NO_NODE;
+        PlayerId m_current_player = 0;
+        GamePhase m_phase = GamePhase::FREE_BUILDING;
+        PlayerId m_longest_road_holder = NO_PLAYER;
+        // Zobrist hash of the state, kept up to date by every write below
+        ZobristHash m_hash = 0;
+
+        std::vector<UndoEntry> m_undo_log;
+        // Roll decks saved by the RESHUFFLE entries of the log, in order
+        std::vector<RollManager> m_saved_roll_decks;
 
-        explicit GameState(Map::Map map);
+        void update_affordable(PlayerId player);
+
+        void write_house(Map::CornerId corner, const House &house);
+
+        void write_road(Map::EdgeId edge, const Road &road);
+
+        void write_resources(PlayerId player, const ResourceBundle &resources);
+
+        void write_robber(Map::HexId hex);
+
+        void write_turn(PlayerId player, GamePhase phase);
+
+        void write_longest_road_holder(PlayerId player);
+
+        auto draw_roll(size_t position) -> int;
 
     public:
+        explicit GameState(Map::Map map, size_t player_count = DEFAULT_PLAYER_COUNT,
+                           std::uint32_t roll_seed = std::random_device{}());
+
+        // Independent copy on a clone of the map, with an empty undo log. For search threads that each need a
+        // state of their own to play on.
+        [[nodiscard]] auto clone() const -> GameState;
+
         // Trade
         auto can_trade(Map::Resource &resource_to_be_sold) const -> bool;
 
@@ -37,6 +205,133 @@ namespace Game {
 
         [[nodiscard]] auto get_map() const -> const Map::Map &;
 
+        [[nodiscard]] auto get_player_count() const -> size_t { return m_player_resources.size(); }
+
+        [[nodiscard]] auto get_resources(const PlayerId player) const -> const ResourceBundle & {
+            return m_player_resources[player];
+        }
+
+        // Adds `amount` (negative to pay) of `resource` to the player.
+        void add_resources(PlayerId player, Map::Resource resource, int amount);
+
+        // Adds `resources` (negative lanes to pay) to the player.
+        void add_resources(PlayerId player, const ResourceBundle &resources);
+
+        // Every recipe the player can pay for right now.
+        [[nodiscard]] auto get_affordable_recipes(const PlayerId player) const -> RecipeMask {
+            return m_affordable[player];
+        }
+
+        [[nodiscard]] auto can_afford(const PlayerId player, const Recipe recipe) const -> bool {
+            return (m_affordable[player] & recipe_bit(recipe)) != 0;
+        }
+
+        [[nodiscard]] auto get_robber() const -> Map::HexId { return m_robber; }
+
+        void set_robber(Map::HexId hex);
+
+        // Hands out what every player gains from `roll`, reading only the houses next to hexes of that number.
+        void produce(int roll);
+
+        [[nodiscard]] auto get_production() const -> const ProductionIndex & { return m_production; }
+
+        // Draws the next roll and hands out its production. Returns the roll; a 7 produces nothing.
+        auto roll_dice() -> int;
+
+        // Draws a roll of `value` from the deck rather than the next one, for search picking the outcome of the
+        // dice. Throws std::invalid_argument when the deck holds no such roll before it is reshuffled.
+        auto roll_dice(int value) -> int;
+
+        [[nodiscard]] auto get_roll_manager() const -> const RollManager & { return m_roll_manager; }
+
+        // Replaces the roll deck, order and random engine included, for loading a saved game. Undoes like a
+        // reshuffle.
+        void set_roll_manager(const RollManager &deck);
+
+        // One point per settlement and two per city. The two points of longest road are the game flow's to add.
+        [[nodiscard]] auto get_building_points(PlayerId player) const -> std::uint32_t;
+
+        // Puts `house` on the corner, replacing what stood there, and updates the legal moves around it.
+        void place_house(Map::CornerId corner, const House &house);
+
+        // Puts `road` on the edge, replacing what lay there, and updates the legal moves around it.
+        void place_road(Map::EdgeId edge, const Road &road);
+
+        [[nodiscard]] auto get_pieces() const -> const Map::BoardBitboards & { return m_pieces; }
+
+        [[nodiscard]] auto get_legal_moves() const -> const LegalMoves & { return m_legal_moves; }
+
+        [[nodiscard]] auto get_road_network() const -> const RoadNetwork & { return m_road_network; }
+
+        // Where the player may build a settlement now, empty when they cannot pay for one.
+        [[nodiscard]] auto get_legal_builds(const PlayerId player) const -> const Map::CornerBoard & {
+            return can_afford(player, Recipe::SETTLEMENT) ? m_legal_moves.get_settlements(player) : m_no_corners;
+        }
+
+        // Where the player may build a road now, empty when they cannot pay for one.
+        [[nodiscard]] auto get_legal_roads(const PlayerId player) const -> const Map::EdgeBoard & {
+            return can_afford(player, Recipe::ROAD) ? m_legal_moves.get_roads(player) : m_no_edges;
+        }
+
+        // Settlements the player may upgrade now, empty when they cannot pay for a city.
+        [[nodiscard]] auto get_legal_upgrades(const PlayerId player) const -> const Map::CornerBoard & {
+            return can_afford(player, Recipe::CITY) ? m_pieces.get_legal_upgrades(player) : m_no_corners;
+        }
+
+        // Where the free settlements of the setup rounds may go.
+        [[nodiscard]] auto get_setup_builds() const -> const Map::CornerBoard & {
+            return m_legal_moves.get_free_corners();
+        }
+
+        // Where the free road following the last settlement may go.
+        [[nodiscard]] auto get_setup_roads() const -> Map::EdgeBoard;
+
+        // Corner of the last house placed, Map::NO_NODE before the first.
+        [[nodiscard]] auto get_last_built_corner() const -> Map::CornerId { return m_last_built_corner; }
+
+        [[nodiscard]] auto get_current_player() const -> PlayerId { return m_current_player; }
+
+        [[nodiscard]] auto get_phase() const -> GamePhase { return m_phase; }
+
+        // Whose turn it is and what they are doing. Only tracked for the hash: two states that differ in who moves
+        // next are different positions for a search.
+        void set_turn(PlayerId player, GamePhase phase);
+
+        // Who holds longest road, NO_PLAYER before anyone does. The game flow awards it; the state only keeps it,
+        // since who held it first decides ties.
+        [[nodiscard]] auto get_longest_road_holder() const -> PlayerId { return m_longest_road_holder; }
+
+        void set_longest_road_holder(PlayerId player);
+
+        // Zobrist hash of the pieces, the hands, the robber, the turn and the longest road holder. The roll deck is
+        // left out: it is chance, not position.
+        [[nodiscard]] auto get_hash() const -> ZobristHash { return m_hash; }
+
+        // The hash recomputed from scratch, to check the incremental one against.
+        [[nodiscard]] auto compute_hash() const -> ZobristHash;
+
+        // Checks the incrementally maintained legal moves against a full recomputation, see
+        // LegalMoves::find_inconsistency.
+        [[nodiscard]] auto check_legal_moves() const -> std::optional<std::string>;
+
+        // Undo log. Every mutation above appends its reverse entry; undoing to a mark reverts everything done
+        // since, newest first, in time proportional to the number of changes.
+        [[nodiscard]] auto get_undo_mark() const -> UndoMark { return m_undo_log.size(); }
+
+        void undo(UndoMark mark);
+
+        // Drops the log, for long running games that will not undo past this point.
+        void clear_undo_log();
+
+        // Copies the mutable part of the state into `snapshot`, reusing its buffers.
+        void snapshot(GameStateSnapshot &snapshot) const;
+
+        [[nodiscard]] auto snapshot() const -> GameStateSnapshot;
+
+        // Puts the state back as it was when `snapshot` was taken from this same state, and clears the undo log.
+        // Throws std::invalid_argument for a snapshot of another game.
+        void restore(const GameStateSnapshot &snapshot);
+
         friend auto get_game_state() -> GameState &;
     };
 
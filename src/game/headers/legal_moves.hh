@@ -0,0 +1,55 @@
+
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bitboard.hh"
+#include "board_bitboards.hh"
+#include "game.hh"
+
+namespace Game {
+    // Where every player may build, kept in step with the pieces on the board. A placement only changes the
+    // rules around it: a house the corner, its neighbours and the edges at the corner, a road the edge and the
+    // corners and edges at its ends. The update functions re-check exactly those nodes, so the sets stay valid
+    // without a whole-board pass and reading them is free.
+    class LegalMoves {
+        struct PlayerMoves {
+            Map::CornerBoard settlements;
+            Map::EdgeBoard roads;
+        };
+
+        std::vector<PlayerMoves> m_players;
+        Map::CornerBoard m_free_corners;
+
+        void update_corner(const Map::BoardBitboards &pieces, Map::CornerId corner);
+
+        void update_edge(const Map::BoardBitboards &pieces, Map::EdgeId edge);
+
+    public:
+        // Computes every set from scratch.
+        explicit LegalMoves(const Map::BoardBitboards &pieces);
+
+        // Call after the house on `corner` changed in `pieces`.
+        void update_around_corner(const Map::BoardBitboards &pieces, Map::CornerId corner);
+
+        // Call after the road on `edge` changed in `pieces`.
+        void update_around_edge(const Map::BoardBitboards &pieces, Map::EdgeId edge);
+
+        // Corners where a settlement may go during setup.
+        [[nodiscard]] auto get_free_corners() const -> const Map::CornerBoard & { return m_free_corners; }
+
+        [[nodiscard]] auto get_settlements(const PlayerId player) const -> const Map::CornerBoard & {
+            return m_players[player].settlements;
+        }
+
+        [[nodiscard]] auto get_roads(const PlayerId player) const -> const Map::EdgeBoard & {
+            return m_players[player].roads;
+        }
+
+        // Compares every set against a full recomputation from `pieces`. Returns a description of the first
+        // difference, std::nullopt when the sets agree.
+        [[nodiscard]] auto find_inconsistency(const Map::BoardBitboards &pieces) const -> std::optional<std::string>;
+    };
+} // namespace Game
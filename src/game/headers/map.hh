@@ -1,116 +1,182 @@
 
 #pragma once
-#include <unordered_map>
-
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <span>
+#include <utility>
+
+#include "board_topology.hh"
 #include "coords_hash.hh"
 #include "coords.hh"
+#include "direction_slots.hh"
 #include "game.hh"
+#include "map_bounds.hh"
 
 namespace Map {
     struct Hex;
     struct Corner;
     struct Edge;
+    struct TileDistribution;
+
+    enum class Resource : std::uint8_t { NONE, WOOD, BRICK, SHEEP, WHEAT, STONE };
+
+    // Number of Resource values, NONE included, for arrays indexed by resource.
+    constexpr size_t RESOURCE_COUNT = 6;
 
-    enum class Resource { NONE, WOOD, BRICK, SHEEP, WHEAT, STONE };
+    // Sizes an EnumMap keyed by Resource.
+    constexpr size_t enum_count(Resource) { return RESOURCE_COUNT; }
+
+    // The resources a player can hold, in display order.
+    inline constexpr std::array RESOURCES{
+        Resource::WOOD, Resource::BRICK, Resource::SHEEP, Resource::WHEAT, Resource::STONE,
+    };
 
     struct Hex {
-        std::unordered_map<HexCornerDirection, Corner *> corners;
-        std::unordered_map<HexEdgeDirection, Edge *> edges;
+        DirectionSlots<HexCornerDirection, Corner, 6> corners;
+        DirectionSlots<HexEdgeDirection, Edge, 6> edges;
         Resource resource;
         int number;
     };
 
     struct Corner {
-        std::unordered_map<HexCornerDirection, Hex *> hexes;
-        std::unordered_map<CornerEdgeDirection, Edge *> edges;
-        House *house = nullptr;
+        DirectionSlots<HexCornerDirection, Hex, 3> hexes;
+        DirectionSlots<CornerEdgeDirection, Edge, 3> edges;
+        House house{};
 
     private:
         bool is_highlighted = false;
     };
 
     struct Edge {
-        std::unordered_map<HexEdgeDirection, Hex *> hexes;
-        std::unordered_map<CornerEdgeDirection, Corner *> corners;
-        Road *road = nullptr;
+        DirectionSlots<HexEdgeDirection, Hex, 2> hexes;
+        DirectionSlots<CornerEdgeDirection, Corner, 2> corners;
+        Road road{};
     };
 
-    struct MapBounds {
-        size_t radius;
+    // Single allocation holding every node of a map, laid out as [hexes][corners][edges] and indexed by the
+    // BoardTopology ids. Nodes are trivially copyable, so a whole board is released at once and copied with one
+    // memcpy followed by a pointer rebase.
+    class MapArena {
+        size_t m_hex_count = 0;
+        size_t m_corner_count = 0;
+        size_t m_edge_count = 0;
+        std::unique_ptr<std::byte[]> m_memory;
+
+        [[nodiscard]] auto get_corner_offset() const -> size_t;
+
+        [[nodiscard]] auto get_edge_offset() const -> size_t;
+
+        [[nodiscard]] auto get_size_in_bytes() const -> size_t;
+
+    public:
+        MapArena() = default;
+
+        MapArena(size_t hex_count, size_t corner_count, size_t edge_count);
+
+        [[nodiscard]] auto clone() const -> MapArena;
 
-        static MapBounds from_radius(size_t radius);
+        [[nodiscard]] auto get_hexes() const -> std::span<Hex> {
+            return {std::launder(reinterpret_cast<Hex *>(m_memory.get())), m_hex_count};
+        }
 
-        [[nodiscard]] bool is_within_bounds(const HexCoord2 &coord) const;
+        [[nodiscard]] auto get_corners() const -> std::span<Corner> {
+            return {std::launder(reinterpret_cast<Corner *>(m_memory.get() + get_corner_offset())), m_corner_count};
+        }
+
+        [[nodiscard]] auto get_edges() const -> std::span<Edge> {
+            return {std::launder(reinterpret_cast<Edge *>(m_memory.get() + get_edge_offset())), m_edge_count};
+        }
+
+        // Every node as raw bytes. Copying saved bytes back into the same arena restores the nodes as they were:
+        // the neighbour pointers point into this arena, so they stay valid without a rebase.
+        [[nodiscard]] auto get_bytes() const -> std::span<std::byte> { return {m_memory.get(), get_size_in_bytes()}; }
     };
 
     class Map {
-        const MapBounds map_bounds;
-        std::unordered_map<HexCoord2, Hex *> hexes;
-        std::unordered_map<CornerCoord, Corner *> corners;
-        std::unordered_map<EdgeCoord, Edge *> edges;
+        MapBounds map_bounds;
+        // Coordinate <-> node index lookup. It never changes after the build, so all maps of a shape share it.
+        std::shared_ptr<const BoardTopology> m_topology;
+        MapArena m_arena;
 
-        explicit Map(const MapBounds &map_bounds);
+        Map(const MapBounds &map_bounds, std::shared_ptr<const BoardTopology> topology, MapArena arena);
 
     public:
-        [[nodiscard]] CornerCoord get_normalized_corner_coord(const CornerCoord &raw_coord) const;
+        Map(const Map &) = delete;
 
+        Map(Map &&) = default;
 
-        [[nodiscard]] EdgeCoord get_normalized_edge_coord(const EdgeCoord &edge_coord) const;
+        auto operator=(const Map &) -> Map & = delete;
 
-        static Map build_map_of_size(size_t map_size);
+        auto operator=(Map &&) -> Map & = default;
 
-        [[nodiscard]] const std::unordered_map<HexCoord2, Hex *> &get_hexes() const;
+        // Canonical name of the corner, see coord_keys.hh. Does not depend on the board shape.
+        [[nodiscard]] CornerCoord get_normalized_corner_coord(const CornerCoord &raw_coord) const;
 
-        [[nodiscard]] const std::unordered_map<CornerCoord, Corner *> &get_corners() const;
+        // Canonical name of the edge, see coord_keys.hh. Does not depend on the board shape.
+        [[nodiscard]] EdgeCoord get_normalized_edge_coord(const EdgeCoord &edge_coord) const;
 
-        [[nodiscard]] const std::unordered_map<EdgeCoord, Edge *> &get_edges() const;
-    };
+        // Board with a fresh random seed.
+        static Map build_map_of_size(size_t map_size);
 
-    class MapCoords {
-        int m_size;
+        // Reproducible board dealt from the standard tile set.
+        static Map build_map_of_size(size_t map_size, std::uint64_t seed);
 
-    public:
-        explicit MapCoords(int size);
+        // Reproducible board dealt from `distribution`, in time linear in the number of hexes.
+        static Map build_map_of_size(size_t map_size, std::uint64_t seed, const TileDistribution &distribution);
 
-        class MapCoordsIterator {
-        public:
-            using iterator_category = std::input_iterator_tag;
-            using difference_type = std::ptrdiff_t;
-            using value_type = HexCoord2;
-            using pointer = const HexCoord2 *; // or also value_type*
-            using reference = const HexCoord2 &;
+        // Deep copy of the board. Costs one allocation and one memcpy of the node arena.
+        [[nodiscard]] auto clone() const -> Map;
 
-            explicit MapCoordsIterator(int size);
+        // Raw bytes of the node arena, see MapArena::get_bytes.
+        [[nodiscard]] auto get_node_bytes() const -> std::span<std::byte> { return m_arena.get_bytes(); }
 
-            MapCoordsIterator(int size, int r, int q);
+        [[nodiscard]] const MapBounds &get_bounds() const;
 
-            reference operator*() const;
+        [[nodiscard]] auto get_topology() const -> const BoardTopology &;
 
-            pointer operator->() const;
+        [[nodiscard]] auto get_shared_topology() const -> const std::shared_ptr<const BoardTopology> &;
 
-            MapCoordsIterator &operator++();
+        [[nodiscard]] auto get_hex(const HexId hex) const -> Hex * { return &m_arena.get_hexes()[hex]; }
 
-            MapCoordsIterator operator++(int);
+        [[nodiscard]] auto get_corner(const CornerId corner) const -> Corner * { return &m_arena.get_corners()[corner]; }
 
-            friend bool operator==(const MapCoordsIterator &a, const MapCoordsIterator &b);
+        [[nodiscard]] auto get_edge(const EdgeId edge) const -> Edge * { return &m_arena.get_edges()[edge]; }
 
-            friend bool operator!=(const MapCoordsIterator &a, const MapCoordsIterator &b);
+        [[nodiscard]] auto find_hex(const HexCoord2 &coord) const -> Hex *;
 
-        private:
-            int size;
-            int r;
-            int max_r;
-            int q;
-            int max_q;
-            HexCoord2 current_coord;
-        };
+        [[nodiscard]] auto find_corner(const CornerCoord &coord) const -> Corner *;
 
-        [[nodiscard]] MapCoordsIterator begin() const;
+        [[nodiscard]] auto find_edge(const EdgeCoord &coord) const -> Edge *;
 
-        [[nodiscard]] MapCoordsIterator end() const;
-    };
+        // (coordinate, node) pairs of every hex, without allocating.
+        [[nodiscard]] auto get_hexes() const {
+            return std::views::iota(HexId{0}, static_cast<HexId>(m_topology->get_hex_count())) |
+                   std::views::transform([this](const HexId hex) {
+                       return std::pair<const HexCoord2 &, Hex *>{m_topology->get_hex_coord(hex),
+                                                                  &m_arena.get_hexes()[hex]};
+                   });
+        }
 
-    bool operator==(const MapCoords::MapCoordsIterator &a, const MapCoords::MapCoordsIterator &b);
+        // (canonical coordinate, node) pairs of every corner, without allocating.
+        [[nodiscard]] auto get_corners() const {
+            return std::views::iota(CornerId{0}, static_cast<CornerId>(m_topology->get_corner_count())) |
+                   std::views::transform([this](const CornerId corner) {
+                       return std::pair<const CornerCoord &, Corner *>{m_topology->get_corner_coord(corner),
+                                                                       &m_arena.get_corners()[corner]};
+                   });
+        }
 
-    bool operator!=(const MapCoords::MapCoordsIterator &a, const MapCoords::MapCoordsIterator &b);
+        // (canonical coordinate, node) pairs of every edge, without allocating.
+        [[nodiscard]] auto get_edges() const {
+            return std::views::iota(EdgeId{0}, static_cast<EdgeId>(m_topology->get_edge_count())) |
+                   std::views::transform([this](const EdgeId edge) {
+                       return std::pair<const EdgeCoord &, Edge *>{m_topology->get_edge_coord(edge),
+                                                                   &m_arena.get_edges()[edge]};
+                   });
+        }
+    };
 } // namespace Map
@@ -0,0 +1,68 @@
+
+#pragma once
+#include <cstddef>
+#include <iterator>
+
+#include "coords.hh"
+
+namespace Map {
+    struct MapBounds {
+        size_t radius;
+
+        static constexpr MapBounds from_radius(const size_t radius) { return MapBounds{radius}; }
+
+        [[nodiscard]] constexpr bool is_within_bounds(const HexCoord2 &coord) const {
+            const auto abs = [](const int value) { return value < 0 ? -value : value; };
+            const int distance = (abs(coord.q) + abs(coord.q + coord.r) + abs(coord.r)) / 2;
+            return static_cast<size_t>(distance) <= radius;
+        }
+    };
+
+    class MapCoords {
+        int m_size;
+
+    public:
+        explicit MapCoords(int size);
+
+        class MapCoordsIterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = HexCoord2;
+            using pointer = const HexCoord2 *; // or also value_type*
+            using reference = const HexCoord2 &;
+
+            explicit MapCoordsIterator(int size);
+
+            MapCoordsIterator(int size, int r, int q);
+
+            reference operator*() const;
+
+            pointer operator->() const;
+
+            MapCoordsIterator &operator++();
+
+            MapCoordsIterator operator++(int);
+
+            friend bool operator==(const MapCoordsIterator &a, const MapCoordsIterator &b);
+
+            friend bool operator!=(const MapCoordsIterator &a, const MapCoordsIterator &b);
+
+        private:
+            int size;
+            int r;
+            int max_r;
+            int q;
+            int max_q;
+            HexCoord2 current_coord;
+        };
+
+        [[nodiscard]] MapCoordsIterator begin() const;
+
+        [[nodiscard]] MapCoordsIterator end() const;
+    };
+
+    bool operator==(const MapCoords::MapCoordsIterator &a, const MapCoords::MapCoordsIterator &b);
+
+    bool operator!=(const MapCoords::MapCoordsIterator &a, const MapCoords::MapCoordsIterator &b);
+} // namespace Map
@@ -0,0 +1,58 @@
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "board_state.hh"
+#include "board_topology.hh"
+#include "game.hh"
+#include "map.hh"
+#include "resource_bundle.hh"
+
+namespace Game {
+    // A house next to a numbered hex: when the number is rolled, `owner` gains `amount` of `resource`.
+    struct ProductionSlot {
+        Map::HexId hex;
+        Map::CornerId corner;
+        PlayerId owner;
+        std::uint8_t amount;
+        Map::Resource resource;
+    };
+
+    // The production slots of a board grouped by dice number, kept in step with the houses. Resolving a roll reads
+    // the slots of that number only, instead of scanning every hex for the ones that match.
+    class ProductionIndex {
+    public:
+        static constexpr int MAX_ROLL = 12;
+
+    private:
+        static constexpr std::uint32_t NO_SLOT = UINT32_MAX;
+
+        std::shared_ptr<const Map::BoardTopology> m_topology;
+        std::vector<std::int8_t> m_hex_numbers;
+        std::vector<Map::Resource> m_hex_resources;
+        std::array<std::vector<ProductionSlot>, MAX_ROLL + 1> m_slots;
+        // Position of each (corner, hex) pair in its slot list, in get_corner_hexes order, so a slot is found and
+        // removed in O(1).
+        std::vector<std::array<std::uint32_t, 3> > m_slot_positions;
+
+        void remove_slot(Map::CornerId corner, size_t corner_hex);
+
+    public:
+        // Indexes the tiles of `state` and the houses already on it.
+        ProductionIndex(std::shared_ptr<const Map::BoardTopology> topology, const Map::BoardState &state);
+
+        // Call whenever the house on `corner` changed; an empty house removes its slots.
+        void set_house(Map::CornerId corner, const House &house);
+
+        [[nodiscard]] auto get_slots(const int roll) const -> std::span<const ProductionSlot> { return m_slots[roll]; }
+
+        // Adds what every player gains from `roll` to `deltas`, indexed by player. The hex under `robber` does not
+        // produce.
+        void produce(int roll, Map::HexId robber, std::span<ResourceBundle> deltas) const;
+    };
+} // namespace Game
@@ -0,0 +1,126 @@
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "enum_map.hh"
+#include "map.hh"
+
+namespace Game {
+    struct ResourceAmount {
+        Map::Resource resource;
+        int amount;
+    };
+
+    // Resource counts of a hand, a cost or a delta, as eight int16 lanes indexed by Map::Resource. Lane 0 (NONE)
+    // and the two lanes past STONE stay zero. The whole bundle is 16 bytes, so every lane-wise operation below is
+    // a plain loop the compiler turns into one SIMD instruction, and comparing against a cost has no branches.
+    class ResourceBundle {
+    public:
+        static constexpr size_t LANES = 8;
+
+    private:
+        alignas(16) std::array<std::int16_t, LANES> m_lanes{};
+
+    public:
+        constexpr ResourceBundle() = default;
+
+        constexpr ResourceBundle(const std::initializer_list<ResourceAmount> amounts) {
+            for (const auto &[resource, amount]: amounts) {
+                m_lanes[static_cast<size_t>(resource)] += static_cast<std::int16_t>(amount);
+            }
+        }
+
+        [[nodiscard]] constexpr auto operator[](const Map::Resource resource) const -> int {
+            return m_lanes[static_cast<size_t>(resource)];
+        }
+
+        [[nodiscard]] constexpr auto operator[](const Map::Resource resource) -> std::int16_t & {
+            return m_lanes[static_cast<size_t>(resource)];
+        }
+
+        constexpr auto operator+=(const ResourceBundle &other) -> ResourceBundle & {
+            // Working on a copy tells the compiler the operands do not alias, so the loop becomes one vector op
+            std::array<std::int16_t, LANES> lanes = m_lanes;
+            for (size_t lane = 0; lane < LANES; lane++) {
+                lanes[lane] = static_cast<std::int16_t>(lanes[lane] + other.m_lanes[lane]);
+            }
+            m_lanes = lanes;
+            return *this;
+        }
+
+        constexpr auto operator-=(const ResourceBundle &other) -> ResourceBundle & {
+            std::array<std::int16_t, LANES> lanes = m_lanes;
+            for (size_t lane = 0; lane < LANES; lane++) {
+                lanes[lane] = static_cast<std::int16_t>(lanes[lane] - other.m_lanes[lane]);
+            }
+            m_lanes = lanes;
+            return *this;
+        }
+
+        [[nodiscard]] constexpr auto operator+(const ResourceBundle &other) const -> ResourceBundle {
+            ResourceBundle sum = *this;
+            return sum += other;
+        }
+
+        [[nodiscard]] constexpr auto operator-(const ResourceBundle &other) const -> ResourceBundle {
+            ResourceBundle difference = *this;
+            return difference -= other;
+        }
+
+        constexpr auto operator==(const ResourceBundle &other) const -> bool = default;
+
+        // Every lane holds at least as much as in `cost`. ORs the lane differences together: the sign bit of the
+        // result is set exactly when some lane falls short.
+        [[nodiscard]] constexpr auto covers(const ResourceBundle &cost) const -> bool {
+            std::int16_t shortfall = 0;
+            for (size_t lane = 0; lane < LANES; lane++) {
+                shortfall = static_cast<std::int16_t>(shortfall | (m_lanes[lane] - cost.m_lanes[lane]));
+            }
+            return shortfall >= 0;
+        }
+
+        [[nodiscard]] constexpr auto total() const -> int {
+            int sum = 0;
+            for (const std::int16_t lane: m_lanes) {
+                sum += lane;
+            }
+            return sum;
+        }
+
+        [[nodiscard]] constexpr auto is_empty() const -> bool { return *this == ResourceBundle{}; }
+    };
+
+    enum class Recipe : std::uint8_t { ROAD, SETTLEMENT, CITY, DEVELOPMENT_CARD, COUNT };
+
+    // One bit per Recipe, bit i for recipe i.
+    using RecipeMask = std::uint8_t;
+
+    constexpr RecipeMask recipe_bit(const Recipe recipe) { return static_cast<RecipeMask>(1u << static_cast<int>(recipe)); }
+
+    constexpr EnumMap<Recipe, ResourceBundle> RECIPES{
+        {Recipe::ROAD, {{Map::Resource::WOOD, 1}, {Map::Resource::BRICK, 1}}},
+        {
+            Recipe::SETTLEMENT,
+            {{Map::Resource::WOOD, 1}, {Map::Resource::BRICK, 1}, {Map::Resource::SHEEP, 1}, {Map::Resource::WHEAT, 1}},
+        },
+        {Recipe::CITY, {{Map::Resource::WHEAT, 2}, {Map::Resource::STONE, 3}}},
+        {Recipe::DEVELOPMENT_CARD, {{Map::Resource::SHEEP, 1}, {Map::Resource::WHEAT, 1}, {Map::Resource::STONE, 1}}},
+    };
+
+    constexpr const ResourceBundle &get_recipe(const Recipe recipe) { return RECIPES[recipe]; }
+
+    // What paying for `recipe` adds to a hand.
+    constexpr ResourceBundle cost_of(const Recipe recipe) { return ResourceBundle{} - get_recipe(recipe); }
+
+    // Every recipe `resources` can pay for, in one pass over the table.
+    constexpr RecipeMask get_affordable_recipes(const ResourceBundle &resources) {
+        RecipeMask mask = 0;
+        for (const auto &[recipe, cost]: RECIPES) {
+            mask |= static_cast<RecipeMask>(resources.covers(cost) ? recipe_bit(recipe) : 0);
+        }
+        return mask;
+    }
+} // namespace Game
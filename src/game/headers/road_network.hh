@@ -0,0 +1,111 @@
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board_topology.hh"
+#include "game.hh"
+
+namespace Game {
+    // Road networks of every player, for longest road. Roads of one player are connected when they meet at a
+    // corner without an opponent's house; connected roads are merged with union-find as they are built, and the
+    // longest trail of a network is re-measured only when that network grows.
+    //
+    // Union-find cannot split a set, so the rare cases that cut a network (an opponent's house built in the middle
+    // of it, or a road removed) rebuild that one player's networks. Every write is kept in a history, and rolling
+    // back to a mark undoes the writes since, newest first: taking a road back costs what building it did.
+    class RoadNetwork {
+        enum class Field : std::uint8_t {
+            ROAD_OWNER,
+            HOUSE_OWNER,
+            PARENT,
+            SIZE,
+            LENGTH,
+            LONGEST_ROAD,
+        };
+
+        // `value` was in `field` at `index` before the write
+        struct Change {
+            Field field;
+            std::uint32_t index;
+            std::uint32_t value;
+        };
+
+        std::shared_ptr<const Map::BoardTopology> m_topology;
+        std::vector<PlayerId> m_road_owners;
+        std::vector<PlayerId> m_house_owners;
+        // Union-find over edges; only the edges of built roads are meaningful. Union by size keeps the trees
+        // O(log n) deep, so lookups need no path compression, stay const, and a union is undone by two writes.
+        std::vector<Map::EdgeId> m_parents;
+        std::vector<std::uint32_t> m_sizes;
+        // Longest trail of the network, stored at its root
+        std::vector<std::uint32_t> m_lengths;
+        std::vector<std::uint32_t> m_longest_roads;
+        std::vector<Change> m_history;
+
+        // Scratch space of the traversals, kept to avoid allocating per road
+        std::vector<std::uint8_t> m_marks;
+        std::vector<Map::EdgeId> m_network;
+        std::vector<Map::CornerId> m_network_corners;
+
+        // Sets `values[index]`, recording the value it replaces.
+        template<typename T>
+        void write(std::vector<T> &values, Field field, std::uint32_t index, T value);
+
+        [[nodiscard]] auto find(Map::EdgeId edge) const -> Map::EdgeId;
+
+        void unite(Map::EdgeId a, Map::EdgeId b);
+
+        // A road of `player` may run through `corner`.
+        [[nodiscard]] auto is_passable(PlayerId player, Map::CornerId corner) const -> bool;
+
+        void unite_with_neighbours(Map::EdgeId edge);
+
+        // Collects the network of `edge` into m_network and its corners into m_network_corners.
+        void collect_network(Map::EdgeId edge);
+
+        [[nodiscard]] auto measure_trail(PlayerId player, Map::CornerId corner) -> std::uint32_t;
+
+        // Longest trail of the network of `edge`, by depth first search from each of its corners.
+        [[nodiscard]] auto measure_network(Map::EdgeId edge) -> std::uint32_t;
+
+        void rebuild(PlayerId player);
+
+    public:
+        RoadNetwork(std::shared_ptr<const Map::BoardTopology> topology, size_t player_count);
+
+        // Call whenever the road on `edge` changed; an empty road removes it.
+        void set_road(Map::EdgeId edge, const Road &road);
+
+        // Call whenever the house on `corner` changed.
+        void set_house(Map::CornerId corner, const House &house);
+
+        [[nodiscard]] auto get_history_mark() const -> size_t { return m_history.size(); }
+
+        // Puts everything back as it was when `mark` was taken, in time proportional to the writes since.
+        void rollback(size_t mark);
+
+        // Drops the history, when nothing before this point will be rolled back.
+        void clear_history() { m_history.clear(); }
+
+        // Representative road of the network `edge` belongs to. Two roads are connected when they have the same
+        // representative.
+        [[nodiscard]] auto get_network(const Map::EdgeId edge) const -> Map::EdgeId { return find(edge); }
+
+        [[nodiscard]] auto are_connected(const Map::EdgeId a, const Map::EdgeId b) const -> bool {
+            return find(a) == find(b);
+        }
+
+        // Longest trail through the network of the road on `edge`.
+        [[nodiscard]] auto get_network_length(const Map::EdgeId edge) const -> std::uint32_t {
+            return m_lengths[find(edge)];
+        }
+
+        // Longest trail over all the networks of the player.
+        [[nodiscard]] auto get_longest_road(const PlayerId player) const -> std::uint32_t {
+            return m_longest_roads[player];
+        }
+    };
+} // namespace Game
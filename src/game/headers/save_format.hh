@@ -0,0 +1,207 @@
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <vector>
+#include "game.hh"
+#include "game_sequence.hh"
+#include "game_state.hh"
+#include "map.hh"
+#include "resource_bundle.hh"
+
+namespace Game {
+    // Saved games. A save is one flat buffer: a fixed header, then one section of fixed size records per kind of
+    // node (tiles by hex, houses by corner, roads by edge) and one for the hands. Every field is little-endian and
+    // every record has alignment 1, so a save mapped straight from disk is read in place through a SaveView on any
+    // host, with nothing parsed up front and nothing copied to the heap.
+    //
+    // The header says where each section starts, so a later version can grow the header or add a section without
+    // moving the others. Saves of a newer version are refused rather than misread.
+    constexpr std::uint16_t SAVE_VERSION = 2;
+
+    // A T stored as little-endian bytes at any alignment. On little-endian hosts get and set compile to one load or
+    // store.
+    template<typename T>
+    struct LittleEndian {
+        static_assert(std::is_integral_v<T>);
+
+        std::array<std::uint8_t, sizeof(T)> bytes{};
+
+        [[nodiscard]] constexpr auto get() const -> T {
+            std::make_unsigned_t<T> value = 0;
+            for (size_t byte = 0; byte < sizeof(T); byte++) {
+                value |= static_cast<std::make_unsigned_t<T> >(std::make_unsigned_t<T>{bytes[byte]} << 8 * byte);
+            }
+            return static_cast<T>(value);
+        }
+
+        constexpr void set(const T value) {
+            const auto bits = static_cast<std::make_unsigned_t<T> >(value);
+            for (size_t byte = 0; byte < sizeof(T); byte++) {
+                bytes[byte] = static_cast<std::uint8_t>(bits >> 8 * byte);
+            }
+        }
+    };
+
+    struct SaveHeader {
+        static constexpr std::array<char, 4> MAGIC{'C', 'L', 'S', 'V'};
+
+        std::array<char, 4> magic = MAGIC;
+        LittleEndian<std::uint16_t> version;
+        // sizeof(SaveHeader) of the version that wrote it
+        LittleEndian<std::uint16_t> header_size;
+        LittleEndian<std::uint64_t> file_size;
+
+        LittleEndian<std::uint32_t> radius;
+        LittleEndian<std::uint32_t> hex_count;
+        LittleEndian<std::uint32_t> corner_count;
+        LittleEndian<std::uint32_t> edge_count;
+        std::uint8_t player_count = 0;
+
+        // Whose turn it is, in which phase
+        std::int8_t current_player = 0;
+        std::uint8_t phase = 0;
+        // NO_PLAYER when nobody holds longest road
+        std::int8_t longest_road_holder = NO_PLAYER;
+        // Map::NO_NODE when there is none
+        LittleEndian<std::uint32_t> robber;
+        LittleEndian<std::uint32_t> last_built_corner;
+
+        // The roll deck as RollManager holds it, and the state of the engine that shuffles it next
+        std::array<std::int8_t, RollManager::DECK_SIZE> rolls{};
+        std::uint8_t drawn = 0;
+        LittleEndian<std::uint64_t> roll_engine;
+
+        // Byte offsets of the sections from the start of the save
+        LittleEndian<std::uint64_t> tiles_offset;
+        LittleEndian<std::uint64_t> houses_offset;
+        LittleEndian<std::uint64_t> roads_offset;
+        LittleEndian<std::uint64_t> hands_offset;
+    };
+
+    struct SavedTile {
+        std::uint8_t resource = 0;
+        std::uint8_t number = 0;
+    };
+
+    struct SavedHouse {
+        std::int8_t owner = NO_PLAYER;
+        std::uint8_t level = 0;
+    };
+
+    struct SavedRoad {
+        std::int8_t owner = NO_PLAYER;
+    };
+
+    struct SavedHand {
+        // Indexed by Map::Resource; the NONE lane is always 0
+        std::array<LittleEndian<std::int16_t>, Map::RESOURCE_COUNT> counts{};
+    };
+
+    static_assert(alignof(SaveHeader) == 1 && alignof(SavedTile) == 1 && alignof(SavedHouse) == 1 &&
+                  alignof(SavedRoad) == 1 && alignof(SavedHand) == 1);
+
+    // The save of `state`: the board it is played on, the pieces, the hands, the roll deck and whose turn it is.
+    // The undo log is not saved.
+    [[nodiscard]] auto save_game(const GameState &state) -> std::vector<std::byte>;
+
+    // The save of the game `snapshot` was taken from. Only the tiles are read from `board`, which can be that
+    // game's map or a clone of it: tiles do not change during a game.
+    [[nodiscard]] auto save_game(const Map::Map &board, const GameStateSnapshot &snapshot) -> std::vector<std::byte>;
+
+    // Writes `bytes` next to `path`, flushes them to disk and then renames them over `path`, so a crash leaves
+    // either the previous save or the new one, never a torn file. Throws std::runtime_error on failure, leaving
+    // no temporary file behind.
+    void write_save_file(const std::filesystem::path &path, std::span<const std::byte> bytes);
+
+    // Writes save_game(state) to `path` with write_save_file.
+    void save_game(const GameState &state, const std::filesystem::path &path);
+
+    // Read-only view of a save, used in place. Opening one checks the header and that every section lies inside
+    // the buffer, in constant time whatever the size of the board; the records themselves are only read, and
+    // checked, by load_game_state. The view does not own the buffer, which has to outlive it.
+    class SaveView {
+        const SaveHeader *m_header = nullptr;
+        std::span<const SavedTile> m_tiles;
+        std::span<const SavedHouse> m_houses;
+        std::span<const SavedRoad> m_roads;
+        std::span<const SavedHand> m_hands;
+
+    public:
+        // Throws std::invalid_argument when `bytes` is not a save this version can read.
+        explicit SaveView(std::span<const std::byte> bytes);
+
+        [[nodiscard]] auto get_header() const -> const SaveHeader & { return *m_header; }
+
+        [[nodiscard]] auto get_radius() const -> size_t { return m_header->radius.get(); }
+
+        [[nodiscard]] auto get_player_count() const -> size_t { return m_header->player_count; }
+
+        [[nodiscard]] auto get_tiles() const -> std::span<const SavedTile> { return m_tiles; }
+
+        [[nodiscard]] auto get_houses() const -> std::span<const SavedHouse> { return m_houses; }
+
+        [[nodiscard]] auto get_roads() const -> std::span<const SavedRoad> { return m_roads; }
+
+        [[nodiscard]] auto get_resource(const Map::HexId hex) const -> Map::Resource {
+            return static_cast<Map::Resource>(m_tiles[hex].resource);
+        }
+
+        [[nodiscard]] auto get_number(const Map::HexId hex) const -> int { return m_tiles[hex].number; }
+
+        [[nodiscard]] auto get_house(const Map::CornerId corner) const -> House {
+            return House{.owner = m_houses[corner].owner, .level = m_houses[corner].level};
+        }
+
+        [[nodiscard]] auto get_road(const Map::EdgeId edge) const -> Road { return Road{m_roads[edge].owner}; }
+
+        [[nodiscard]] auto get_resources(PlayerId player) const -> ResourceBundle;
+
+        [[nodiscard]] auto get_robber() const -> Map::HexId { return m_header->robber.get(); }
+
+        [[nodiscard]] auto get_last_built_corner() const -> Map::CornerId {
+            return m_header->last_built_corner.get();
+        }
+
+        [[nodiscard]] auto get_current_player() const -> PlayerId { return m_header->current_player; }
+
+        [[nodiscard]] auto get_phase() const -> GamePhase { return static_cast<GamePhase>(m_header->phase); }
+
+        [[nodiscard]] auto get_longest_road_holder() const -> PlayerId { return m_header->longest_road_holder; }
+
+        [[nodiscard]] auto get_roll_manager() const -> RollManager;
+    };
+
+    // The board of a save, tiles dealt as they were. Throws std::invalid_argument for a tile out of range.
+    [[nodiscard]] auto load_map(const SaveView &save) -> Map::Map;
+
+    // A playable GameState equal to the one saved, hash included, with an empty undo log. Unlike opening the view
+    // this places every piece, so it takes time in the size of the board. Throws std::invalid_argument when the
+    // save holds a value out of range.
+    [[nodiscard]] auto load_game_state(const SaveView &save) -> GameState;
+
+    // A file mapped read-only into memory for as long as the object lives, to open a SaveView on without reading
+    // it. Throws std::runtime_error when the file cannot be opened or mapped.
+    class MappedFile {
+        const std::byte *m_data = nullptr;
+        size_t m_size = 0;
+        // Where mapping is unavailable the file is read into this instead
+        std::vector<std::byte> m_buffer;
+
+    public:
+        explicit MappedFile(const std::filesystem::path &path);
+
+        MappedFile(const MappedFile &) = delete;
+
+        auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+        ~MappedFile();
+
+        [[nodiscard]] auto get_bytes() const -> std::span<const std::byte> { return {m_data, m_size}; }
+    };
+} // namespace Game
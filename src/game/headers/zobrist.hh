@@ -0,0 +1,77 @@
+
+#pragma once
+#include <cstdint>
+
+#include "game.hh"
+#include "game_sequence.hh"
+#include "map.hh"
+
+namespace Game {
+    using ZobristHash = std::uint64_t;
+
+    // Zobrist keys of the features of a game state. The hash of a state is the XOR of the keys of everything in
+    // it, so a mutation updates the hash by XORing out the key of what was there and XORing in the key of what
+    // replaced it, whatever order the state was reached in.
+    //
+    // Instead of tables of random numbers sized for one board, every key is a splitmix64 finalizer over the
+    // feature packed into 64 bits: a few multiplies per key, the same keys for every board, and no tables to
+    // share between games and threads.
+    namespace Zobrist {
+        enum class Feature : std::uint64_t {
+            HOUSE = 1,
+            ROAD,
+            RESOURCE,
+            ROBBER,
+            TURN,
+            LONGEST_ROAD,
+        };
+
+        [[nodiscard]] constexpr auto mix(std::uint64_t z) -> ZobristHash {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // Feature in the top byte, then up to 56 bits of its parameters.
+        [[nodiscard]] constexpr auto get_key(const Feature feature, const std::uint64_t parameters) -> ZobristHash {
+            return mix(static_cast<std::uint64_t>(feature) << 56 ^ parameters * 0x9e3779b97f4a7c15ULL);
+        }
+
+        [[nodiscard]] constexpr auto pack(const PlayerId player, const std::uint64_t value) -> std::uint64_t {
+            return static_cast<std::uint64_t>(static_cast<std::uint8_t>(player)) << 40 | value;
+        }
+
+        // An empty corner or edge has key 0, so only built pieces take part in the hash.
+        [[nodiscard]] inline auto get_house_key(const Map::CornerId corner, const House &house) -> ZobristHash {
+            return house.is_built()
+                       ? get_key(Feature::HOUSE, pack(house.owner, std::uint64_t{house.level} << 32 | corner))
+                       : 0;
+        }
+
+        [[nodiscard]] inline auto get_road_key(const Map::EdgeId edge, const Road &road) -> ZobristHash {
+            return road.is_built() ? get_key(Feature::ROAD, pack(road.owner, edge)) : 0;
+        }
+
+        // Key of the player holding `count` cards of `resource`; holding none has key 0.
+        [[nodiscard]] constexpr auto get_resource_key(const PlayerId player, const Map::Resource resource,
+                                                      const int count) -> ZobristHash {
+            return count == 0
+                       ? 0
+                       : get_key(Feature::RESOURCE, pack(player, static_cast<std::uint64_t>(resource) << 32 |
+                                                                 static_cast<std::uint32_t>(count)));
+        }
+
+        [[nodiscard]] constexpr auto get_robber_key(const Map::HexId hex) -> ZobristHash {
+            return get_key(Feature::ROBBER, hex);
+        }
+
+        [[nodiscard]] constexpr auto get_turn_key(const PlayerId player, const GamePhase phase) -> ZobristHash {
+            return get_key(Feature::TURN, pack(player, static_cast<std::uint64_t>(phase)));
+        }
+
+        // Nobody holding longest road has key 0.
+        [[nodiscard]] constexpr auto get_longest_road_key(const PlayerId player) -> ZobristHash {
+            return player == NO_PLAYER ? 0 : get_key(Feature::LONGEST_ROAD, pack(player, 0));
+        }
+    } // namespace Zobrist
+} // namespace Game
@@ -0,0 +1,107 @@
+#include "headers/legal_moves.hh"
+#include <algorithm>
+
+namespace Game {
+    namespace {
+        auto get_other_end(const Map::BoardTopology &topology, const Map::EdgeId edge,
+                           const Map::CornerId corner) -> Map::CornerId {
+            const auto ends = topology.get_edge_corners(edge);
+            return ends[0] == corner ? ends[1] : ends[0];
+        }
+
+        auto has_road_at(const Map::BoardBitboards &pieces, const PlayerId player, const Map::CornerId corner) -> bool {
+            const auto &layout = pieces.get_topology().get_bitboard_layout();
+            return std::ranges::any_of(pieces.get_topology().get_corner_edges(corner), [&](const Map::EdgeId edge) {
+                return layout.contains(pieces.get_roads(player), edge);
+            });
+        }
+
+        // A road of `player` may continue through `corner`.
+        auto is_anchor(const Map::BoardBitboards &pieces, const PlayerId player, const Map::CornerId corner) -> bool {
+            const auto &layout = pieces.get_topology().get_bitboard_layout();
+            if (layout.contains(pieces.get_houses(), corner)) {
+                return layout.contains(pieces.get_settlements(player), corner) ||
+                       layout.contains(pieces.get_cities(player), corner);
+            }
+            return has_road_at(pieces, player, corner);
+        }
+
+        void assign(const Map::BitboardLayout &layout, Map::CornerBoard &board, const Map::CornerId corner,
+                    const bool value) {
+            value ? layout.insert(board, corner) : layout.erase(board, corner);
+        }
+
+        void assign(const Map::BitboardLayout &layout, Map::EdgeBoard &board, const Map::EdgeId edge,
+                    const bool value) {
+            value ? layout.insert(board, edge) : layout.erase(board, edge);
+        }
+    } // namespace
+
+    LegalMoves::LegalMoves(const Map::BoardBitboards &pieces) : m_free_corners(pieces.get_free_corners()) {
+        m_players.reserve(pieces.get_player_count());
+        for (PlayerId player = 0; player < static_cast<PlayerId>(pieces.get_player_count()); player++) {
+            m_players.push_back({pieces.get_legal_settlements(player), pieces.get_legal_roads(player)});
+        }
+    }
+
+    void LegalMoves::update_corner(const Map::BoardBitboards &pieces, const Map::CornerId corner) {
+        const auto &topology = pieces.get_topology();
+        const auto &layout = topology.get_bitboard_layout();
+        bool free = !layout.contains(pieces.get_houses(), corner);
+        for (const Map::EdgeId edge: topology.get_corner_edges(corner)) {
+            free = free && !layout.contains(pieces.get_houses(), get_other_end(topology, edge, corner));
+        }
+        assign(layout, m_free_corners, corner, free);
+        for (PlayerId player = 0; player < static_cast<PlayerId>(m_players.size()); player++) {
+            assign(layout, m_players[player].settlements, corner, free && has_road_at(pieces, player, corner));
+        }
+    }
+
+    void LegalMoves::update_edge(const Map::BoardBitboards &pieces, const Map::EdgeId edge) {
+        const auto &topology = pieces.get_topology();
+        const auto &layout = topology.get_bitboard_layout();
+        const bool empty = !layout.contains(pieces.get_roads(), edge);
+        const auto ends = topology.get_edge_corners(edge);
+        for (PlayerId player = 0; player < static_cast<PlayerId>(m_players.size()); player++) {
+            const bool legal = empty && (is_anchor(pieces, player, ends[0]) || is_anchor(pieces, player, ends[1]));
+            assign(layout, m_players[player].roads, edge, legal);
+        }
+    }
+
+    void LegalMoves::update_around_corner(const Map::BoardBitboards &pieces, const Map::CornerId corner) {
+        const auto &topology = pieces.get_topology();
+        // The house decides whether the corner and its neighbours are free, and whether roads pass through it
+        update_corner(pieces, corner);
+        for (const Map::EdgeId edge: topology.get_corner_edges(corner)) {
+            update_corner(pieces, get_other_end(topology, edge, corner));
+            update_edge(pieces, edge);
+        }
+    }
+
+    void LegalMoves::update_around_edge(const Map::BoardBitboards &pieces, const Map::EdgeId edge) {
+        const auto &topology = pieces.get_topology();
+        // The road reaches the corners at its ends and every edge leaving them, itself included
+        for (const Map::CornerId corner: topology.get_edge_corners(edge)) {
+            update_corner(pieces, corner);
+            for (const Map::EdgeId next: topology.get_corner_edges(corner)) {
+                update_edge(pieces, next);
+            }
+        }
+    }
+
+    auto LegalMoves::find_inconsistency(const Map::BoardBitboards &pieces) const -> std::optional<std::string> {
+        const LegalMoves expected{pieces};
+        if (m_free_corners != expected.m_free_corners) {
+            return "free corners differ";
+        }
+        for (size_t player = 0; player < m_players.size(); player++) {
+            if (m_players[player].settlements != expected.m_players[player].settlements) {
+                return "legal settlements of player " + std::to_string(player) + " differ";
+            }
+            if (m_players[player].roads != expected.m_players[player].roads) {
+                return "legal roads of player " + std::to_string(player) + " differ";
+            }
+        }
+        return std::nullopt;
+    }
+} // namespace Game
@@ -1,227 +1,160 @@
 
 #include "headers/map.hh"
-#include <algorithm>
+#include <cstring>
+#include <memory>
 #include <random>
-#include <unordered_map>
+#include <type_traits>
 #include <utility>
 
+#include "headers/board_generator.hh"
 #include "headers/coords.hh"
 
 namespace Map {
-    bool MapBounds::is_within_bounds(const HexCoord2 &coord) const {
-        const int distance = (std::abs(coord.q) + std::abs(coord.q + coord.r) + std::abs(coord.r)) / 2;
-        return distance <= radius;
-    }
-
-
-    MapBounds MapBounds::from_radius(std::size_t radius) {
-        return MapBounds{radius};
-    };
-
     CornerCoord Map::get_normalized_corner_coord(const CornerCoord &raw_coord) const {
-        HexCoord2 potential_coord;
-        HexCoord2 normalized_coord = raw_coord.hex_coord;
-        bool assigned = false;
-        HexCornerDirection normalized_corner_direction = raw_coord.corner_direction;
-#define ASSIGN_CORNER_COORD_IF_POSSIBLE(other_hex_coord, final_corner_direction)                                       \
-    potential_coord = raw_coord.hex_coord.get_neighbouring_hex_coord(other_hex_coord);                                 \
-    if (map_bounds.is_within_bounds(potential_coord)) {                                                                \
-        normalized_coord = potential_coord;                                                                            \
-        normalized_corner_direction = final_corner_direction;                                                          \
-        assigned = true;                                                                                               \
+        return canonical_corner_coord(raw_coord);
     }
 
-        switch (raw_coord.corner_direction) {
-            case HexCornerDirection::RIGHT:
-            case HexCornerDirection::BOTTOM_RIGHT:
-                break;
-            case HexCornerDirection::BOTTOM_LEFT:
-                // can be normalized as RIGHT of BOTTOM_LEFT hex
-                ASSIGN_CORNER_COORD_IF_POSSIBLE(HexEdgeDirection::BOTTOM_LEFT, HexCornerDirection::RIGHT);
-                break;
-            case HexCornerDirection::LEFT:
-                ASSIGN_CORNER_COORD_IF_POSSIBLE(HexEdgeDirection::TOP_LEFT, HexCornerDirection::BOTTOM_RIGHT);
-                break;
-            case HexCornerDirection::TOP_LEFT:
-                ASSIGN_CORNER_COORD_IF_POSSIBLE(HexEdgeDirection::TOP_LEFT, HexCornerDirection::RIGHT);
-                if (!assigned) {
-                    ASSIGN_CORNER_COORD_IF_POSSIBLE(HexEdgeDirection::TOP, HexCornerDirection::BOTTOM_LEFT);
-                }
-                break;
-            case HexCornerDirection::TOP_RIGHT:
-                ASSIGN_CORNER_COORD_IF_POSSIBLE(HexEdgeDirection::TOP, HexCornerDirection::BOTTOM_RIGHT);
-                if (!assigned) {
-                    ASSIGN_CORNER_COORD_IF_POSSIBLE(HexEdgeDirection::TOP_RIGHT, HexCornerDirection::LEFT);
-                }
-                break;
-        }
-#undef ASSIGN_CORNER_COORD_IF_POSSIBLE
-        return {.hex_coord = normalized_coord, .corner_direction = normalized_corner_direction};
-    };
-
     EdgeCoord Map::get_normalized_edge_coord(const EdgeCoord &raw_coord) const {
-        HexCoord2 potential_coord;
-        HexCoord2 normalized_coord = raw_coord.hex_coord;
-        HexEdgeDirection normalized_edge_direction = raw_coord.edge_direction;
-#define ASSIGN_EDGE_COORD_IF_POSSIBLE(other_hex_coord, final_edge_direction)                                           \
-    potential_coord = raw_coord.hex_coord.get_neighbouring_hex_coord(other_hex_coord);                                 \
-    if (map_bounds.is_within_bounds(potential_coord)) {                                                                \
-        normalized_coord = potential_coord;                                                                            \
-        normalized_edge_direction = final_edge_direction;                                                              \
+        return canonical_edge_coord(raw_coord);
     }
 
-        switch (raw_coord.edge_direction) {
-            case HexEdgeDirection::BOTTOM_RIGHT:
-            case HexEdgeDirection::BOTTOM:
-            case HexEdgeDirection::BOTTOM_LEFT:
-                break;
-            case HexEdgeDirection::TOP_LEFT:
-                ASSIGN_EDGE_COORD_IF_POSSIBLE(HexEdgeDirection::TOP_LEFT, HexEdgeDirection::BOTTOM_RIGHT);
-                break;
-            case HexEdgeDirection::TOP:
-                ASSIGN_EDGE_COORD_IF_POSSIBLE(HexEdgeDirection::TOP, HexEdgeDirection::BOTTOM);
-                break;
-            case HexEdgeDirection::TOP_RIGHT:
-                ASSIGN_EDGE_COORD_IF_POSSIBLE(HexEdgeDirection::TOP_RIGHT, HexEdgeDirection::BOTTOM_LEFT);
-        }
-#undef ASSIGN_EDGE_COORD
-        return {.hex_coord = normalized_coord, .edge_direction = normalized_edge_direction};
-    }
+    static_assert(std::is_trivially_copyable_v<Hex> && std::is_trivially_destructible_v<Hex>);
+    static_assert(std::is_trivially_copyable_v<Corner> && std::is_trivially_destructible_v<Corner>);
+    static_assert(std::is_trivially_copyable_v<Edge> && std::is_trivially_destructible_v<Edge>);
 
-    MapCoords::MapCoords(int size) : m_size(size) {
+    namespace {
+        constexpr auto align_up(const size_t offset, const size_t alignment) -> size_t {
+            return (offset + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    MapArena::MapArena(const size_t hex_count, const size_t corner_count,
+                       const size_t edge_count) : m_hex_count(hex_count), m_corner_count(corner_count),
+                                                  m_edge_count(edge_count),
+                                                  m_memory(std::make_unique_for_overwrite<std::byte[]>(
+                                                      get_size_in_bytes())) {
+        std::uninitialized_default_construct_n(reinterpret_cast<Hex *>(m_memory.get()), m_hex_count);
+        std::uninitialized_default_construct_n(reinterpret_cast<Corner *>(m_memory.get() + get_corner_offset()),
+                                               m_corner_count);
+        std::uninitialized_default_construct_n(reinterpret_cast<Edge *>(m_memory.get() + get_edge_offset()),
+                                               m_edge_count);
     }
 
-    MapCoords::MapCoordsIterator::MapCoordsIterator(int size) : size(size), r(-size), max_r(size),
-                                                                q(-size + abs(std::min(r, 0))),
-                                                                max_q(size - std::max(0, r)),
-                                                                current_coord{.q = q, .r = r} {
+    auto MapArena::get_corner_offset() const -> size_t {
+        return align_up(m_hex_count * sizeof(Hex), alignof(Corner));
     }
 
-    MapCoords::MapCoordsIterator::MapCoordsIterator(int size, int r, int q) : size(size), r(r), max_r(size), q(q),
-                                                                              max_q(size - std::max(0, r)),
-                                                                              current_coord{r, q} {
+    auto MapArena::get_edge_offset() const -> size_t {
+        return align_up(get_corner_offset() + m_corner_count * sizeof(Corner), alignof(Edge));
     }
 
-    MapCoords::MapCoordsIterator::reference MapCoords::MapCoordsIterator::operator*() const { return current_coord; }
-
-    MapCoords::MapCoordsIterator::pointer MapCoords::MapCoordsIterator::operator->() const { return &current_coord; }
-
-    MapCoords::MapCoordsIterator &MapCoords::MapCoordsIterator::operator++() {
-        if (q > max_q)
-            return *this;
-        q++;
-        if (q > max_q) {
-            if (r >= max_r) {
-                return *this;
-            }
-            r++;
-            q = -size + abs(std::min(r, 0));
-            max_q = size - std::max(0, r);
+    auto MapArena::get_size_in_bytes() const -> size_t { return get_edge_offset() + m_edge_count * sizeof(Edge); }
+
+    auto MapArena::clone() const -> MapArena {
+        MapArena copy;
+        copy.m_hex_count = m_hex_count;
+        copy.m_corner_count = m_corner_count;
+        copy.m_edge_count = m_edge_count;
+        copy.m_memory = std::make_unique_for_overwrite<std::byte[]>(get_size_in_bytes());
+        std::memcpy(copy.m_memory.get(), m_memory.get(), get_size_in_bytes());
+
+        const Hex *old_hexes = get_hexes().data();
+        const Corner *old_corners = get_corners().data();
+        const Edge *old_edges = get_edges().data();
+        Hex *new_hexes = copy.get_hexes().data();
+        Corner *new_corners = copy.get_corners().data();
+        Edge *new_edges = copy.get_edges().data();
+        for (Hex &hex: copy.get_hexes()) {
+            hex.corners.rebase(old_corners, new_corners);
+            hex.edges.rebase(old_edges, new_edges);
         }
-
-        current_coord.q = q;
-        current_coord.r = r;
-        return *this;
-    }
-
-    MapCoords::MapCoordsIterator MapCoords::MapCoordsIterator::operator++(int) {
-        MapCoordsIterator tmp{size, r, q};
-        current_coord.q = q;
-        current_coord.r = r;
-        ++(*this);
-        return tmp;
+        for (Corner &corner: copy.get_corners()) {
+            corner.hexes.rebase(old_hexes, new_hexes);
+            corner.edges.rebase(old_edges, new_edges);
+        }
+        for (Edge &edge: copy.get_edges()) {
+            edge.hexes.rebase(old_hexes, new_hexes);
+            edge.corners.rebase(old_corners, new_corners);
+        }
+        return copy;
     }
 
-    MapCoords::MapCoordsIterator MapCoords::begin() const { return MapCoordsIterator(m_size); }
-
-    MapCoords::MapCoordsIterator MapCoords::end() const { return {m_size, m_size, 1}; }
-
-    bool operator==(const MapCoords::MapCoordsIterator &a, const MapCoords::MapCoordsIterator &b) {
-        return a.q == b.q && a.r == b.r;
+    Map::Map(const MapBounds &map_bounds, std::shared_ptr<const BoardTopology> topology,
+             MapArena arena) : map_bounds(map_bounds), m_topology(std::move(topology)), m_arena(std::move(arena)) {
     }
 
-    bool operator!=(const MapCoords::MapCoordsIterator &a, const MapCoords::MapCoordsIterator &b) {
-        return a.q != b.q || a.r != b.r;
+    Map Map::build_map_of_size(const size_t map_size) {
+        return build_map_of_size(map_size, std::random_device{}());
     }
 
-    Map::Map(const MapBounds &map_bounds) : map_bounds(map_bounds) {
+    Map Map::build_map_of_size(const size_t map_size, const std::uint64_t seed) {
+        return build_map_of_size(map_size, seed, TileDistribution::standard());
     }
 
-    Map Map::build_map_of_size(size_t map_size) {
+    Map Map::build_map_of_size(const size_t map_size, const std::uint64_t seed,
+                               const TileDistribution &distribution) {
         const MapBounds map_bounds = MapBounds::from_radius(map_size);
-        std::vector numbers{2, 3, 3, 4, 4, 5, 5, 6, 6, 8, 8, 9, 9, 10, 10, 11, 11, 12};
-        std::vector resources{
-            Resource::WHEAT, Resource::WHEAT, Resource::WHEAT, Resource::WHEAT, Resource::WOOD,
-            Resource::WOOD, Resource::WOOD, Resource::WOOD, Resource::SHEEP, Resource::SHEEP,
-            Resource::SHEEP, Resource::SHEEP, Resource::BRICK, Resource::BRICK, Resource::BRICK,
-            Resource::STONE, Resource::STONE, Resource::STONE
-        };
-        const unsigned seed1 = std::chrono::system_clock::now().time_since_epoch().count();
-        auto rng = std::default_random_engine{seed1};
-        std::ranges::shuffle(numbers, rng);
-        std::ranges::shuffle(resources, rng);
-        std::vector<std::pair<Resource, int> > random_resources{};
-
-        random_resources.reserve(numbers.size());
-        for (int i = 0; i < numbers.size(); i++) {
-            random_resources.emplace_back(resources[i], numbers[i]);
-        }
-        random_resources.emplace_back(Resource::NONE, 7);
-        std::ranges::shuffle(random_resources, rng);
-        Map map{map_bounds};
-        auto random_resource_iterator = random_resources.begin();
-        for (const auto &coord: MapCoords(static_cast<int>(map_size))) {
-            auto hex = new Hex();
-            hex->resource = random_resource_iterator->first;
-            hex->number = random_resource_iterator->second;
-            ++random_resource_iterator;
-            map.hexes.insert(std::make_pair(coord, hex));
-
+        BoardGenerator generator{seed, distribution};
+        auto topology = BoardTopology::shared(map_bounds);
+        MapArena arena{topology->get_hex_count(), topology->get_corner_count(), topology->get_edge_count()};
+        const std::span<Hex> hexes = arena.get_hexes();
+        const std::span<Corner> corners = arena.get_corners();
+        const std::span<Edge> edges = arena.get_edges();
+
+        for (HexId hex_id = 0; hex_id < topology->get_hex_count(); hex_id++) {
+            Hex *hex = &hexes[hex_id];
+            const HexTile tile = generator.next_tile();
+            hex->resource = tile.resource;
+            hex->number = tile.number;
+
+            const auto hex_corners = topology->get_hex_corners(hex_id);
             for (const auto &corner_direction: HEX_CORNER_DIRECTIONS) {
-                auto raw_corner_coord = CornerCoord{coord, corner_direction};
-                CornerCoord normalized_corner_coord = map.get_normalized_corner_coord(raw_corner_coord);
-                Corner *corner;
-                if (auto map_find_result = map.corners.find(normalized_corner_coord);
-                    map_find_result != map.corners.end()) {
-                    corner = map_find_result->second;
-                } else {
-                    corner = new Corner();
-                    map.corners.insert(std::make_pair(normalized_corner_coord, corner));
-                }
-                hex->corners.insert(std::make_pair(corner_direction, corner));
-                corner->hexes.insert(std::make_pair(opposite_direction(corner_direction), hex));
+                Corner *corner = &corners[hex_corners[static_cast<int>(corner_direction)]];
+                hex->corners.set(corner_direction, corner);
+                corner->hexes.set(opposite_direction(corner_direction), hex);
             }
 
+            const auto hex_edges = topology->get_hex_edges(hex_id);
             for (const auto &edge_direction: HEX_EDGE_DIRECTIONS) {
-                auto raw_edge_coord = EdgeCoord{coord, edge_direction};
-                EdgeCoord normalized_edge_coord = map.get_normalized_edge_coord(raw_edge_coord);
-                Edge *edge;
-                if (auto map_find_result = map.edges.find(normalized_edge_coord); map_find_result != map.edges.end()) {
-                    edge = map_find_result->second;
-                } else {
-                    edge = new Edge();
-                    map.edges.insert(std::make_pair(normalized_edge_coord, edge));
-                    // map to neighboring corners:
-                    for (const auto &edge_to_corner_direction:
-                         EDGE_TO_CORNER_DIRECTION_MAPPING[static_cast<int>(edge_direction)]) {
-                        const auto corner_direction =
-                                edge_direction_to_corner_direction(edge_direction, edge_to_corner_direction);
-                        const CornerCoord &normalized_corner_coord =
-                                map.get_normalized_corner_coord({coord, corner_direction});
-                        auto corner_ptr = map.corners.find(normalized_corner_coord)->second;
-                        corner_ptr->edges.insert(std::make_pair(opposite_direction(edge_to_corner_direction), edge));
-                        edge->corners.insert(std::make_pair(edge_to_corner_direction, corner_ptr));
-                    }
+                Edge *edge = &edges[hex_edges[static_cast<int>(edge_direction)]];
+                // map to neighboring corners:
+                for (size_t end = 0; end < 2; end++) {
+                    const auto edge_to_corner_direction =
+                            EDGE_TO_CORNER_DIRECTION_MAPPING[static_cast<int>(edge_direction)][end];
+                    const auto corner_direction =
+                            EDGE_TO_HEX_CORNER_DIRECTION_MAPPING[static_cast<int>(edge_direction)][end];
+                    Corner *corner = hex->corners.get(corner_direction);
+                    corner->edges.set(opposite_direction(edge_to_corner_direction), edge);
+                    edge->corners.set(edge_to_corner_direction, corner);
                 }
-                hex->edges.insert(std::make_pair(edge_direction, edge));
-                edge->hexes.insert(std::make_pair(opposite_direction(edge_direction), hex));
+                hex->edges.set(edge_direction, edge);
+                edge->hexes.set(opposite_direction(edge_direction), hex);
             }
         }
 
-        return map;
+        return Map{map_bounds, std::move(topology), std::move(arena)};
+    }
+
+    auto Map::clone() const -> Map { return Map{map_bounds, m_topology, m_arena.clone()}; }
+
+    const MapBounds &Map::get_bounds() const { return map_bounds; }
+
+    auto Map::get_topology() const -> const BoardTopology & { return *m_topology; }
+
+    auto Map::get_shared_topology() const -> const std::shared_ptr<const BoardTopology> & { return m_topology; }
+
+    auto Map::find_hex(const HexCoord2 &coord) const -> Hex * {
+        const auto hex = m_topology->find_hex(coord);
+        return hex.has_value() ? &m_arena.get_hexes()[*hex] : nullptr;
+    }
+
+    auto Map::find_corner(const CornerCoord &coord) const -> Corner * {
+        const auto corner = m_topology->find_corner(coord);
+        return corner.has_value() ? &m_arena.get_corners()[*corner] : nullptr;
     }
 
-    const std::unordered_map<HexCoord2, Hex *> &Map::get_hexes() const { return hexes; }
-    const std::unordered_map<CornerCoord, Corner *> &Map::get_corners() const { return corners; }
-    const std::unordered_map<EdgeCoord, Edge *> &Map::get_edges() const { return edges; }
+    auto Map::find_edge(const EdgeCoord &coord) const -> Edge * {
+        const auto edge = m_topology->find_edge(coord);
+        return edge.has_value() ? &m_arena.get_edges()[*edge] : nullptr;
+    }
 } // namespace Map
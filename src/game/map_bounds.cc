@@ -0,0 +1,64 @@
+
+#include "headers/map_bounds.hh"
+#include <algorithm>
+#include <cstdlib>
+
+#include "headers/coords.hh"
+
+namespace Map {
+    MapCoords::MapCoords(int size) : m_size(size) {
+    }
+
+    MapCoords::MapCoordsIterator::MapCoordsIterator(int size) : size(size), r(-size), max_r(size),
+                                                                q(-size + abs(std::min(r, 0))),
+                                                                max_q(size - std::max(0, r)),
+                                                                current_coord{.q = q, .r = r} {
+    }
+
+    MapCoords::MapCoordsIterator::MapCoordsIterator(int size, int r, int q) : size(size), r(r), max_r(size), q(q),
+                                                                              max_q(size - std::max(0, r)),
+                                                                              current_coord{r, q} {
+    }
+
+    MapCoords::MapCoordsIterator::reference MapCoords::MapCoordsIterator::operator*() const { return current_coord; }
+
+    MapCoords::MapCoordsIterator::pointer MapCoords::MapCoordsIterator::operator->() const { return &current_coord; }
+
+    MapCoords::MapCoordsIterator &MapCoords::MapCoordsIterator::operator++() {
+        if (q > max_q)
+            return *this;
+        q++;
+        if (q > max_q) {
+            if (r >= max_r) {
+                return *this;
+            }
+            r++;
+            q = -size + abs(std::min(r, 0));
+            max_q = size - std::max(0, r);
+        }
+
+        current_coord.q = q;
+        current_coord.r = r;
+        return *this;
+    }
+
+    MapCoords::MapCoordsIterator MapCoords::MapCoordsIterator::operator++(int) {
+        MapCoordsIterator tmp{size, r, q};
+        current_coord.q = q;
+        current_coord.r = r;
+        ++(*this);
+        return tmp;
+    }
+
+    MapCoords::MapCoordsIterator MapCoords::begin() const { return MapCoordsIterator(m_size); }
+
+    MapCoords::MapCoordsIterator MapCoords::end() const { return {m_size, m_size, 1}; }
+
+    bool operator==(const MapCoords::MapCoordsIterator &a, const MapCoords::MapCoordsIterator &b) {
+        return a.q == b.q && a.r == b.r;
+    }
+
+    bool operator!=(const MapCoords::MapCoordsIterator &a, const MapCoords::MapCoordsIterator &b) {
+        return a.q != b.q || a.r != b.r;
+    }
+} // namespace Map
@@ -0,0 +1,76 @@
+#include "headers/production_index.hh"
+#include <utility>
+
+namespace Game {
+    ProductionIndex::ProductionIndex(std::shared_ptr<const Map::BoardTopology> topology,
+                                     const Map::BoardState &state)
+        : m_topology(std::move(topology)) {
+        const size_t hex_count = m_topology->get_hex_count();
+        m_hex_numbers.reserve(hex_count);
+        m_hex_resources.reserve(hex_count);
+        for (Map::HexId hex = 0; hex < hex_count; hex++) {
+            m_hex_numbers.push_back(static_cast<std::int8_t>(state.get_hex_number(hex)));
+            m_hex_resources.push_back(state.get_hex_resource(hex));
+        }
+        m_slot_positions.assign(m_topology->get_corner_count(), {NO_SLOT, NO_SLOT, NO_SLOT});
+        for (Map::CornerId corner = 0; corner < m_topology->get_corner_count(); corner++) {
+            if (state.get_house(corner).is_built()) {
+                set_house(corner, state.get_house(corner));
+            }
+        }
+    }
+
+    void ProductionIndex::remove_slot(const Map::CornerId corner, const size_t corner_hex) {
+        std::uint32_t &position = m_slot_positions[corner][corner_hex];
+        if (position == NO_SLOT) {
+            return;
+        }
+        const Map::HexId hex = m_topology->get_corner_hexes(corner)[corner_hex];
+        auto &slots = m_slots[m_hex_numbers[hex]];
+        // Swap with the last slot of the list and fix up the position of the one that moved
+        const ProductionSlot &last = slots.back();
+        const auto last_hexes = m_topology->get_corner_hexes(last.corner);
+        for (size_t i = 0; i < last_hexes.size(); i++) {
+            if (last_hexes[i] == last.hex) {
+                m_slot_positions[last.corner][i] = position;
+            }
+        }
+        slots[position] = last;
+        slots.pop_back();
+        position = NO_SLOT;
+    }
+
+    void ProductionIndex::set_house(const Map::CornerId corner, const House &house) {
+        const auto hexes = m_topology->get_corner_hexes(corner);
+        for (size_t corner_hex = 0; corner_hex < hexes.size(); corner_hex++) {
+            const Map::HexId hex = hexes[corner_hex];
+            const int number = m_hex_numbers[hex];
+            if (number < 2 || number > MAX_ROLL || m_hex_resources[hex] == Map::Resource::NONE) {
+                continue;
+            }
+            std::uint32_t &position = m_slot_positions[corner][corner_hex];
+            if (!house.is_built()) {
+                remove_slot(corner, corner_hex);
+                continue;
+            }
+            const ProductionSlot slot{hex, corner, house.owner, house.level, m_hex_resources[hex]};
+            if (position == NO_SLOT) {
+                position = static_cast<std::uint32_t>(m_slots[number].size());
+                m_slots[number].push_back(slot);
+            } else {
+                m_slots[number][position] = slot;
+            }
+        }
+    }
+
+    void ProductionIndex::produce(const int roll, const Map::HexId robber, const std::span<ResourceBundle> deltas) const {
+        if (roll < 0 || roll > MAX_ROLL) {
+            return;
+        }
+        for (const ProductionSlot &slot: m_slots[roll]) {
+            if (slot.hex != robber) {
+                deltas[slot.owner][slot.resource] += slot.amount;
+            }
+        }
+    }
+} // namespace Game
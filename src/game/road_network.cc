@@ -0,0 +1,217 @@
+#include "headers/road_network.hh"
+#include <algorithm>
+#include <utility>
+
+namespace Game {
+    namespace {
+        constexpr std::uint8_t IN_NETWORK = 1;
+        constexpr std::uint8_t ON_TRAIL = 2;
+
+        auto get_other_end(const Map::BoardTopology &topology, const Map::EdgeId edge,
+                           const Map::CornerId corner) -> Map::CornerId {
+            const auto ends = topology.get_edge_corners(edge);
+            return ends[0] == corner ? ends[1] : ends[0];
+        }
+    } // namespace
+
+    RoadNetwork::RoadNetwork(std::shared_ptr<const Map::BoardTopology> topology, const size_t player_count)
+        : m_topology(std::move(topology)), m_road_owners(m_topology->get_edge_count(), NO_PLAYER),
+          m_house_owners(m_topology->get_corner_count(), NO_PLAYER), m_parents(m_topology->get_edge_count()),
+          m_sizes(m_topology->get_edge_count(), 1), m_lengths(m_topology->get_edge_count(), 0),
+          m_longest_roads(player_count, 0), m_marks(m_topology->get_edge_count(), 0) {
+        for (Map::EdgeId edge = 0; edge < m_parents.size(); edge++) {
+            m_parents[edge] = edge;
+        }
+    }
+
+    template<typename T>
+    void RoadNetwork::write(std::vector<T> &values, const Field field, const std::uint32_t index, const T value) {
+        if (values[index] == value) {
+            return;
+        }
+        m_history.push_back({.field = field, .index = index, .value = static_cast<std::uint32_t>(values[index])});
+        values[index] = value;
+    }
+
+    auto RoadNetwork::find(Map::EdgeId edge) const -> Map::EdgeId {
+        while (m_parents[edge] != edge) {
+            edge = m_parents[edge];
+        }
+        return edge;
+    }
+
+    void RoadNetwork::unite(const Map::EdgeId a, const Map::EdgeId b) {
+        Map::EdgeId root_a = find(a);
+        Map::EdgeId root_b = find(b);
+        if (root_a == root_b) {
+            return;
+        }
+        if (m_sizes[root_a] < m_sizes[root_b]) {
+            std::swap(root_a, root_b);
+        }
+        write(m_parents, Field::PARENT, root_b, root_a);
+        write(m_sizes, Field::SIZE, root_a, m_sizes[root_a] + m_sizes[root_b]);
+    }
+
+    auto RoadNetwork::is_passable(const PlayerId player, const Map::CornerId corner) const -> bool {
+        return m_house_owners[corner] == NO_PLAYER || m_house_owners[corner] == player;
+    }
+
+    void RoadNetwork::unite_with_neighbours(const Map::EdgeId edge) {
+        const PlayerId player = m_road_owners[edge];
+        for (const Map::CornerId corner: m_topology->get_edge_corners(edge)) {
+            if (!is_passable(player, corner)) {
+                continue;
+            }
+            for (const Map::EdgeId next: m_topology->get_corner_edges(corner)) {
+                if (next != edge && m_road_owners[next] == player) {
+                    unite(edge, next);
+                }
+            }
+        }
+    }
+
+    void RoadNetwork::collect_network(const Map::EdgeId edge) {
+        const PlayerId player = m_road_owners[edge];
+        m_network.assign(1, edge);
+        m_network_corners.clear();
+        m_marks[edge] |= IN_NETWORK;
+        for (size_t next_index = 0; next_index < m_network.size(); next_index++) {
+            for (const Map::CornerId corner: m_topology->get_edge_corners(m_network[next_index])) {
+                if (std::ranges::find(m_network_corners, corner) == m_network_corners.end()) {
+                    m_network_corners.push_back(corner);
+                }
+                if (!is_passable(player, corner)) {
+                    continue;
+                }
+                for (const Map::EdgeId next: m_topology->get_corner_edges(corner)) {
+                    if (m_road_owners[next] == player && (m_marks[next] & IN_NETWORK) == 0) {
+                        m_marks[next] |= IN_NETWORK;
+                        m_network.push_back(next);
+                    }
+                }
+            }
+        }
+        for (const Map::EdgeId road: m_network) {
+            m_marks[road] &= ~IN_NETWORK;
+        }
+    }
+
+    auto RoadNetwork::measure_trail(const PlayerId player, const Map::CornerId corner) -> std::uint32_t {
+        std::uint32_t longest = 0;
+        for (const Map::EdgeId edge: m_topology->get_corner_edges(corner)) {
+            if (m_road_owners[edge] != player || (m_marks[edge] & ON_TRAIL) != 0) {
+                continue;
+            }
+            m_marks[edge] |= ON_TRAIL;
+            const Map::CornerId next = get_other_end(*m_topology, edge, corner);
+            // A trail may end at an opponent's house but not run through it
+            const std::uint32_t length = 1 + (is_passable(player, next) ? measure_trail(player, next) : 0);
+            m_marks[edge] &= ~ON_TRAIL;
+            longest = std::max(longest, length);
+        }
+        return longest;
+    }
+
+    auto RoadNetwork::measure_network(const Map::EdgeId edge) -> std::uint32_t {
+        const PlayerId player = m_road_owners[edge];
+        collect_network(edge);
+        std::uint32_t longest = 0;
+        for (const Map::CornerId corner: m_network_corners) {
+            longest = std::max(longest, measure_trail(player, corner));
+        }
+        return longest;
+    }
+
+    void RoadNetwork::rebuild(const PlayerId player) {
+        for (Map::EdgeId edge = 0; edge < m_road_owners.size(); edge++) {
+            if (m_road_owners[edge] == player) {
+                write(m_parents, Field::PARENT, edge, edge);
+                write(m_sizes, Field::SIZE, edge, std::uint32_t{1});
+            }
+        }
+        for (Map::EdgeId edge = 0; edge < m_road_owners.size(); edge++) {
+            if (m_road_owners[edge] == player) {
+                unite_with_neighbours(edge);
+            }
+        }
+        std::uint32_t longest_road = 0;
+        for (Map::EdgeId edge = 0; edge < m_road_owners.size(); edge++) {
+            if (m_road_owners[edge] == player && find(edge) == edge) {
+                write(m_lengths, Field::LENGTH, edge, measure_network(edge));
+                longest_road = std::max(longest_road, m_lengths[edge]);
+            }
+        }
+        write(m_longest_roads, Field::LONGEST_ROAD, static_cast<std::uint32_t>(player), longest_road);
+    }
+
+    void RoadNetwork::set_road(const Map::EdgeId edge, const Road &road) {
+        const PlayerId previous = m_road_owners[edge];
+        if (previous == road.owner) {
+            return;
+        }
+        write(m_road_owners, Field::ROAD_OWNER, edge, road.owner);
+        write(m_parents, Field::PARENT, edge, edge);
+        write(m_sizes, Field::SIZE, edge, std::uint32_t{1});
+        write(m_lengths, Field::LENGTH, edge, std::uint32_t{0});
+        if (previous != NO_PLAYER) {
+            // Removing a road may split its network
+            rebuild(previous);
+        }
+        if (!road.is_built()) {
+            return;
+        }
+        unite_with_neighbours(edge);
+        const Map::EdgeId root = find(edge);
+        // A network only ever grows here, so the player's longest road can only grow with it
+        write(m_lengths, Field::LENGTH, root, measure_network(edge));
+        write(m_longest_roads, Field::LONGEST_ROAD, static_cast<std::uint32_t>(road.owner),
+              std::max(m_longest_roads[road.owner], m_lengths[root]));
+    }
+
+    void RoadNetwork::set_house(const Map::CornerId corner, const House &house) {
+        const PlayerId previous = m_house_owners[corner];
+        const PlayerId owner = house.is_built() ? house.owner : NO_PLAYER;
+        if (previous == owner) {
+            return;
+        }
+        write(m_house_owners, Field::HOUSE_OWNER, corner, owner);
+        // Only players with two roads at the corner can have a network or a trail running through it
+        for (PlayerId player = 0; player < static_cast<PlayerId>(m_longest_roads.size()); player++) {
+            const auto roads = m_topology->get_corner_edges(corner);
+            const auto road_count = std::ranges::count_if(roads, [&](const Map::EdgeId edge) {
+                return m_road_owners[edge] == player;
+            });
+            if (road_count >= 2 && is_passable(player, corner) != (previous == NO_PLAYER || previous == player)) {
+                rebuild(player);
+            }
+        }
+    }
+
+    void RoadNetwork::rollback(const size_t mark) {
+        while (m_history.size() > mark) {
+            const Change change = m_history.back();
+            m_history.pop_back();
+            switch (change.field) {
+                case Field::ROAD_OWNER:
+                    m_road_owners[change.index] = static_cast<PlayerId>(change.value);
+                    break;
+                case Field::HOUSE_OWNER:
+                    m_house_owners[change.index] = static_cast<PlayerId>(change.value);
+                    break;
+                case Field::PARENT:
+                    m_parents[change.index] = change.value;
+                    break;
+                case Field::SIZE:
+                    m_sizes[change.index] = change.value;
+                    break;
+                case Field::LENGTH:
+                    m_lengths[change.index] = change.value;
+                    break;
+                case Field::LONGEST_ROAD:
+                    m_longest_roads[change.index] = change.value;
+                    break;
+            }
+        }
+    }
+} // namespace Game
@@ -0,0 +1,400 @@
+#include "save_format.hh"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Game {
+    namespace {
+        constexpr size_t MAX_PLAYERS = 8;
+        // Far beyond any board that fits in memory, and small enough that the node counts fit in 32 bits
+        constexpr size_t MAX_RADIUS = 4096;
+        // Sections start on 8 byte boundaries, for readers that copy them out in wider words
+        constexpr size_t SECTION_ALIGNMENT = 8;
+
+        // Whether the deck holds the 36 outcomes of two dice, each once: every value as often as two dice make it.
+        auto is_two_dice_deck(const std::array<std::int8_t, RollManager::DECK_SIZE> &rolls) -> bool {
+            std::array<int, 13> counts{};
+            for (const std::int8_t roll: rolls) {
+                if (roll < 2 || roll > 12) {
+                    return false;
+                }
+                counts[roll]++;
+            }
+            for (int value = 2; value <= 12; value++) {
+                if (counts[value] != 6 - std::abs(7 - value)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        auto get_hex_count(const std::uint64_t radius) -> std::uint64_t { return 3 * radius * (radius + 1) + 1; }
+
+        auto get_corner_count(const std::uint64_t radius) -> std::uint64_t { return 6 * (radius + 1) * (radius + 1); }
+
+        auto get_edge_count(const std::uint64_t radius) -> std::uint64_t {
+            return 9 * radius * radius + 15 * radius + 6;
+        }
+
+        auto align_section(const size_t offset) -> size_t {
+            return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        }
+
+        // The state of the engine as the standard text representation writes it, one number for minstd_rand.
+        auto get_engine_state(const std::minstd_rand &engine) -> std::uint64_t {
+            std::ostringstream text;
+            text << engine;
+            return std::stoull(text.str());
+        }
+
+        void set_engine_state(std::minstd_rand &engine, const std::uint64_t state) {
+            std::istringstream text(std::to_string(state));
+            text >> engine;
+        }
+
+        // Records of a section, after checking they lie inside the save.
+        template<typename Record>
+        auto get_section(const std::span<const std::byte> bytes, const SaveHeader &header,
+                         const LittleEndian<std::uint64_t> &offset, const std::uint64_t count)
+            -> std::span<const Record> {
+            const std::uint64_t start = offset.get();
+            if (start < header.header_size.get() || start > bytes.size() ||
+                count > (bytes.size() - start) / sizeof(Record)) {
+                throw std::invalid_argument("Saved game section out of bounds");
+            }
+            return {reinterpret_cast<const Record *>(bytes.data() + start), static_cast<size_t>(count)};
+        }
+
+        template<typename Record>
+        auto get_section(std::vector<std::byte> &bytes, const LittleEndian<std::uint64_t> &offset) -> Record * {
+            return reinterpret_cast<Record *>(bytes.data() + offset.get());
+        }
+
+        // The save of a GameState or of a GameStateSnapshot, which read the same. Pieces are read from the
+        // bitboards rather than the map, which a snapshot only holds as raw node memory.
+        template<typename Source>
+        auto write_save(const Map::Map &board, const Source &game) -> std::vector<std::byte> {
+            const auto &topology = board.get_topology();
+            const size_t hex_count = topology.get_hex_count();
+            const size_t corner_count = topology.get_corner_count();
+            const size_t edge_count = topology.get_edge_count();
+            const size_t player_count = game.get_player_count();
+
+            SaveHeader header;
+            header.version.set(SAVE_VERSION);
+            header.header_size.set(sizeof(SaveHeader));
+            header.radius.set(static_cast<std::uint32_t>(board.get_bounds().radius));
+            header.hex_count.set(static_cast<std::uint32_t>(hex_count));
+            header.corner_count.set(static_cast<std::uint32_t>(corner_count));
+            header.edge_count.set(static_cast<std::uint32_t>(edge_count));
+            header.player_count = static_cast<std::uint8_t>(player_count);
+            header.current_player = game.get_current_player();
+            header.phase = static_cast<std::uint8_t>(game.get_phase());
+            header.longest_road_holder = game.get_longest_road_holder();
+            header.robber.set(game.get_robber());
+            header.last_built_corner.set(game.get_last_built_corner());
+            const RollManager &deck = game.get_roll_manager();
+            header.rolls = deck.rolls;
+            header.drawn = deck.drawn;
+            header.roll_engine.set(get_engine_state(deck.random_engine));
+
+            size_t size = align_section(sizeof(SaveHeader));
+            header.tiles_offset.set(size);
+            size = align_section(size + hex_count * sizeof(SavedTile));
+            header.houses_offset.set(size);
+            size = align_section(size + corner_count * sizeof(SavedHouse));
+            header.roads_offset.set(size);
+            size = align_section(size + edge_count * sizeof(SavedRoad));
+            header.hands_offset.set(size);
+            size += player_count * sizeof(SavedHand);
+            header.file_size.set(size);
+
+            std::vector<std::byte> bytes(size);
+            std::memcpy(bytes.data(), &header, sizeof(SaveHeader));
+            auto *tiles = get_section<SavedTile>(bytes, header.tiles_offset);
+            for (Map::HexId hex = 0; hex < hex_count; hex++) {
+                tiles[hex] = SavedTile{
+                    .resource = static_cast<std::uint8_t>(board.get_hex(hex)->resource),
+                    .number = static_cast<std::uint8_t>(board.get_hex(hex)->number),
+                };
+            }
+            auto *houses = get_section<SavedHouse>(bytes, header.houses_offset);
+            auto *roads = get_section<SavedRoad>(bytes, header.roads_offset);
+            std::fill_n(houses, corner_count, SavedHouse{});
+            std::fill_n(roads, edge_count, SavedRoad{});
+            const Map::BoardBitboards &pieces = game.get_pieces();
+            const Map::BitboardLayout &layout = pieces.get_topology().get_bitboard_layout();
+            auto *hands = get_section<SavedHand>(bytes, header.hands_offset);
+            for (PlayerId player = 0; player < static_cast<PlayerId>(player_count); player++) {
+                layout.for_each_corner(pieces.get_settlements(player), [&](const std::uint32_t corner) {
+                    houses[corner] = SavedHouse{.owner = player, .level = 1};
+                });
+                layout.for_each_corner(pieces.get_cities(player), [&](const std::uint32_t corner) {
+                    houses[corner] = SavedHouse{.owner = player, .level = 2};
+                });
+                layout.for_each_edge(pieces.get_roads(player), [&](const std::uint32_t edge) {
+                    roads[edge] = SavedRoad{player};
+                });
+                for (const Map::Resource resource: Map::RESOURCES) {
+                    hands[player].counts[static_cast<size_t>(resource)].set(
+                        static_cast<std::int16_t>(game.get_resources(player)[resource]));
+                }
+            }
+            return bytes;
+        }
+    } // namespace
+
+    auto save_game(const GameState &state) -> std::vector<std::byte> { return write_save(state.get_map(), state); }
+
+    auto save_game(const Map::Map &board, const GameStateSnapshot &snapshot) -> std::vector<std::byte> {
+        return write_save(board, snapshot);
+    }
+
+    void save_game(const GameState &state, const std::filesystem::path &path) {
+        write_save_file(path, save_game(state));
+    }
+
+#ifdef _WIN32
+    void write_save_file(const std::filesystem::path &path, const std::span<const std::byte> bytes) {
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        try {
+            {
+                std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+                if (!file.flush()) {
+                    throw std::runtime_error("Could not write the saved game to " + temporary.string());
+                }
+            }
+            std::filesystem::rename(temporary, path);
+        } catch (...) {
+            std::error_code ignored;
+            std::filesystem::remove(temporary, ignored);
+            throw;
+        }
+    }
+#else
+    void write_save_file(const std::filesystem::path &path, const std::span<const std::byte> bytes) {
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        const int descriptor = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (descriptor < 0) {
+            throw std::runtime_error("Could not open " + temporary.string());
+        }
+        bool written_out = true;
+        for (size_t written = 0; written_out && written < bytes.size();) {
+            const ssize_t result = ::write(descriptor, bytes.data() + written, bytes.size() - written);
+            if (result >= 0) {
+                written += static_cast<size_t>(result);
+            } else {
+                written_out = errno == EINTR;
+            }
+        }
+        // On disk before it replaces the previous save, so a crash leaves one or the other whole. The descriptor
+        // is closed whatever happened before.
+        written_out = written_out && ::fsync(descriptor) == 0;
+        written_out = ::close(descriptor) == 0 && written_out;
+        std::error_code error;
+        if (written_out) {
+            std::filesystem::rename(temporary, path, error);
+        }
+        if (!written_out || error) {
+            ::unlink(temporary.c_str());
+            throw std::runtime_error("Could not write the saved game to " + path.string());
+        }
+
+        // The rename only survives a crash once the directory holding it is on disk too
+        const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : ".";
+        const int directory_descriptor = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (directory_descriptor < 0) {
+            throw std::runtime_error("Could not open " + directory.string());
+        }
+        const bool synced = ::fsync(directory_descriptor) == 0;
+        ::close(directory_descriptor);
+        if (!synced) {
+            throw std::runtime_error("Could not flush " + directory.string());
+        }
+    }
+#endif
+
+    SaveView::SaveView(const std::span<const std::byte> bytes) {
+        if (bytes.size() < SaveHeader::MAGIC.size() ||
+            std::memcmp(bytes.data(), SaveHeader::MAGIC.data(), SaveHeader::MAGIC.size()) != 0) {
+            throw std::invalid_argument("Not a saved game");
+        }
+        if (bytes.size() < sizeof(SaveHeader)) {
+            throw std::invalid_argument("Saved game is truncated");
+        }
+        m_header = reinterpret_cast<const SaveHeader *>(bytes.data());
+        const SaveHeader &header = *m_header;
+        if (header.version.get() != SAVE_VERSION) {
+            throw std::invalid_argument("Saved game of an unsupported version");
+        }
+        if (header.file_size.get() != bytes.size()) {
+            throw std::invalid_argument("Saved game is truncated");
+        }
+        const std::uint64_t radius = header.radius.get();
+        if (header.header_size.get() < sizeof(SaveHeader) || radius > MAX_RADIUS ||
+            header.hex_count.get() != get_hex_count(radius) || header.corner_count.get() != get_corner_count(radius) ||
+            header.edge_count.get() != get_edge_count(radius) || header.player_count == 0 ||
+            header.player_count > MAX_PLAYERS) {
+            throw std::invalid_argument("Saved game header out of range");
+        }
+        m_tiles = get_section<SavedTile>(bytes, header, header.tiles_offset, header.hex_count.get());
+        m_houses = get_section<SavedHouse>(bytes, header, header.houses_offset, header.corner_count.get());
+        m_roads = get_section<SavedRoad>(bytes, header, header.roads_offset, header.edge_count.get());
+        m_hands = get_section<SavedHand>(bytes, header, header.hands_offset, header.player_count);
+    }
+
+    auto SaveView::get_resources(const PlayerId player) const -> ResourceBundle {
+        ResourceBundle resources;
+        for (const Map::Resource resource: Map::RESOURCES) {
+            resources[resource] = m_hands[player].counts[static_cast<size_t>(resource)].get();
+        }
+        return resources;
+    }
+
+    auto SaveView::get_roll_manager() const -> RollManager {
+        RollManager deck;
+        deck.rolls = m_header->rolls;
+        deck.drawn = m_header->drawn;
+        set_engine_state(deck.random_engine, m_header->roll_engine.get());
+        return deck;
+    }
+
+    auto load_map(const SaveView &save) -> Map::Map {
+        Map::Map map = Map::Map::build_map_of_size(save.get_radius(), 0);
+        for (Map::HexId hex = 0; hex < save.get_tiles().size(); hex++) {
+            const SavedTile &tile = save.get_tiles()[hex];
+            if (tile.resource >= Map::RESOURCE_COUNT || tile.number > 12) {
+                throw std::invalid_argument("Saved tile out of range");
+            }
+            map.get_hex(hex)->resource = static_cast<Map::Resource>(tile.resource);
+            map.get_hex(hex)->number = tile.number;
+        }
+        return map;
+    }
+
+    auto load_game_state(const SaveView &save) -> GameState {
+        const SaveHeader &header = save.get_header();
+        const auto player_count = static_cast<PlayerId>(save.get_player_count());
+        if (header.current_player < 0 || header.current_player >= player_count ||
+            header.phase > static_cast<std::uint8_t>(GamePhase::STEAL) ||
+            header.longest_road_holder < NO_PLAYER || header.longest_road_holder >= player_count ||
+            header.drawn >= RollManager::DECK_SIZE ||
+            !is_two_dice_deck(header.rolls) ||
+            header.roll_engine.get() == 0 || header.roll_engine.get() >= std::minstd_rand::modulus) {
+            throw std::invalid_argument("Saved game header out of range");
+        }
+
+        GameState state(load_map(save), save.get_player_count(), 0);
+        state.set_turn(save.get_current_player(), save.get_phase());
+        state.set_longest_road_holder(save.get_longest_road_holder());
+        const auto &topology = state.get_map().get_topology();
+        if (const Map::HexId robber = save.get_robber(); robber != state.get_robber()) {
+            if (robber >= topology.get_hex_count()) {
+                throw std::invalid_argument("Saved robber out of range");
+            }
+            state.set_robber(robber);
+        }
+        for (PlayerId player = 0; player < player_count; player++) {
+            state.add_resources(player, save.get_resources(player) - state.get_resources(player));
+        }
+
+        // The last house built goes down last, so the setup road that follows it has its corner
+        const Map::CornerId last_built = save.get_last_built_corner();
+        if (last_built != Map::NO_NODE && (last_built >= topology.get_corner_count() ||
+                                           !save.get_house(last_built).is_built())) {
+            throw std::invalid_argument("Saved last built corner out of range");
+        }
+        for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+            const House house = save.get_house(corner);
+            if (!house.is_built() && house.owner == NO_PLAYER) {
+                continue;
+            }
+            if (house.owner < 0 || house.owner >= player_count || house.level == 0 || house.level > 2) {
+                throw std::invalid_argument("Saved house out of range");
+            }
+            if (corner != last_built) {
+                state.place_house(corner, house);
+            }
+        }
+        if (last_built != Map::NO_NODE) {
+            state.place_house(last_built, save.get_house(last_built));
+        }
+        for (Map::EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+            if (const Road road = save.get_road(edge); road.is_built()) {
+                if (road.owner < 0 || road.owner >= player_count) {
+                    throw std::invalid_argument("Saved road out of range");
+                }
+                state.place_road(edge, road);
+            }
+        }
+
+        state.set_roll_manager(save.get_roll_manager());
+        state.clear_undo_log();
+        return state;
+    }
+
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Could not open " + path.string());
+        }
+        const std::vector<char> chars{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        m_buffer.resize(chars.size());
+        std::memcpy(m_buffer.data(), chars.data(), chars.size());
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+
+    MappedFile::~MappedFile() = default;
+#else
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            throw std::runtime_error("Could not open " + path.string());
+        }
+        struct stat status{};
+        if (::fstat(descriptor, &status) != 0) {
+            ::close(descriptor);
+            throw std::runtime_error("Could not read the size of " + path.string());
+        }
+        m_size = static_cast<size_t>(status.st_size);
+        // An empty file cannot be mapped, and an empty view is all it needs
+        if (m_size > 0) {
+            void *data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (data == MAP_FAILED) {
+                ::close(descriptor);
+                throw std::runtime_error("Could not map " + path.string());
+            }
+            m_data = static_cast<const std::byte *>(data);
+        }
+        // The mapping keeps the file alive on its own
+        ::close(descriptor);
+    }
+
+    MappedFile::~MappedFile() {
+        if (m_data != nullptr) {
+            ::munmap(const_cast<std::byte *>(m_data), m_size);
+        }
+    }
+#endif
+} // namespace Game
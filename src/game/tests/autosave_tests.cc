@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "autosave.hh"
+#include "save_format.hh"
+#include "test_helpers.hh"
+
+namespace Game {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        auto get_saved_hash(const std::span<const std::byte> bytes) -> ZobristHash {
+            return load_game_state(SaveView{bytes}).get_hash();
+        }
+    } // namespace
+
+    // Test: The file on disk after the autosave catches up holds the last state saved
+    TEST(AutosaveTest, WritesTheLatestState) {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "cololite_autosave_test.clsv";
+        GameState state{Map::Map::build_map_of_size(3, 11), 4, 11};
+        std::mt19937_64 random{11};
+        {
+            Autosaver autosaver(state, path);
+            for (int save = 0; save < 20; save++) {
+                for (int move = 0; move < 10; move++) {
+                    play_random_move(state, random);
+                }
+                state.clear_undo_log();
+                EXPECT_TRUE(autosaver.save(state));
+            }
+            autosaver.wait();
+            EXPECT_GE(autosaver.get_written_count(), 1);
+            EXPECT_EQ(autosaver.get_written_count() + autosaver.get_superseded_count(), 20);
+            const MappedFile file(path);
+            EXPECT_EQ(get_saved_hash(file.get_bytes()), state.get_hash());
+        }
+        EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+        std::filesystem::remove(path);
+    }
+
+    // Test: While a save is stuck in a slow write, saving again costs the game thread well under 100us on the
+    // standard board at the 99th percentile, and never waits for the disk even at the worst; once the one waiting
+    // slot is taken, every save replaces the state in it
+    TEST(AutosaveTest, SavingDoesNotWaitForTheDisk) {
+        GameState state{Map::Map::build_map_of_size(2, 12), 4, 12};
+        std::mt19937_64 random{12};
+        std::promise<void> disk;
+        const std::shared_future<void> disk_done = disk.get_future().share();
+        std::atomic<int> writes_started{0};
+        std::vector<std::byte> last_write;
+        Autosaver autosaver(state, [&](const std::span<const std::byte> bytes) {
+            writes_started++;
+            disk_done.wait();
+            last_write.assign(bytes.begin(), bytes.end());
+        });
+
+        ASSERT_TRUE(autosaver.save(state));
+        while (writes_started == 0) {
+            std::this_thread::yield();
+        }
+        // Takes the free slot; every save after it finds the queue full
+        ASSERT_TRUE(autosaver.save(state));
+        ASSERT_EQ(autosaver.get_superseded_count(), 0);
+
+        constexpr int SAVES = 2000;
+        std::vector<double> costs;
+        costs.reserve(SAVES);
+        for (int save = 0; save < SAVES; save++) {
+            play_random_move(state, random);
+            state.clear_undo_log();
+            const auto start = Clock::now();
+            ASSERT_TRUE(autosaver.save(state));
+            costs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+        EXPECT_EQ(autosaver.get_written_count(), 0);
+        EXPECT_EQ(autosaver.get_superseded_count(), SAVES);
+        std::ranges::sort(costs);
+        EXPECT_LT(costs[SAVES * 99 / 100], 100.0);
+        // Room for the scheduler, far below a write to disk
+        EXPECT_LT(costs.back(), 2000.0);
+
+        disk.set_value();
+        autosaver.wait();
+        EXPECT_EQ(autosaver.get_written_count(), 2);
+        EXPECT_EQ(autosaver.get_superseded_count(), SAVES);
+        EXPECT_EQ(get_saved_hash(last_write), state.get_hash());
+    }
+
+    // Test: With room for a single snapshot, a save asked for while it is being written is dropped
+    TEST(AutosaveTest, SingleSlotDropsSavesWhileWriting) {
+        const GameState state{Map::Map::build_map_of_size(2, 13), 4, 13};
+        std::promise<void> disk;
+        const std::shared_future<void> disk_done = disk.get_future().share();
+        std::atomic<int> writes_started{0};
+        Autosaver autosaver(state, [&](std::span<const std::byte>) {
+            writes_started++;
+            disk_done.wait();
+        }, 1);
+
+        ASSERT_TRUE(autosaver.save(state));
+        while (writes_started == 0) {
+            std::this_thread::yield();
+        }
+        EXPECT_FALSE(autosaver.save(state));
+        disk.set_value();
+        autosaver.wait();
+        EXPECT_TRUE(autosaver.save(state));
+        autosaver.wait();
+        EXPECT_EQ(autosaver.get_written_count(), 2);
+        EXPECT_THROW(Autosaver(state, [](std::span<const std::byte>) {}, 0), std::invalid_argument);
+    }
+
+    // Test: An error writing a save comes out of the next wait, once, and later saves still go through
+    TEST(AutosaveTest, WriteErrorsReachTheGameThread) {
+        const GameState state{Map::Map::build_map_of_size(2, 14), 4, 14};
+        std::atomic<bool> fail{true};
+        Autosaver autosaver(state, [&](std::span<const std::byte>) {
+            if (fail) {
+                throw std::runtime_error("disk full");
+            }
+        });
+        autosaver.save(state);
+        EXPECT_THROW(autosaver.wait(), std::runtime_error);
+        EXPECT_NO_THROW(autosaver.wait());
+        fail = false;
+        autosaver.save(state);
+        autosaver.wait();
+        EXPECT_EQ(autosaver.get_written_count(), 1);
+    }
+} // namespace Game
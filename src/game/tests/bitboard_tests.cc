@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "board_bitboards.hh"
+#include "board_topology.hh"
+
+namespace Map {
+    namespace {
+        auto corners_of(const BitboardLayout &layout, const CornerBoard &board) -> std::vector<CornerId> {
+            std::vector<CornerId> corners;
+            layout.for_each_corner(board, [&](const CornerId corner) { corners.push_back(corner); });
+            std::ranges::sort(corners);
+            return corners;
+        }
+
+        auto edges_of(const BitboardLayout &layout, const EdgeBoard &board) -> std::vector<EdgeId> {
+            std::vector<EdgeId> edges;
+            layout.for_each_edge(board, [&](const EdgeId edge) { edges.push_back(edge); });
+            std::ranges::sort(edges);
+            return edges;
+        }
+
+        auto other_end(const BoardTopology &topology, const EdgeId edge, const CornerId corner) -> CornerId {
+            const auto ends = topology.get_edge_corners(edge);
+            return ends[0] == corner ? ends[1] : ends[0];
+        }
+
+        // The placement rules walked node by node over the topology
+        auto naive_free_corners(const BoardTopology &topology, const BoardState &state) -> std::vector<CornerId> {
+            std::vector<CornerId> free;
+            for (CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+                bool blocked = state.get_house(corner).is_built();
+                for (const EdgeId edge: topology.get_corner_edges(corner)) {
+                    blocked = blocked || state.get_house(other_end(topology, edge, corner)).is_built();
+                }
+                if (!blocked) {
+                    free.push_back(corner);
+                }
+            }
+            return free;
+        }
+
+        auto naive_legal_settlements(const BoardTopology &topology, const BoardState &state,
+                                     const PlayerId player) -> std::vector<CornerId> {
+            std::vector<CornerId> legal;
+            for (const CornerId corner: naive_free_corners(topology, state)) {
+                const auto edges = topology.get_corner_edges(corner);
+                if (std::ranges::any_of(edges, [&](const EdgeId edge) { return state.get_road(edge).owner == player; })) {
+                    legal.push_back(corner);
+                }
+            }
+            return legal;
+        }
+
+        auto naive_legal_roads(const BoardTopology &topology, const BoardState &state,
+                               const PlayerId player) -> std::vector<EdgeId> {
+            const auto is_anchor = [&](const CornerId corner, const EdgeId through) {
+                const House &house = state.get_house(corner);
+                if (house.is_built()) {
+                    return house.owner == player;
+                }
+                return std::ranges::any_of(topology.get_corner_edges(corner), [&](const EdgeId edge) {
+                    return edge != through && state.get_road(edge).owner == player;
+                });
+            };
+            std::vector<EdgeId> legal;
+            for (EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+                if (state.get_road(edge).is_built()) {
+                    continue;
+                }
+                const auto ends = topology.get_edge_corners(edge);
+                if (is_anchor(ends[0], edge) || is_anchor(ends[1], edge)) {
+                    legal.push_back(edge);
+                }
+            }
+            return legal;
+        }
+    } // namespace
+
+    // Test: Gathering by an offset moves every bit, across word boundaries and in both directions
+    TEST(BitboardTest, GatheredShiftsAcrossWords) {
+        std::mt19937_64 random{3};
+        for (const size_t bit_count: {1, 50, 64, 130, 300}) {
+            Bitboard board{bit_count};
+            for (size_t bit = 0; bit < bit_count; bit++) {
+                if (random() % 3 == 0) {
+                    board.set(bit);
+                }
+            }
+            for (const std::ptrdiff_t offset: {-129, -64, -9, -1, 0, 1, 8, 63, 64, 65, 200}) {
+                const Bitboard shifted = board.gathered(offset);
+                for (size_t bit = 0; bit < bit_count; bit++) {
+                    const std::ptrdiff_t source = static_cast<std::ptrdiff_t>(bit) + offset;
+                    const bool expected = source >= 0 && source < static_cast<std::ptrdiff_t>(bit_count) &&
+                                          board.test(static_cast<size_t>(source));
+                    ASSERT_EQ(shifted.test(bit), expected) << bit_count << " " << offset << " " << bit;
+                }
+                ASSERT_LE(shifted.count(), board.count());
+            }
+        }
+    }
+
+    // Test: A standard board needs one word per plane
+    TEST(BitboardTest, StandardBoardFitsInAWordPerPlane) {
+        const auto topology = BoardTopology::build(MapBounds::from_radius(2));
+        const auto &layout = topology.get_bitboard_layout();
+        EXPECT_LE(layout.get_plane_bits(), 64);
+        EXPECT_EQ(layout.get_corners().count(), 54);
+        EXPECT_EQ(layout.get_edges().count(), 72);
+    }
+
+    // Test: The shift based neighbour queries agree with the adjacency tables of the topology
+    TEST(BitboardTest, NeighbourQueriesMatchTopology) {
+        for (const size_t radius: {0, 2, 6}) {
+            const auto topology = BoardTopology::build(MapBounds::from_radius(radius));
+            const auto &layout = topology.get_bitboard_layout();
+            for (CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+                CornerBoard board = layout.make_corner_board();
+                layout.insert(board, corner);
+                ASSERT_TRUE(layout.contains(board, corner));
+
+                std::vector<EdgeId> edges(topology.get_corner_edges(corner).begin(),
+                                          topology.get_corner_edges(corner).end());
+                std::vector<CornerId> neighbours;
+                for (const EdgeId edge: edges) {
+                    neighbours.push_back(other_end(topology, edge, corner));
+                }
+                std::ranges::sort(edges);
+                std::ranges::sort(neighbours);
+                EXPECT_EQ(edges_of(layout, layout.get_corner_edges(board)), edges);
+                EXPECT_EQ(corners_of(layout, layout.get_neighbouring_corners(board)), neighbours);
+            }
+            for (EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+                EdgeBoard board = layout.make_edge_board();
+                layout.insert(board, edge);
+                std::vector<CornerId> ends(topology.get_edge_corners(edge).begin(),
+                                           topology.get_edge_corners(edge).end());
+                std::ranges::sort(ends);
+                EXPECT_EQ(corners_of(layout, layout.get_edge_ends(board)), ends);
+            }
+        }
+    }
+
+    // Test: Legal settlements and roads match a node by node walk over random positions
+    TEST(BitboardTest, LegalMovesMatchNaiveRules) {
+        constexpr size_t player_count = 4;
+        for (const size_t radius: {2, 5}) {
+            const auto topology = BoardTopology::shared(MapBounds::from_radius(radius));
+            const auto &layout = topology->get_bitboard_layout();
+            std::mt19937_64 random{radius};
+            for (int game = 0; game < 20; game++) {
+                BoardState state{*topology};
+                BoardBitboards bitboards{topology, player_count};
+                for (int move = 0; move < 40; move++) {
+                    const auto player = static_cast<PlayerId>(random() % player_count);
+                    if (random() % 3 == 0) {
+                        const auto corner = static_cast<CornerId>(random() % topology->get_corner_count());
+                        const House house{.owner = player, .level = static_cast<std::uint8_t>(1 + random() % 2)};
+                        state.set_house(corner, house);
+                        bitboards.set_house(corner, house);
+                    } else {
+                        const auto edge = static_cast<EdgeId>(random() % topology->get_edge_count());
+                        state.set_road(edge, Road{player});
+                        bitboards.set_road(edge, Road{player});
+                    }
+
+                    ASSERT_EQ(corners_of(layout, bitboards.get_free_corners()), naive_free_corners(*topology, state));
+                    for (PlayerId p = 0; p < static_cast<PlayerId>(player_count); p++) {
+                        ASSERT_EQ(corners_of(layout, bitboards.get_legal_settlements(p)),
+                                  naive_legal_settlements(*topology, state, p));
+                        ASSERT_EQ(edges_of(layout, bitboards.get_legal_roads(p)),
+                                  naive_legal_roads(*topology, state, p));
+                    }
+                }
+                const auto rebuilt = BoardBitboards::from_state(topology, state, player_count);
+                EXPECT_EQ(rebuilt.get_houses(), bitboards.get_houses());
+                EXPECT_EQ(rebuilt.get_roads(), bitboards.get_roads());
+            }
+        }
+    }
+
+    // Test: Upgrades are the player's settlements, and building a city moves the corner between the two boards
+    TEST(BitboardTest, UpgradesFollowSettlements) {
+        const auto topology = BoardTopology::shared(MapBounds::from_radius(2));
+        const auto &layout = topology->get_bitboard_layout();
+        BoardBitboards bitboards{topology, 2};
+        bitboards.set_house(10, House{.owner = 1, .level = 1});
+        EXPECT_TRUE(layout.contains(bitboards.get_legal_upgrades(1), 10));
+        EXPECT_FALSE(bitboards.get_legal_upgrades(0).any());
+
+        bitboards.set_house(10, House{.owner = 1, .level = 2});
+        EXPECT_FALSE(bitboards.get_legal_upgrades(1).any());
+        EXPECT_TRUE(layout.contains(bitboards.get_cities(1), 10));
+
+        const auto setup_roads = bitboards.get_legal_roads_from(10);
+        EXPECT_EQ(setup_roads.count(), topology->get_corner_edges(10).size());
+    }
+} // namespace Map
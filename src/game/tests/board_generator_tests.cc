@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <stdexcept>
+#include <vector>
+#include "board_generator.hh"
+#include "map.hh"
+
+namespace Map {
+    namespace {
+        auto deal(const std::uint64_t seed, const size_t count) -> std::vector<std::pair<Resource, int> > {
+            BoardGenerator generator{seed, TileDistribution::standard()};
+            std::vector<std::pair<Resource, int> > tiles;
+            for (size_t i = 0; i < count; i++) {
+                const HexTile tile = generator.next_tile();
+                tiles.emplace_back(tile.resource, tile.number);
+            }
+            return tiles;
+        }
+    } // namespace
+
+    // Test: The same seed deals the same tiles, another seed deals others
+    TEST(BoardGeneratorTest, SeedIsReproducible) {
+        EXPECT_EQ(deal(7, 200), deal(7, 200));
+        EXPECT_NE(deal(7, 200), deal(8, 200));
+    }
+
+    // Test: Every full deck holds exactly the standard tile set
+    TEST(BoardGeneratorTest, DecksKeepTheDistribution) {
+        const TileDistribution distribution = TileDistribution::standard();
+        const size_t deck_size = distribution.get_deck_size();
+        ASSERT_EQ(deck_size, 19);
+        const auto tiles = deal(3, deck_size * 4);
+        for (size_t deck = 0; deck < 4; deck++) {
+            std::map<Resource, int> resources;
+            std::map<int, int> numbers;
+            for (size_t i = deck * deck_size; i < (deck + 1) * deck_size; i++) {
+                resources[tiles[i].first]++;
+                numbers[tiles[i].second]++;
+                EXPECT_EQ(tiles[i].first == Resource::NONE, tiles[i].second == 7);
+            }
+            EXPECT_EQ(resources[Resource::WHEAT], 4);
+            EXPECT_EQ(resources[Resource::BRICK], 3);
+            EXPECT_EQ(resources[Resource::NONE], 1);
+            EXPECT_EQ(numbers[2], 1);
+            EXPECT_EQ(numbers[6], 2);
+            EXPECT_EQ(numbers[7], 1);
+        }
+    }
+
+    // Test: Inconsistent distributions are rejected
+    TEST(BoardGeneratorTest, InvalidDistributionThrows) {
+        EXPECT_THROW(BoardGenerator(1, TileDistribution{.resources = {}, .numbers = {}, .desert_count = 0}),
+                     std::invalid_argument);
+        EXPECT_THROW(BoardGenerator(1, TileDistribution{.resources = {Resource::WOOD}, .numbers = {}}),
+                     std::invalid_argument);
+    }
+
+    // Test: Seeded maps of any radius are reproducible and have no tile left unset
+    TEST(BoardGeneratorTest, SeededMapIsReproducible) {
+        const auto map = Map::build_map_of_size(12, 99);
+        const auto same = Map::build_map_of_size(12, 99);
+        for (const auto &[coord, hex]: map.get_hexes()) {
+            const Hex *other = same.find_hex(coord);
+            EXPECT_EQ(hex->resource, other->resource);
+            EXPECT_EQ(hex->number, other->number);
+            EXPECT_GE(hex->number, 2);
+            EXPECT_LE(hex->number, 12);
+        }
+    }
+
+    // Test: Custom distributions are honoured
+    TEST(BoardGeneratorTest, CustomDistribution) {
+        const TileDistribution all_wood{.resources = {Resource::WOOD}, .numbers = {5}, .desert_count = 0};
+        const auto map = Map::build_map_of_size(3, 1, all_wood);
+        for (const Hex *hex: map.get_hexes() | std::views::values) {
+            EXPECT_EQ(hex->resource, Resource::WOOD);
+            EXPECT_EQ(hex->number, 5);
+        }
+    }
+} // namespace Map
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "board_topology.hh"
+#include "flat_map.hh"
+#include "map.hh"
+
+namespace Map {
+    // Test: Node counts follow the closed forms for a hexagonal board
+    TEST(BoardTopologyTest, NodeCountsMatchRadius) {
+        for (size_t radius = 0; radius <= 6; radius++) {
+            const auto topology = BoardTopology::build(MapBounds::from_radius(radius));
+            const size_t r = radius;
+            EXPECT_EQ(topology.get_hex_count(), 3 * r * r + 3 * r + 1);
+            EXPECT_EQ(topology.get_corner_count(), 6 * (r + 1) * (r + 1));
+            EXPECT_EQ(topology.get_edge_count(), 3 * (r + 1) * (3 * r + 2));
+        }
+    }
+
+    // Test: Standard board has 19 hexes, 54 corners and 72 edges
+    TEST(BoardTopologyTest, StandardBoard) {
+        const auto topology = BoardTopology::build(MapBounds::from_radius(2));
+        EXPECT_EQ(topology.get_hex_count(), 19);
+        EXPECT_EQ(topology.get_corner_count(), 54);
+        EXPECT_EQ(topology.get_edge_count(), 72);
+    }
+
+    // Test: Every hex -> corner link has the matching corner -> hex link
+    TEST(BoardTopologyTest, HexCornerAdjacencyIsSymmetric) {
+        const auto topology = BoardTopology::build(MapBounds::from_radius(3));
+        for (HexId hex = 0; hex < topology.get_hex_count(); hex++) {
+            const auto corners = topology.get_hex_corners(hex);
+            ASSERT_EQ(corners.size(), 6);
+            for (const CornerId corner: corners) {
+                const auto hexes = topology.get_corner_hexes(corner);
+                EXPECT_NE(std::ranges::find(hexes, hex), hexes.end());
+            }
+        }
+        for (CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+            const auto hexes = topology.get_corner_hexes(corner);
+            EXPECT_GE(hexes.size(), 1);
+            EXPECT_LE(hexes.size(), 3);
+        }
+    }
+
+    // Test: Every edge joins two distinct corners which both list the edge
+    TEST(BoardTopologyTest, EdgeCornerAdjacencyIsSymmetric) {
+        const auto topology = BoardTopology::build(MapBounds::from_radius(3));
+        for (EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+            const auto corners = topology.get_edge_corners(edge);
+            ASSERT_EQ(corners.size(), 2);
+            EXPECT_NE(corners[0], corners[1]);
+            for (const CornerId corner: corners) {
+                const auto edges = topology.get_corner_edges(corner);
+                EXPECT_NE(std::ranges::find(edges, edge), edges.end());
+            }
+        }
+        for (CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+            const auto edges = topology.get_corner_edges(corner);
+            EXPECT_GE(edges.size(), 2);
+            EXPECT_LE(edges.size(), 3);
+        }
+    }
+
+    // Test: Shared corners and edges resolve to the same id from either hex
+    TEST(BoardTopologyTest, FindAcceptsAnyNamingOfANode) {
+        const auto topology = BoardTopology::build(MapBounds::from_radius(2));
+        const HexCoord2 center{0, 0};
+        const HexCoord2 top = center.get_neighbouring_hex_coord(HexEdgeDirection::TOP);
+
+        EXPECT_EQ(topology.find_corner({center, HexCornerDirection::TOP_RIGHT}),
+                  topology.find_corner({top, HexCornerDirection::BOTTOM_RIGHT}));
+        EXPECT_EQ(topology.find_edge({center, HexEdgeDirection::TOP}),
+                  topology.find_edge({top, HexEdgeDirection::BOTTOM}));
+        EXPECT_FALSE(topology.find_hex({5, 5}).has_value());
+    }
+
+    // Test: Every corner and edge is found again through its packed key
+    TEST(BoardTopologyTest, KeysRoundTrip) {
+        const auto topology = BoardTopology::build(MapBounds::from_radius(4));
+        for (CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+            EXPECT_EQ(topology.find_corner(topology.get_corner_key(corner)), corner);
+        }
+        for (EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+            EXPECT_EQ(topology.find_edge(topology.get_edge_key(edge)), edge);
+        }
+        // Canonical names of outer corners may sit on a hex just off the board
+        EXPECT_TRUE(topology.find_corner(CornerCoord{{0, -4}, HexCornerDirection::TOP_RIGHT}).has_value());
+        EXPECT_FALSE(topology.find_corner(CornerCoord{{0, -6}, HexCornerDirection::RIGHT}).has_value());
+        EXPECT_FALSE(topology.find_edge(EdgeCoord{{0, -5}, HexEdgeDirection::BOTTOM_RIGHT}).has_value());
+    }
+
+    // Test: The flat mode agrees with the pointer based map
+    TEST(BoardTopologyTest, FlatMapMatchesMap) {
+        const auto map = Map::build_map_of_size(2);
+        const auto flat_map = FlatMap::from_map(map);
+        const auto &topology = flat_map.get_topology();
+
+        EXPECT_EQ(topology.get_hex_count(), map.get_hexes().size());
+        EXPECT_EQ(topology.get_corner_count(), map.get_corners().size());
+        EXPECT_EQ(topology.get_edge_count(), map.get_edges().size());
+        for (const auto &[coord, hex]: map.get_hexes()) {
+            const HexId hex_id = *topology.find_hex(coord);
+            EXPECT_EQ(flat_map.get_hex_resource(hex_id), hex->resource);
+            EXPECT_EQ(flat_map.get_hex_number(hex_id), hex->number);
+        }
+    }
+
+    // Test: Boards of the same shape share one topology
+    TEST(BoardTopologyTest, TopologyIsSharedPerShape) {
+        const auto topology = BoardTopology::shared(MapBounds::from_radius(2));
+        EXPECT_EQ(BoardTopology::shared(MapBounds::from_radius(2)), topology);
+        EXPECT_NE(BoardTopology::shared(MapBounds::from_radius(3)), topology);
+
+        const auto map = Map::build_map_of_size(2, 5);
+        const auto flat_map = FlatMap::generate(2, 5);
+        EXPECT_EQ(map.get_shared_topology(), topology);
+        EXPECT_EQ(flat_map.get_shared_topology(), topology);
+    }
+
+    // Test: A generated flat map deals the same tiles as the Map of the same seed
+    TEST(BoardTopologyTest, GeneratedFlatMapMatchesMap) {
+        const auto map = Map::build_map_of_size(4, 11);
+        const auto flat_map = FlatMap::generate(4, 11);
+        for (HexId hex = 0; hex < flat_map.get_topology().get_hex_count(); hex++) {
+            EXPECT_EQ(flat_map.get_hex_resource(hex), map.get_hex(hex)->resource);
+            EXPECT_EQ(flat_map.get_hex_number(hex), map.get_hex(hex)->number);
+        }
+        ASSERT_NE(flat_map.get_state().get_robber(), NO_NODE);
+        EXPECT_EQ(flat_map.get_hex_resource(flat_map.get_state().get_robber()), Resource::NONE);
+    }
+
+    // Test: The per game state of a standard board fits in a few hundred bytes and copies independently
+    TEST(BoardTopologyTest, PerGameStateIsSmall) {
+        const auto flat_map = FlatMap::generate(2, 1);
+        EXPECT_LE(flat_map.get_state().get_memory_usage(), 512);
+
+        FlatMap game = flat_map;
+        game.set_house(3, House{.owner = 0, .level = 1});
+        EXPECT_TRUE(game.get_house(3).is_built());
+        EXPECT_FALSE(flat_map.get_house(3).is_built());
+    }
+} // namespace Map
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "coord_keys.hh"
+#include "coords.hh"
+#include "map_bounds.hh"
+
+namespace Map {
+    namespace {
+        // Number of distinct corner keys among all the namings of the corners of an on-board hex.
+        template<size_t radius>
+        constexpr auto count_corners() -> size_t {
+            constexpr size_t hex_count = 3 * radius * radius + 3 * radius + 1;
+            std::array<CornerKey, 6 * hex_count> keys{};
+            size_t size = 0;
+            const MapBounds bounds = MapBounds::from_radius(radius);
+            for (int q = -static_cast<int>(radius); q <= static_cast<int>(radius); q++) {
+                for (int r = -static_cast<int>(radius); r <= static_cast<int>(radius); r++) {
+                    if (!bounds.is_within_bounds({q, r})) {
+                        continue;
+                    }
+                    for (const auto corner_direction: HEX_CORNER_DIRECTIONS) {
+                        keys[size++] = encode_corner({{q, r}, corner_direction});
+                    }
+                }
+            }
+            std::sort(keys.begin(), keys.end());
+            return static_cast<size_t>(std::unique(keys.begin(), keys.end()) - keys.begin());
+        }
+
+        template<size_t radius>
+        constexpr auto count_edges() -> size_t {
+            constexpr size_t hex_count = 3 * radius * radius + 3 * radius + 1;
+            std::array<EdgeKey, 6 * hex_count> keys{};
+            size_t size = 0;
+            const MapBounds bounds = MapBounds::from_radius(radius);
+            for (int q = -static_cast<int>(radius); q <= static_cast<int>(radius); q++) {
+                for (int r = -static_cast<int>(radius); r <= static_cast<int>(radius); r++) {
+                    if (!bounds.is_within_bounds({q, r})) {
+                        continue;
+                    }
+                    for (const auto edge_direction: HEX_EDGE_DIRECTIONS) {
+                        keys[size++] = encode_edge({{q, r}, edge_direction});
+                    }
+                }
+            }
+            std::sort(keys.begin(), keys.end());
+            return static_cast<size_t>(std::unique(keys.begin(), keys.end()) - keys.begin());
+        }
+
+        // Every end of every hex edge is a corner that lists the edge among its own edges.
+        constexpr auto edge_ends_are_consistent() -> bool {
+            for (const auto edge_direction: HEX_EDGE_DIRECTIONS) {
+                const int edge = static_cast<int>(edge_direction);
+                for (size_t end = 0; end < 2; end++) {
+                    const auto corner = EDGE_TO_HEX_CORNER_DIRECTION_MAPPING[edge][end];
+                    const auto towards_edge = opposite_direction(EDGE_TO_CORNER_DIRECTION_MAPPING[edge][end]);
+                    bool found = false;
+                    for (const auto corner_edge: CORNER_TO_EDGE_DIRECTION_MAPPING[static_cast<int>(corner)]) {
+                        found |= corner_edge == towards_edge;
+                    }
+                    if (!found) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    // The direction tables, coordinate math and keys are constexpr, so the topology is pinned at compile time.
+    static_assert(opposite_direction(opposite_direction(HexEdgeDirection::TOP_LEFT)) == HexEdgeDirection::TOP_LEFT);
+    static_assert(opposite_direction(HexCornerDirection::RIGHT) == HexCornerDirection::LEFT);
+    static_assert(opposite_direction(CornerEdgeDirection::BOTTOM_RIGHT) == CornerEdgeDirection::TOP_LEFT);
+
+    static_assert(HexCoord2{0, 0}.get_neighbouring_hex_coord(HexEdgeDirection::TOP) == HexCoord2{0, -1});
+    static_assert(HexCoord2{2, -1}.get_neighbouring_hex_coord(HexEdgeDirection::BOTTOM_LEFT) == HexCoord2{1, 0});
+    static_assert([] {
+        for (const auto direction: HEX_EDGE_DIRECTIONS) {
+            const HexCoord2 there = HexCoord2{3, -2}.get_neighbouring_hex_coord(direction);
+            if (there.get_neighbouring_hex_coord(opposite_direction(direction)) != HexCoord2{3, -2}) {
+                return false;
+            }
+        }
+        return true;
+    }());
+
+    static_assert(edge_direction_to_corner_direction(HexEdgeDirection::BOTTOM_RIGHT,
+                                                     CornerEdgeDirection::TOP_RIGHT) == HexCornerDirection::RIGHT);
+    static_assert(edge_direction_to_corner_direction(HexEdgeDirection::TOP, CornerEdgeDirection::LEFT) ==
+                  HexCornerDirection::TOP_LEFT);
+    static_assert(EDGE_TO_HEX_CORNER_DIRECTION_MAPPING[static_cast<int>(HexEdgeDirection::TOP_RIGHT)][0] ==
+                  HexCornerDirection::RIGHT);
+    static_assert(edge_ends_are_consistent());
+
+    // Every naming of a node encodes to the same key, and keys decode to the canonical naming.
+    static_assert(encode_corner({{0, 0}, HexCornerDirection::TOP_RIGHT}) ==
+                  encode_corner({{0, -1}, HexCornerDirection::BOTTOM_RIGHT}));
+    static_assert(encode_corner({{0, 0}, HexCornerDirection::TOP_RIGHT}) ==
+                  encode_corner({{1, -1}, HexCornerDirection::LEFT}));
+    static_assert(encode_corner({{0, 0}, HexCornerDirection::RIGHT}) !=
+                  encode_corner({{0, 0}, HexCornerDirection::BOTTOM_RIGHT}));
+    static_assert(encode_edge({{0, 0}, HexEdgeDirection::TOP}) == encode_edge({{0, -1}, HexEdgeDirection::BOTTOM}));
+    static_assert(encode_edge({{2, -1}, HexEdgeDirection::TOP_RIGHT}) ==
+                  encode_edge({{3, -2}, HexEdgeDirection::BOTTOM_LEFT}));
+    static_assert(decode_corner(encode_corner({{0, 0}, HexCornerDirection::TOP_RIGHT})) ==
+                  CornerCoord{{0, -1}, HexCornerDirection::BOTTOM_RIGHT});
+    static_assert(decode_edge(encode_edge({{-4, 7}, HexEdgeDirection::TOP_LEFT})) ==
+                  EdgeCoord{{-5, 7}, HexEdgeDirection::BOTTOM_RIGHT});
+    static_assert(decode_hex(encode_hex({-COORD_KEY_BIAS, COORD_KEY_BIAS - 1})) ==
+                  HexCoord2{-COORD_KEY_BIAS, COORD_KEY_BIAS - 1});
+    static_assert([] {
+        for (const auto direction: HEX_CORNER_DIRECTIONS) {
+            const CornerCoord corner{{5, -3}, direction};
+            const auto canonical = canonical_corner_coord(corner);
+            if (canonical_corner_coord(canonical) != canonical) {
+                return false;
+            }
+            // The neighbour across edge i names corner i as its corner i + 4
+            const HexCoord2 neighbour = corner.hex_coord.get_neighbouring_hex_coord(
+                static_cast<HexEdgeDirection>(static_cast<int>(direction)));
+            if (encode_corner({neighbour, static_cast<HexCornerDirection>((static_cast<int>(direction) + 4) % 6)}) !=
+                encode_corner(corner)) {
+                return false;
+            }
+        }
+        return true;
+    }());
+
+    static_assert(count_corners<0>() == 6 && count_edges<0>() == 6);
+    static_assert(count_corners<2>() == 54 && count_edges<2>() == 72);
+    static_assert(count_corners<3>() == 96 && count_edges<3>() == 132);
+
+    // Test: An edge and a corner that do not touch are rejected at runtime
+    TEST(CoordsTest, EdgeCornerMismatchThrows) {
+        EXPECT_THROW((void) edge_direction_to_corner_direction(HexEdgeDirection::TOP, CornerEdgeDirection::TOP_LEFT),
+                     std::invalid_argument);
+    }
+} // namespace Map
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include <ranges>
+#include <vector>
+#include "enum_map.hh"
+#include "map.hh"
+
+namespace Game {
+    namespace {
+        enum class Colour { RED, GREEN, BLUE, COUNT };
+
+        constexpr EnumMap<Colour, int> WAVELENGTHS{{Colour::RED, 700}, {Colour::BLUE, 450}};
+    } // namespace
+
+    static_assert(EnumMap<Colour, int>::size() == 3);
+    static_assert(EnumMap<Map::Resource, int>::size() == Map::RESOURCE_COUNT);
+    static_assert(WAVELENGTHS[Colour::RED] == 700);
+    static_assert(WAVELENGTHS[Colour::GREEN] == 0);
+    static_assert(sizeof(EnumMap<Colour, int>) == 3 * sizeof(int));
+
+    // Test: Iterating yields every key in enumerator order with its value, and writes go through
+    TEST(EnumMapTest, IteratesKeysInOrder) {
+        EnumMap<Colour, int> map = WAVELENGTHS;
+        std::vector<Colour> keys;
+        for (auto [colour, wavelength]: map) {
+            keys.push_back(colour);
+            wavelength += 1;
+        }
+        EXPECT_EQ(keys, (std::vector{Colour::RED, Colour::GREEN, Colour::BLUE}));
+        EXPECT_EQ(map[Colour::BLUE], 451);
+        EXPECT_EQ(std::ranges::distance(map), 3);
+    }
+
+    // Test: Keys sized through enum_count work as map keys, and at() rejects values outside the enum
+    TEST(EnumMapTest, ResourceKeysAndBoundsChecks) {
+        EnumMap<Map::Resource, int> hand;
+        for (const Map::Resource resource: Map::RESOURCES) {
+            hand[resource] = static_cast<int>(resource) * 2;
+        }
+        EXPECT_EQ(hand.at(Map::Resource::STONE), 10);
+        EXPECT_EQ(hand[Map::Resource::NONE], 0);
+        EXPECT_THROW((void) hand.at(static_cast<Map::Resource>(Map::RESOURCE_COUNT)), std::out_of_range);
+    }
+} // namespace Game
@@ -0,0 +1,212 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "game_state.hh"
+#include "test_helpers.hh"
+
+namespace Game {
+    namespace {
+        // Everything observable about the state, to compare two points in time.
+        struct Observed {
+            std::vector<ResourceBundle> resources{};
+            std::vector<Map::CornerBoard> settlements{};
+            std::vector<Map::CornerBoard> cities{};
+            std::vector<Map::EdgeBoard> roads{};
+            std::vector<std::uint32_t> longest_roads{};
+            std::vector<std::pair<PlayerId, std::uint8_t> > houses{};
+            std::vector<PlayerId> road_owners{};
+            Map::HexId robber;
+            PlayerId longest_road_holder;
+            ZobristHash hash;
+
+            auto operator==(const Observed &other) const -> bool = default;
+        };
+
+        auto observe(const GameState &state) -> Observed {
+            Observed observed{
+                .robber = state.get_robber(),
+                .longest_road_holder = state.get_longest_road_holder(),
+                .hash = state.get_hash(),
+            };
+            for (PlayerId player = 0; player < static_cast<PlayerId>(state.get_player_count()); player++) {
+                observed.resources.push_back(state.get_resources(player));
+                observed.settlements.push_back(state.get_pieces().get_settlements(player));
+                observed.cities.push_back(state.get_pieces().get_cities(player));
+                observed.roads.push_back(state.get_pieces().get_roads(player));
+                observed.longest_roads.push_back(state.get_road_network().get_longest_road(player));
+            }
+            const auto &topology = state.get_map().get_topology();
+            for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+                const House &house = state.get_map().get_corner(corner)->house;
+                observed.houses.emplace_back(house.owner, house.level);
+            }
+            for (Map::EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+                observed.road_owners.push_back(state.get_map().get_edge(edge)->road.owner);
+            }
+            return observed;
+        }
+    } // namespace
+
+    // Test: Undoing a random line of play restores the state it started from, indexes included
+    TEST(GameStateTest, UndoRestoresState) {
+        for (const std::uint64_t seed: {1, 2, 3}) {
+            GameState state{Map::Map::build_map_of_size(2, seed), 4, static_cast<std::uint32_t>(seed)};
+            std::mt19937_64 random{seed};
+            play_random_setup(state, random);
+
+            for (int line = 0; line < 20; line++) {
+                const Observed before = observe(state);
+                const UndoMark mark = state.get_undo_mark();
+                for (int move = 0; move < 40; move++) {
+                    play_random_move(state, random);
+                }
+                state.undo(mark);
+                EXPECT_EQ(state.get_undo_mark(), mark);
+                ASSERT_EQ(observe(state), before);
+                ASSERT_EQ(state.check_legal_moves(), std::nullopt);
+                // Keep the game going from here
+                for (int move = 0; move < 10; move++) {
+                    play_random_move(state, random);
+                }
+            }
+        }
+    }
+
+    // Test: Undone dice rolls come out of the deck again in the same order, across reshuffles
+    TEST(GameStateTest, UndoReplaysTheSameRolls) {
+        GameState state{Map::Map::build_map_of_size(2, 7), 4, 7};
+        std::vector<int> rolls;
+        const UndoMark mark = state.get_undo_mark();
+        // Long enough to reshuffle the deck a few times
+        for (int roll = 0; roll < 100; roll++) {
+            rolls.push_back(state.roll_dice());
+        }
+        state.undo(mark);
+        for (const int roll: rolls) {
+            EXPECT_EQ(state.roll_dice(), roll);
+        }
+    }
+
+    // Test: Rolls drawn by value come out of the deck and go back to where they were on undo
+    TEST(GameStateTest, RollByValueUndoes) {
+        GameState state{Map::Map::build_map_of_size(2, 8), 4, 8};
+        const RollManager deck = state.get_roll_manager();
+        const UndoMark mark = state.get_undo_mark();
+        for (const int value: {12, 2, 7, 7, 7}) {
+            const size_t before = state.get_roll_manager().count(value);
+            EXPECT_EQ(state.roll_dice(value), value);
+            EXPECT_EQ(state.get_roll_manager().count(value) + 1, before);
+        }
+        EXPECT_THROW(state.roll_dice(1), std::invalid_argument);
+        state.undo(mark);
+        const RollManager &restored = state.get_roll_manager();
+        ASSERT_EQ(restored.get_queue_size(), deck.get_queue_size());
+        for (size_t position = 0; position < deck.get_queue_size(); position++) {
+            EXPECT_EQ(restored.peek(position), deck.peek(position));
+        }
+    }
+
+    // Test: Restoring a snapshot brings back the state it was taken from and keeps the game playable
+    TEST(GameStateTest, SnapshotRestoresState) {
+        GameState state{Map::Map::build_map_of_size(3, 4), 3, 4};
+        std::mt19937_64 random{4};
+        play_random_setup(state, random);
+
+        GameStateSnapshot snapshot;
+        for (int line = 0; line < 10; line++) {
+            state.snapshot(snapshot);
+            const Observed before = observe(state);
+            for (int move = 0; move < 50; move++) {
+                play_random_move(state, random);
+            }
+            state.restore(snapshot);
+            ASSERT_EQ(observe(state), before);
+            ASSERT_EQ(state.check_legal_moves(), std::nullopt);
+            EXPECT_EQ(state.get_undo_mark(), 0);
+            for (int move = 0; move < 10; move++) {
+                play_random_move(state, random);
+            }
+            ASSERT_EQ(state.check_legal_moves(), std::nullopt);
+        }
+    }
+
+    // Test: A snapshot only restores into the game it was taken from
+    TEST(GameStateTest, SnapshotOfAnotherGameIsRejected) {
+        const GameState first{Map::Map::build_map_of_size(2, 1), 4, 1};
+        GameState second{Map::Map::build_map_of_size(2, 1), 4, 1};
+        EXPECT_THROW(second.restore(first.snapshot()), std::invalid_argument);
+        EXPECT_THROW(second.restore(GameStateSnapshot{}), std::invalid_argument);
+    }
+
+    // Test: The incremental hash always equals the hash recomputed from scratch, undo included
+    TEST(GameStateTest, HashStaysConsistent) {
+        GameState state{Map::Map::build_map_of_size(3, 5), 4, 5};
+        std::mt19937_64 random{5};
+        play_random_setup(state, random);
+        for (int line = 0; line < 50; line++) {
+            const UndoMark mark = state.get_undo_mark();
+            for (int move = 0; move < 20; move++) {
+                play_random_move(state, random);
+                ASSERT_EQ(state.get_hash(), state.compute_hash());
+            }
+            if (line % 2 == 0) {
+                state.undo(mark);
+                ASSERT_EQ(state.get_hash(), state.compute_hash());
+            }
+        }
+    }
+
+    // Test: The same pieces built in a different order give the same hash, anything else a different one
+    TEST(GameStateTest, TransposedBuildOrdersHashEqual) {
+        const auto build = [](const std::vector<std::pair<Map::CornerId, PlayerId> > &houses) {
+            GameState state{Map::Map::build_map_of_size(2, 3), 4, 3};
+            for (const auto &[corner, player]: houses) {
+                state.place_house(corner, House{.owner = player, .level = 1});
+                state.add_resources(player, Map::Resource::WOOD, -1);
+            }
+            return state.get_hash();
+        };
+        const ZobristHash hash = build({{0, 0}, {20, 1}, {40, 0}});
+        EXPECT_EQ(build({{40, 0}, {0, 0}, {20, 1}}), hash);
+        EXPECT_EQ(build({{20, 1}, {40, 0}, {0, 0}}), hash);
+        EXPECT_NE(build({{0, 1}, {20, 0}, {40, 0}}), hash);
+        EXPECT_NE(build({{0, 0}, {20, 1}}), hash);
+    }
+
+    // Test: Whose turn it is and the phase are part of the hash
+    TEST(GameStateTest, TurnIsHashed) {
+        GameState state{Map::Map::build_map_of_size(2, 3), 4, 3};
+        const ZobristHash start = state.get_hash();
+        state.set_turn(1, GamePhase::FREE_BUILDING);
+        const ZobristHash next_player = state.get_hash();
+        state.set_turn(1, GamePhase::ROLL);
+        EXPECT_NE(next_player, start);
+        EXPECT_NE(state.get_hash(), next_player);
+        state.set_turn(0, GamePhase::FREE_BUILDING);
+        EXPECT_EQ(state.get_hash(), start);
+    }
+
+    // Test: Who holds longest road is part of the hash and undoes like any other change
+    TEST(GameStateTest, LongestRoadHolderIsHashed) {
+        GameState state{Map::Map::build_map_of_size(2, 3), 4, 3};
+        const ZobristHash start = state.get_hash();
+        const UndoMark mark = state.get_undo_mark();
+        state.set_longest_road_holder(2);
+        const ZobristHash held = state.get_hash();
+        EXPECT_NE(held, start);
+        EXPECT_EQ(held, state.compute_hash());
+        state.set_longest_road_holder(1);
+        EXPECT_NE(state.get_hash(), held);
+        state.set_longest_road_holder(NO_PLAYER);
+        EXPECT_EQ(state.get_hash(), start);
+        state.undo(mark + 1);
+        EXPECT_EQ(state.get_longest_road_holder(), 2);
+        EXPECT_EQ(state.get_hash(), held);
+        state.undo(mark);
+        EXPECT_EQ(state.get_longest_road_holder(), NO_PLAYER);
+        EXPECT_EQ(state.get_hash(), start);
+    }
+} // namespace Game
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "game_state.hh"
+#include "legal_moves.hh"
+#include "test_helpers.hh"
+
+namespace Game {
+    // Test: Legal moves stay equal to a full recomputation through a game of random legal moves
+    TEST(LegalMovesTest, RandomGameStaysConsistent) {
+        for (const std::uint64_t seed: {1, 2, 3}) {
+            GameState state{Map::Map::build_map_of_size(3, seed)};
+            const auto &layout = state.get_map().get_topology().get_bitboard_layout();
+            std::mt19937_64 random{seed};
+
+            // Setup: a free settlement and a road next to it, twice per player
+            for (int round = 0; round < 2; round++) {
+                for (PlayerId player = 0; player < static_cast<PlayerId>(state.get_player_count()); player++) {
+                    const auto corner = pick(layout, state.get_setup_builds(), random);
+                    ASSERT_NE(corner, Map::NO_NODE);
+                    state.place_house(corner, House{.owner = player, .level = 1});
+                    state.place_road(pick(layout, state.get_setup_roads(), random), Road{player});
+                    ASSERT_EQ(state.check_legal_moves(), std::nullopt);
+                }
+            }
+
+            for (int turn = 0; turn < 200; turn++) {
+                const auto player = static_cast<PlayerId>(turn % state.get_player_count());
+                switch (random() % 3) {
+                    case 0:
+                        if (const auto corner = pick(layout, state.get_legal_builds(player), random);
+                            corner != Map::NO_NODE) {
+                            state.place_house(corner, House{.owner = player, .level = 1});
+                        }
+                        break;
+                    case 1:
+                        if (const auto corner = pick(layout, state.get_legal_upgrades(player), random);
+                            corner != Map::NO_NODE) {
+                            state.place_house(corner, House{.owner = player, .level = 2});
+                        }
+                        break;
+                    default:
+                        if (const auto edge = pick(layout, state.get_legal_roads(player), random);
+                            edge != Map::NO_NODE) {
+                            state.place_road(edge, Road{player});
+                        }
+                        break;
+                }
+                ASSERT_EQ(state.check_legal_moves(), std::nullopt) << "seed " << seed << " turn " << turn;
+            }
+        }
+    }
+
+    // Test: Arbitrary placements and removals, legal or not, keep the sets consistent
+    TEST(LegalMovesTest, ArbitraryEditsStayConsistent) {
+        constexpr size_t player_count = 3;
+        const auto topology = Map::BoardTopology::shared(Map::MapBounds::from_radius(4));
+        Map::BoardBitboards pieces{topology, player_count};
+        LegalMoves legal_moves{pieces};
+        std::mt19937_64 random{9};
+        for (int edit = 0; edit < 2000; edit++) {
+            const auto player = static_cast<PlayerId>(random() % player_count);
+            const bool remove = random() % 4 == 0;
+            if (random() % 2 == 0) {
+                const auto corner = static_cast<Map::CornerId>(random() % topology->get_corner_count());
+                const House house = remove ? House{} : House{player, static_cast<std::uint8_t>(1 + random() % 2)};
+                pieces.set_house(corner, house);
+                legal_moves.update_around_corner(pieces, corner);
+            } else {
+                const auto edge = static_cast<Map::EdgeId>(random() % topology->get_edge_count());
+                pieces.set_road(edge, remove ? Road{} : Road{player});
+                legal_moves.update_around_edge(pieces, edge);
+            }
+            ASSERT_EQ(legal_moves.find_inconsistency(pieces), std::nullopt) << "edit " << edit;
+        }
+    }
+
+    // Test: The legal sets of a player are empty while they cannot pay, and come back with the resources
+    TEST(LegalMovesTest, ResourcesGateTheSets) {
+        GameState state{Map::Map::build_map_of_size(2, 4), 2};
+        const auto &layout = state.get_map().get_topology().get_bitboard_layout();
+        std::mt19937_64 random{4};
+        const auto corner = pick(layout, state.get_setup_builds(), random);
+        state.place_house(corner, House{.owner = 0, .level = 1});
+        state.place_road(pick(layout, state.get_setup_roads(), random), Road{0});
+        EXPECT_TRUE(state.get_legal_roads(0).any());
+        EXPECT_TRUE(state.get_legal_upgrades(0).any());
+
+        state.add_resources(0, Map::Resource::BRICK, -20);
+        EXPECT_FALSE(state.get_legal_roads(0).any());
+        EXPECT_FALSE(state.get_legal_builds(0).any());
+        EXPECT_TRUE(state.get_legal_upgrades(0).any());
+        EXPECT_TRUE(state.get_legal_moves().get_roads(0).any());
+
+        state.add_resources(0, Map::Resource::BRICK, 1);
+        EXPECT_TRUE(state.get_legal_roads(0).any());
+        EXPECT_EQ(state.get_map().get_corner(corner)->house.owner, 0);
+    }
+} // namespace Game
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <ranges>
+#include <vector>
+#include "map.hh"
+
+namespace Map {
+    // Test: Opposite directions are half a turn away
+    TEST(MapTest, OppositeDirection) {
+        EXPECT_EQ(opposite_direction(HexEdgeDirection::BOTTOM_RIGHT), HexEdgeDirection::TOP_LEFT);
+        EXPECT_EQ(opposite_direction(HexEdgeDirection::TOP), HexEdgeDirection::BOTTOM);
+        EXPECT_EQ(opposite_direction(HexCornerDirection::TOP_LEFT), HexCornerDirection::BOTTOM_RIGHT);
+        EXPECT_EQ(opposite_direction(CornerEdgeDirection::TOP_RIGHT), CornerEdgeDirection::BOTTOM_LEFT);
+    }
+
+    // Test: Direction slots only report filled directions
+    TEST(MapTest, DirectionSlotsGetAndIterate) {
+        Corner corner_a;
+        Corner corner_b;
+        DirectionSlots<CornerEdgeDirection, Corner, 2> slots;
+        EXPECT_EQ(slots.size(), 0);
+        EXPECT_EQ(slots.begin(), slots.end());
+
+        slots.set(CornerEdgeDirection::RIGHT, &corner_a);
+        slots.set(CornerEdgeDirection::LEFT, &corner_b);
+        EXPECT_EQ(slots.size(), 2);
+        EXPECT_EQ(slots.get(CornerEdgeDirection::RIGHT), &corner_a);
+        EXPECT_EQ(slots.get(CornerEdgeDirection::LEFT), &corner_b);
+        EXPECT_EQ(slots.get(CornerEdgeDirection::TOP_LEFT), nullptr);
+
+        std::vector<const Corner *> values;
+        for (const Corner *corner: slots | std::views::values) {
+            values.push_back(corner);
+        }
+        EXPECT_EQ(values, (std::vector<const Corner *>{&corner_a, &corner_b}));
+    }
+
+    // Test: Every node of the standard board is fully linked through its slots
+    TEST(MapTest, StandardBoardSlotsAreLinked) {
+        const auto map = Map::build_map_of_size(2);
+        for (const Hex *hex: map.get_hexes() | std::views::values) {
+            EXPECT_EQ(hex->corners.size(), 6);
+            EXPECT_EQ(hex->edges.size(), 6);
+        }
+        for (const Corner *corner: map.get_corners() | std::views::values) {
+            EXPECT_GE(corner->hexes.size(), 1);
+            EXPECT_GE(corner->edges.size(), 2);
+            for (const auto &[direction, edge]: corner->edges) {
+                EXPECT_EQ(edge->corners.get(opposite_direction(direction)), corner);
+            }
+        }
+        for (const Edge *edge: map.get_edges() | std::views::values) {
+            EXPECT_EQ(edge->corners.size(), 2);
+            EXPECT_GE(edge->hexes.size(), 1);
+            EXPECT_FALSE(edge->road.is_built());
+        }
+    }
+
+    // Test: A clone owns its nodes and every neighbour pointer stays inside the clone
+    TEST(MapTest, CloneIsIndependent) {
+        const auto map = Map::build_map_of_size(2);
+        map.find_corner({{0, 0}, HexCornerDirection::RIGHT})->house = House{.owner = 1, .level = 1};
+
+        const auto clone = map.clone();
+        EXPECT_EQ(&clone.get_topology(), &map.get_topology());
+
+        const auto hex_range = clone.get_hexes() | std::views::values;
+        const auto corner_range = clone.get_corners() | std::views::values;
+        const auto edge_range = clone.get_edges() | std::views::values;
+        const std::vector<Hex *> hexes(hex_range.begin(), hex_range.end());
+        const std::vector<Corner *> corners(corner_range.begin(), corner_range.end());
+        const std::vector<Edge *> edges(edge_range.begin(), edge_range.end());
+        const auto owns = [](const auto &nodes, const auto *node) {
+            return std::ranges::find(nodes, node) != nodes.end();
+        };
+
+        for (const auto &[coord, hex]: map.get_hexes()) {
+            const Hex *cloned_hex = clone.find_hex(coord);
+            ASSERT_NE(cloned_hex, hex);
+            EXPECT_EQ(cloned_hex->resource, hex->resource);
+            EXPECT_EQ(cloned_hex->number, hex->number);
+            for (const Corner *corner: cloned_hex->corners | std::views::values) {
+                EXPECT_TRUE(owns(corners, corner));
+            }
+            for (const Edge *edge: cloned_hex->edges | std::views::values) {
+                EXPECT_TRUE(owns(edges, edge));
+            }
+        }
+        for (const Corner *corner: corners) {
+            for (const Hex *hex: corner->hexes | std::views::values) {
+                EXPECT_TRUE(owns(hexes, hex));
+            }
+        }
+        for (const Edge *edge: edges) {
+            for (const Corner *corner: edge->corners | std::views::values) {
+                EXPECT_TRUE(owns(corners, corner));
+            }
+        }
+
+        Corner *cloned_corner = clone.find_corner({{0, 0}, HexCornerDirection::RIGHT});
+        EXPECT_EQ(cloned_corner->house.owner, 1);
+        cloned_corner->house.level = 2;
+        EXPECT_EQ(map.find_corner({{0, 0}, HexCornerDirection::RIGHT})->house.level, 1);
+    }
+} // namespace Map
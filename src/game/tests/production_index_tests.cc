@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "flat_map.hh"
+#include "game_state.hh"
+#include "production_index.hh"
+
+namespace Game {
+    namespace {
+        // Production the way the old engine loop resolved it: every hex of the rolled number, every corner of it
+        auto scan_production(const Map::FlatMap &flat_map, const int roll, const Map::HexId robber,
+                             const size_t player_count) -> std::vector<ResourceBundle> {
+            std::vector<ResourceBundle> deltas(player_count);
+            const auto &topology = flat_map.get_topology();
+            for (Map::HexId hex = 0; hex < topology.get_hex_count(); hex++) {
+                if (hex == robber || flat_map.get_hex_number(hex) != roll ||
+                    flat_map.get_hex_resource(hex) == Map::Resource::NONE) {
+                    continue;
+                }
+                for (const Map::CornerId corner: topology.get_hex_corners(hex)) {
+                    const House &house = flat_map.get_house(corner);
+                    if (house.is_built()) {
+                        deltas[house.owner][flat_map.get_hex_resource(hex)] += house.level;
+                    }
+                }
+            }
+            return deltas;
+        }
+    } // namespace
+
+    // Test: Every roll yields what a full scan of the board yields, through builds, upgrades and removals
+    TEST(ProductionIndexTest, MatchesBoardScan) {
+        constexpr size_t player_count = 4;
+        for (const size_t radius: {2, 6}) {
+            auto flat_map = Map::FlatMap::generate(radius, radius);
+            ProductionIndex index{flat_map.get_shared_topology(), flat_map.get_state()};
+            const auto &topology = flat_map.get_topology();
+            std::mt19937_64 random{radius};
+            for (int edit = 0; edit < 300; edit++) {
+                const auto corner = static_cast<Map::CornerId>(random() % topology.get_corner_count());
+                const House house = random() % 5 == 0
+                                        ? House{}
+                                        : House{static_cast<PlayerId>(random() % player_count),
+                                                static_cast<std::uint8_t>(1 + random() % 2)};
+                flat_map.set_house(corner, house);
+                index.set_house(corner, house);
+
+                const auto robber = static_cast<Map::HexId>(random() % topology.get_hex_count());
+                for (int roll = 2; roll <= ProductionIndex::MAX_ROLL; roll++) {
+                    std::vector<ResourceBundle> deltas(player_count);
+                    index.produce(roll, robber, deltas);
+                    ASSERT_EQ(deltas, scan_production(flat_map, roll, robber, player_count)) << edit << " " << roll;
+                }
+            }
+        }
+    }
+
+    // Test: An index built over a board with houses already on it equals one that saw them built
+    TEST(ProductionIndexTest, BuildsFromExistingHouses) {
+        auto flat_map = Map::FlatMap::generate(2, 8);
+        ProductionIndex incremental{flat_map.get_shared_topology(), flat_map.get_state()};
+        for (const Map::CornerId corner: {0u, 9u, 20u, 41u}) {
+            flat_map.set_house(corner, House{.owner = 1, .level = 2});
+            incremental.set_house(corner, House{.owner = 1, .level = 2});
+        }
+        const ProductionIndex rebuilt{flat_map.get_shared_topology(), flat_map.get_state()};
+        for (int roll = 2; roll <= ProductionIndex::MAX_ROLL; roll++) {
+            EXPECT_EQ(incremental.get_slots(roll).size(), rebuilt.get_slots(roll).size());
+        }
+    }
+
+    // Test: A roll in the game state adds the production to the owners' resources, except under the robber
+    TEST(ProductionIndexTest, GameStateCollectsProduction) {
+        GameState state{Map::Map::build_map_of_size(2, 6), 2};
+        const auto &map = state.get_map();
+        const Map::HexId hex = state.get_robber() == 0 ? 1 : 0;
+        const int number = map.get_hex(hex)->number;
+        const Map::Resource resource = map.get_hex(hex)->resource;
+        const Map::CornerId corner = map.get_topology().get_hex_corners(hex)[0];
+        state.place_house(corner, House{.owner = 1, .level = 2});
+
+        const auto expected_gain = [&] {
+            int gain = 0;
+            for (const Map::HexId corner_hex: map.get_topology().get_corner_hexes(corner)) {
+                const Map::Hex *node = map.get_hex(corner_hex);
+                gain += corner_hex != state.get_robber() && node->number == number && node->resource == resource ? 2 : 0;
+            }
+            return gain;
+        };
+
+        int before = state.get_resources(1)[resource];
+        state.produce(number);
+        EXPECT_EQ(state.get_resources(1)[resource] - before, expected_gain());
+        EXPECT_GE(expected_gain(), 2);
+
+        state.set_robber(hex);
+        before = state.get_resources(1)[resource];
+        state.produce(number);
+        EXPECT_EQ(state.get_resources(1)[resource] - before, expected_gain());
+        EXPECT_EQ(state.get_resources(0)[resource], 20);
+    }
+} // namespace Game
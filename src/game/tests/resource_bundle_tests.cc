@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
+#include "resource_bundle.hh"
+
+namespace Game {
+    static_assert(sizeof(ResourceBundle) == 16);
+    static_assert(get_recipe(Recipe::CITY)[Map::Resource::STONE] == 3);
+    static_assert(get_recipe(Recipe::SETTLEMENT).total() == 4);
+    static_assert(get_affordable_recipes(get_recipe(Recipe::SETTLEMENT)) ==
+                  (recipe_bit(Recipe::ROAD) | recipe_bit(Recipe::SETTLEMENT)));
+    static_assert(get_affordable_recipes(ResourceBundle{}) == 0);
+
+    // Test: Lane-wise arithmetic works per resource and leaves the other lanes alone
+    TEST(ResourceBundleTest, Arithmetic) {
+        ResourceBundle hand{{Map::Resource::WOOD, 3}, {Map::Resource::STONE, 1}};
+        hand += ResourceBundle{{Map::Resource::WOOD, 1}, {Map::Resource::SHEEP, 2}};
+        EXPECT_EQ(hand[Map::Resource::WOOD], 4);
+        EXPECT_EQ(hand[Map::Resource::SHEEP], 2);
+        EXPECT_EQ(hand[Map::Resource::BRICK], 0);
+
+        hand -= get_recipe(Recipe::ROAD);
+        EXPECT_EQ(hand[Map::Resource::WOOD], 3);
+        EXPECT_EQ(hand[Map::Resource::BRICK], -1);
+        EXPECT_EQ(hand.total(), 5);
+        EXPECT_EQ(hand - hand, ResourceBundle{});
+        EXPECT_TRUE((hand - hand).is_empty());
+
+        hand[Map::Resource::BRICK] += 2;
+        EXPECT_TRUE(hand.covers(get_recipe(Recipe::ROAD)));
+    }
+
+    // Test: The affordability mask agrees with checking every recipe against a hashed hand
+    TEST(ResourceBundleTest, AffordabilityMatchesMapLookup) {
+        std::mt19937_64 random{13};
+        for (int hand_index = 0; hand_index < 1000; hand_index++) {
+            ResourceBundle hand;
+            std::unordered_map<Map::Resource, int> map_hand;
+            for (const Map::Resource resource: Map::RESOURCES) {
+                const int amount = static_cast<int>(random() % 4);
+                hand[resource] = static_cast<std::int16_t>(amount);
+                map_hand[resource] = amount;
+            }
+            RecipeMask expected = 0;
+            for (const auto &[recipe, cost]: RECIPES) {
+                bool affordable = true;
+                for (const Map::Resource resource: Map::RESOURCES) {
+                    affordable = affordable && map_hand[resource] >= cost[resource];
+                }
+                expected |= affordable ? recipe_bit(recipe) : 0;
+            }
+            ASSERT_EQ(get_affordable_recipes(hand), expected);
+        }
+    }
+} // namespace Game
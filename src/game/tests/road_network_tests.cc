@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <gtest/gtest.h>
+#include <random>
+#include <utility>
+#include <vector>
+#include "board_topology.hh"
+#include "road_network.hh"
+
+namespace Game {
+    namespace {
+        struct Board {
+            std::vector<PlayerId> road_owners;
+            std::vector<PlayerId> house_owners;
+        };
+
+        auto other_end(const Map::BoardTopology &topology, const Map::EdgeId edge, const Map::CornerId corner) {
+            const auto ends = topology.get_edge_corners(edge);
+            return ends[0] == corner ? ends[1] : ends[0];
+        }
+
+        // Longest trail of the player by depth first search from every corner of the board
+        auto brute_force_longest_road(const Map::BoardTopology &topology, const Board &board,
+                                      const PlayerId player) -> std::uint32_t {
+            std::vector<bool> used(topology.get_edge_count(), false);
+            const std::function<std::uint32_t(Map::CornerId)> walk = [&](const Map::CornerId corner) {
+                std::uint32_t longest = 0;
+                for (const Map::EdgeId edge: topology.get_corner_edges(corner)) {
+                    if (board.road_owners[edge] != player || used[edge]) {
+                        continue;
+                    }
+                    used[edge] = true;
+                    const Map::CornerId next = other_end(topology, edge, corner);
+                    const bool passable = board.house_owners[next] == NO_PLAYER || board.house_owners[next] == player;
+                    longest = std::max(longest, 1 + (passable ? walk(next) : 0));
+                    used[edge] = false;
+                }
+                return longest;
+            };
+            std::uint32_t longest = 0;
+            for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+                longest = std::max(longest, walk(corner));
+            }
+            return longest;
+        }
+
+        // Network of every road of the player by flood fill, as a label per edge
+        auto brute_force_networks(const Map::BoardTopology &topology, const Board &board,
+                                  const PlayerId player) -> std::vector<std::int32_t> {
+            std::vector<std::int32_t> labels(topology.get_edge_count(), -1);
+            for (Map::EdgeId start = 0; start < topology.get_edge_count(); start++) {
+                if (board.road_owners[start] != player || labels[start] != -1) {
+                    continue;
+                }
+                std::vector<Map::EdgeId> stack{start};
+                labels[start] = static_cast<std::int32_t>(start);
+                while (!stack.empty()) {
+                    const Map::EdgeId edge = stack.back();
+                    stack.pop_back();
+                    for (const Map::CornerId corner: topology.get_edge_corners(edge)) {
+                        if (board.house_owners[corner] != NO_PLAYER && board.house_owners[corner] != player) {
+                            continue;
+                        }
+                        for (const Map::EdgeId next: topology.get_corner_edges(corner)) {
+                            if (board.road_owners[next] == player && labels[next] == -1) {
+                                labels[next] = static_cast<std::int32_t>(start);
+                                stack.push_back(next);
+                            }
+                        }
+                    }
+                }
+            }
+            return labels;
+        }
+    } // namespace
+
+    // Test: Roads around a hex form a path whose length grows to a closed ring of six
+    TEST(RoadNetworkTest, RingAroundAHex) {
+        const auto topology = Map::BoardTopology::shared(Map::MapBounds::from_radius(2));
+        const auto center = *topology->find_hex({0, 0});
+        const auto edges = topology->get_hex_edges(center);
+        RoadNetwork network{topology, 2};
+        for (size_t i = 0; i < edges.size(); i++) {
+            network.set_road(edges[i], Road{0});
+            EXPECT_EQ(network.get_longest_road(0), i + 1);
+            EXPECT_TRUE(network.are_connected(edges[0], edges[i]));
+        }
+        EXPECT_EQ(network.get_network_length(edges[3]), 6);
+        EXPECT_EQ(network.get_longest_road(1), 0);
+    }
+
+    // Test: An opponent's house in the middle of a road splits the network
+    TEST(RoadNetworkTest, OpponentHouseSplitsTheNetwork) {
+        const auto topology = Map::BoardTopology::shared(Map::MapBounds::from_radius(2));
+        const auto center = *topology->find_hex({0, 0});
+        const auto edges = topology->get_hex_edges(center);
+        const auto corners = topology->get_hex_corners(center);
+        RoadNetwork network{topology, 2};
+        // Edge i of a hex runs from corner i to corner i + 1
+        for (size_t i = 0; i < 5; i++) {
+            network.set_road(edges[i], Road{0});
+        }
+        EXPECT_EQ(network.get_longest_road(0), 5);
+
+        network.set_house(corners[2], House{.owner = 1, .level = 1});
+        EXPECT_EQ(network.get_longest_road(0), 3);
+        EXPECT_FALSE(network.are_connected(edges[0], edges[4]));
+        EXPECT_TRUE(network.are_connected(edges[2], edges[4]));
+
+        // The player's own house does not cut anything
+        network.set_house(corners[2], House{.owner = 0, .level = 1});
+        EXPECT_EQ(network.get_longest_road(0), 5);
+        EXPECT_TRUE(network.are_connected(edges[0], edges[4]));
+    }
+
+    // Test: Networks and longest roads match a brute force search through random builds, houses and removals
+    TEST(RoadNetworkTest, MatchesBruteForce) {
+        constexpr size_t player_count = 3;
+        const auto topology = Map::BoardTopology::shared(Map::MapBounds::from_radius(3));
+        std::mt19937_64 random{12};
+        for (int game = 0; game < 10; game++) {
+            RoadNetwork network{topology, player_count};
+            Board board{
+                std::vector<PlayerId>(topology->get_edge_count(), NO_PLAYER),
+                std::vector<PlayerId>(topology->get_corner_count(), NO_PLAYER),
+            };
+            for (int edit = 0; edit < 60; edit++) {
+                const auto player = static_cast<PlayerId>(random() % player_count);
+                const auto roll = random() % 10;
+                if (roll < 2) {
+                    const auto corner = static_cast<Map::CornerId>(random() % topology->get_corner_count());
+                    const House house = roll == 0 ? House{} : House{.owner = player, .level = 1};
+                    board.house_owners[corner] = house.owner;
+                    network.set_house(corner, house);
+                } else {
+                    const auto edge = static_cast<Map::EdgeId>(random() % topology->get_edge_count());
+                    const Road road = roll == 2 ? Road{} : Road{player};
+                    board.road_owners[edge] = road.owner;
+                    network.set_road(edge, road);
+                }
+
+                for (PlayerId p = 0; p < static_cast<PlayerId>(player_count); p++) {
+                    ASSERT_EQ(network.get_longest_road(p), brute_force_longest_road(*topology, board, p))
+                        << "game " << game << " edit " << edit;
+                    const auto labels = brute_force_networks(*topology, board, p);
+                    for (Map::EdgeId a = 0; a < topology->get_edge_count(); a++) {
+                        if (labels[a] == -1) {
+                            continue;
+                        }
+                        for (Map::EdgeId b = a + 1; b < topology->get_edge_count(); b++) {
+                            if (labels[b] != -1) {
+                                ASSERT_EQ(network.are_connected(a, b), labels[a] == labels[b]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Test: Rolling back through random builds, houses and removals gives back each earlier state, rebuilds included
+    TEST(RoadNetworkTest, RollbackRestoresEarlierStates) {
+        constexpr size_t player_count = 3;
+        const auto topology = Map::BoardTopology::shared(Map::MapBounds::from_radius(3));
+        std::mt19937_64 random{13};
+        RoadNetwork network{topology, player_count};
+        Board board{
+            std::vector<PlayerId>(topology->get_edge_count(), NO_PLAYER),
+            std::vector<PlayerId>(topology->get_corner_count(), NO_PLAYER),
+        };
+        std::vector<std::pair<size_t, Board>> earlier;
+        for (int edit = 0; edit < 80; edit++) {
+            earlier.emplace_back(network.get_history_mark(), board);
+            const auto player = static_cast<PlayerId>(random() % player_count);
+            const auto roll = random() % 10;
+            if (roll < 2) {
+                const auto corner = static_cast<Map::CornerId>(random() % topology->get_corner_count());
+                const House house = roll == 0 ? House{} : House{.owner = player, .level = 1};
+                board.house_owners[corner] = house.owner;
+                network.set_house(corner, house);
+            } else {
+                const auto edge = static_cast<Map::EdgeId>(random() % topology->get_edge_count());
+                const Road road = roll == 2 ? Road{} : Road{player};
+                board.road_owners[edge] = road.owner;
+                network.set_road(edge, road);
+            }
+        }
+
+        while (!earlier.empty()) {
+            const auto &[mark, previous] = earlier.back();
+            network.rollback(mark);
+            for (PlayerId p = 0; p < static_cast<PlayerId>(player_count); p++) {
+                ASSERT_EQ(network.get_longest_road(p), brute_force_longest_road(*topology, previous, p))
+                    << "edit " << earlier.size() - 1;
+                const auto labels = brute_force_networks(*topology, previous, p);
+                for (Map::EdgeId a = 0; a < topology->get_edge_count(); a++) {
+                    for (Map::EdgeId b = a + 1; b < topology->get_edge_count() && labels[a] != -1; b++) {
+                        if (labels[b] != -1) {
+                            ASSERT_EQ(network.are_connected(a, b), labels[a] == labels[b]);
+                        }
+                    }
+                }
+            }
+            earlier.pop_back();
+        }
+        EXPECT_EQ(network.get_history_mark(), 0);
+    }
+} // namespace Game
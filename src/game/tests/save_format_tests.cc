@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "save_format.hh"
+#include "test_helpers.hh"
+
+namespace Game {
+    namespace {
+        void expect_view_matches(const SaveView &view, const GameState &state) {
+            const Map::Map &map = state.get_map();
+            const auto &topology = map.get_topology();
+            ASSERT_EQ(view.get_radius(), map.get_bounds().radius);
+            ASSERT_EQ(view.get_player_count(), state.get_player_count());
+            for (Map::HexId hex = 0; hex < topology.get_hex_count(); hex++) {
+                EXPECT_EQ(view.get_resource(hex), map.get_hex(hex)->resource);
+                EXPECT_EQ(view.get_number(hex), map.get_hex(hex)->number);
+            }
+            for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+                EXPECT_EQ(view.get_house(corner).owner, map.get_corner(corner)->house.owner);
+                EXPECT_EQ(view.get_house(corner).level, map.get_corner(corner)->house.level);
+            }
+            for (Map::EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+                EXPECT_EQ(view.get_road(edge).owner, map.get_edge(edge)->road.owner);
+            }
+            for (PlayerId player = 0; player < static_cast<PlayerId>(state.get_player_count()); player++) {
+                EXPECT_EQ(view.get_resources(player), state.get_resources(player));
+            }
+            EXPECT_EQ(view.get_robber(), state.get_robber());
+            EXPECT_EQ(view.get_last_built_corner(), state.get_last_built_corner());
+            EXPECT_EQ(view.get_current_player(), state.get_current_player());
+            EXPECT_EQ(view.get_phase(), state.get_phase());
+            EXPECT_EQ(view.get_longest_road_holder(), state.get_longest_road_holder());
+        }
+
+        // Loading either fails cleanly or gives a state that is consistent with itself.
+        void expect_loads_or_throws(const std::vector<std::byte> &bytes) {
+            try {
+                const GameState state = load_game_state(SaveView{bytes});
+                EXPECT_EQ(state.get_hash(), state.compute_hash());
+                EXPECT_EQ(state.check_legal_moves(), std::nullopt);
+            } catch (const std::invalid_argument &) {
+            }
+        }
+    } // namespace
+
+    // Test: Random games read back through the view as they were, load into an equal state and save identically
+    TEST(SaveFormatTest, RoundTripsRandomGames) {
+        std::mt19937_64 random{24};
+        for (size_t radius = 1; radius <= 4; radius++) {
+            for (std::uint64_t seed = 1; seed <= 6; seed++) {
+                const size_t players = 2 + random() % 3;
+                GameState state = make_random_game(radius, players, seed, static_cast<int>(random() % 300));
+                const std::vector<std::byte> bytes = save_game(state);
+                // A snapshot of the state saves the same, read on a clone of the board
+                ASSERT_EQ(save_game(state.get_map().clone(), state.snapshot()), bytes);
+
+                const SaveView view{bytes};
+                expect_view_matches(view, state);
+                // The records are read where they lie
+                EXPECT_EQ(static_cast<const void *>(view.get_houses().data()),
+                          static_cast<const void *>(bytes.data() + view.get_header().houses_offset.get()));
+
+                GameState loaded = load_game_state(view);
+                EXPECT_EQ(loaded.get_hash(), state.get_hash());
+                EXPECT_EQ(loaded.compute_hash(), loaded.get_hash());
+                EXPECT_EQ(loaded.check_legal_moves(), std::nullopt);
+                EXPECT_EQ(loaded.get_undo_mark(), 0);
+                for (PlayerId player = 0; player < static_cast<PlayerId>(players); player++) {
+                    EXPECT_EQ(loaded.get_pieces().get_roads(player), state.get_pieces().get_roads(player));
+                    EXPECT_EQ(loaded.get_road_network().get_longest_road(player),
+                              state.get_road_network().get_longest_road(player));
+                    EXPECT_EQ(loaded.get_legal_moves().get_settlements(player),
+                              state.get_legal_moves().get_settlements(player));
+                }
+                ASSERT_EQ(save_game(loaded), bytes);
+
+                // Same deck, same engine: the dice go on the same way, reshuffles included
+                for (int roll = 0; roll < 80; roll++) {
+                    ASSERT_EQ(loaded.roll_dice(), state.roll_dice());
+                }
+            }
+        }
+    }
+
+    // Test: A save written to disk and mapped back loads the same game
+    TEST(SaveFormatTest, RoundTripsThroughMappedFile) {
+        const GameState state = make_random_game(3, 4, 9, 200);
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "cololite_save_format_test.clsv";
+        save_game(state, path);
+        {
+            const MappedFile file(path);
+            ASSERT_EQ(file.get_bytes().size(), save_game(state).size());
+            const GameState loaded = load_game_state(SaveView{file.get_bytes()});
+            EXPECT_EQ(loaded.get_hash(), state.get_hash());
+        }
+        std::filesystem::remove(path);
+        EXPECT_THROW(MappedFile{path}, std::runtime_error);
+    }
+
+    // Test: A save that cannot replace what is at its path fails without leaving its temporary file behind
+    TEST(SaveFormatTest, FailedWritesLeaveNoTemporary) {
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "cololite_save_format_dir";
+        std::filesystem::create_directories(path / "occupied");
+        EXPECT_THROW(save_game(make_random_game(2, 4, 5, 50), path), std::runtime_error);
+        EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+        std::filesystem::remove_all(path);
+    }
+
+    // Test: Saves cut short, of another kind or of another version are refused when the view is opened
+    TEST(SaveFormatTest, MalformedSavesAreRejected) {
+        const std::vector<std::byte> bytes = save_game(make_random_game(2, 4, 3, 100));
+        for (const size_t size: {size_t{0}, size_t{3}, sizeof(SaveHeader) - 1, sizeof(SaveHeader), bytes.size() - 1}) {
+            const std::vector<std::byte> truncated(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(size));
+            EXPECT_THROW(SaveView{truncated}, std::invalid_argument) << size;
+        }
+        std::vector<std::byte> longer = bytes;
+        longer.push_back(std::byte{0});
+        EXPECT_THROW(SaveView{longer}, std::invalid_argument);
+
+        std::vector<std::byte> other_kind = bytes;
+        other_kind[0] = std::byte{'X'};
+        EXPECT_THROW(SaveView{other_kind}, std::invalid_argument);
+
+        std::vector<std::byte> newer = bytes;
+        auto *header = reinterpret_cast<SaveHeader *>(newer.data());
+        header->version.set(SAVE_VERSION + 1);
+        EXPECT_THROW(SaveView{newer}, std::invalid_argument);
+
+        std::vector<std::byte> out_of_bounds = bytes;
+        header = reinterpret_cast<SaveHeader *>(out_of_bounds.data());
+        header->hands_offset.set(header->file_size.get() - 1);
+        EXPECT_THROW(SaveView{out_of_bounds}, std::invalid_argument);
+    }
+
+    // Test: Loading refuses a roll deck that is not the 36 outcomes of two dice, even with every roll in range
+    TEST(SaveFormatTest, LoadingChecksTheRollDeck) {
+        const std::vector<std::byte> bytes = save_game(make_random_game(2, 4, 6, 100));
+        EXPECT_NO_THROW((void) load_game_state(SaveView{bytes}));
+
+        std::vector<std::byte> loaded_dice = bytes;
+        auto *header = reinterpret_cast<SaveHeader *>(loaded_dice.data());
+        std::ranges::replace(header->rolls, std::int8_t{2}, std::int8_t{7});
+        EXPECT_THROW((void) load_game_state(SaveView{loaded_dice}), std::invalid_argument);
+
+        std::vector<std::byte> reordered = bytes;
+        header = reinterpret_cast<SaveHeader *>(reordered.data());
+        std::ranges::reverse(header->rolls);
+        EXPECT_NO_THROW((void) load_game_state(SaveView{reordered}));
+    }
+
+    // Test: Saves with random bytes overwritten either throw std::invalid_argument or load a consistent state
+    TEST(SaveFormatTest, DamagedSavesFailCleanly) {
+        const std::vector<std::byte> bytes = save_game(make_random_game(2, 3, 5, 150));
+        std::mt19937_64 random{5};
+        for (int trial = 0; trial < 400; trial++) {
+            std::vector<std::byte> damaged = bytes;
+            for (int flip = 1 + static_cast<int>(random() % 4); flip > 0; flip--) {
+                // Half of the damage lands in the header, where most of the checks are
+                const size_t position = random() % 2 == 0 ? random() % sizeof(SaveHeader) : random() % bytes.size();
+                damaged[position] = static_cast<std::byte>(random());
+            }
+            expect_loads_or_throws(damaged);
+        }
+    }
+} // namespace Game
@@ -0,0 +1,92 @@
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+#include "game_state.hh"
+
+// Random play shared by the GameState tests. Only reproducible from the seed, so tests check properties of the
+// games played rather than particular outcomes.
+namespace Game {
+    // A random node set on `board`, Map::NO_NODE when it is empty.
+    template<typename Board>
+    auto pick(const Map::BitboardLayout &layout, const Board &board, std::mt19937_64 &random) -> std::uint32_t {
+        std::vector<std::uint32_t> nodes;
+        if constexpr (std::is_same_v<Board, Map::CornerBoard>) {
+            layout.for_each_corner(board, [&](const std::uint32_t node) { nodes.push_back(node); });
+        } else {
+            layout.for_each_edge(board, [&](const std::uint32_t node) { nodes.push_back(node); });
+        }
+        return nodes.empty() ? Map::NO_NODE : nodes[random() % nodes.size()];
+    }
+
+    // Two rounds of a free settlement and a road next to it for every player, wherever there is room.
+    inline void play_random_setup(GameState &state, std::mt19937_64 &random) {
+        const auto &layout = state.get_map().get_topology().get_bitboard_layout();
+        for (int round = 0; round < 2; round++) {
+            for (PlayerId player = 0; player < static_cast<PlayerId>(state.get_player_count()); player++) {
+                if (const auto corner = pick(layout, state.get_setup_builds(), random); corner != Map::NO_NODE) {
+                    state.place_house(corner, House{.owner = player, .level = 1});
+                }
+                if (const auto edge = pick(layout, state.get_setup_roads(), random); edge != Map::NO_NODE) {
+                    state.place_road(edge, Road{player});
+                }
+            }
+        }
+    }
+
+    // One step of a random game for a random player: a roll, a few cards gained or lost, a house or a road
+    // somewhere legal, the robber moving, longest road changing hands, or the turn passing in any of the phases
+    // of a game.
+    inline void play_random_move(GameState &state, std::mt19937_64 &random) {
+        const auto &layout = state.get_map().get_topology().get_bitboard_layout();
+        const auto player = static_cast<PlayerId>(random() % state.get_player_count());
+        switch (random() % 7) {
+            case 0:
+                state.roll_dice();
+                break;
+            case 1:
+                state.add_resources(player, Map::RESOURCES[random() % Map::RESOURCES.size()],
+                                    static_cast<int>(random() % 7) - 3);
+                break;
+            case 2:
+                if (const auto corner = pick(layout, state.get_legal_builds(player), random);
+                    corner != Map::NO_NODE) {
+                    state.place_house(corner, House{.owner = player, .level = 1});
+                } else if (const auto city = pick(layout, state.get_legal_upgrades(player), random);
+                    city != Map::NO_NODE) {
+                    state.place_house(city, House{.owner = player, .level = 2});
+                }
+                break;
+            case 3:
+                if (const auto edge = pick(layout, state.get_legal_roads(player), random); edge != Map::NO_NODE) {
+                    state.place_road(edge, Road{player});
+                }
+                break;
+            case 4:
+                state.set_robber(static_cast<Map::HexId>(random() % state.get_map().get_topology().get_hex_count()));
+                break;
+            case 5:
+                state.set_longest_road_holder(random() % 2 == 0 ? NO_PLAYER : player);
+                break;
+            default:
+                state.set_turn(player, static_cast<GamePhase>(static_cast<int>(GamePhase::FREE_BUILDING) +
+                                                              static_cast<int>(random() % 5)));
+                break;
+        }
+    }
+
+    // A game after the setup rounds and `moves` steps of play_random_move.
+    inline auto make_random_game(const size_t radius, const size_t players, const std::uint64_t seed,
+                                 const int moves) -> GameState {
+        GameState state{Map::Map::build_map_of_size(radius, seed), players, static_cast<std::uint32_t>(seed)};
+        std::mt19937_64 random{seed};
+        play_random_setup(state, random);
+        for (int move = 0; move < moves; move++) {
+            play_random_move(state, random);
+        }
+        return state;
+    }
+} // namespace Game
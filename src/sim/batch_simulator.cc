@@ -0,0 +1,477 @@
+#include "batch_simulator.hh"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <random>
+#include <utility>
+
+#include "tournament.hh"
+
+namespace Sim {
+    namespace {
+        constexpr std::int16_t NO_OWNER = -1;
+        constexpr std::int16_t NO_ROBBER = -1;
+
+        template<typename T>
+        using Block = std::array<T, BatchSimulator::BLOCK>;
+
+        template<typename T>
+        auto load(const std::vector<T> &row, const size_t begin) -> Block<T> {
+            Block<T> block;
+            std::copy_n(row.begin() + static_cast<std::ptrdiff_t>(begin), BatchSimulator::BLOCK, block.begin());
+            return block;
+        }
+
+        template<typename T>
+        void store(std::vector<T> &row, const size_t begin, const Block<T> &block) {
+            std::copy_n(block.begin(), BatchSimulator::BLOCK, row.begin() + static_cast<std::ptrdiff_t>(begin));
+        }
+    } // namespace
+
+    BatchSimulator::BatchSimulator(const BatchConfig &config)
+        : m_config(config),
+          m_stride((config.games + BLOCK - 1) / BLOCK * BLOCK),
+          m_board(Map::Map::build_map_of_size(config.radius, config.seed)),
+          m_dice(m_stride, 1),
+          m_rolls(m_stride),
+          m_robbers(m_stride, NO_ROBBER),
+          m_running(m_stride, 0),
+          m_house_owners(m_board.get_topology().get_corner_count() * m_stride, NO_OWNER),
+          m_house_levels(m_board.get_topology().get_corner_count() * m_stride, 0),
+          m_resources(config.player_count * Map::RESOURCE_COUNT * m_stride, 0),
+          m_affordable(config.player_count * m_stride, 0),
+          m_pieces(config.games, Map::BoardBitboards(m_board.get_shared_topology(), config.player_count)),
+          m_winners(config.games, NO_PLAYER),
+          m_running_count(config.games),
+          m_mirror_of(config.games, -1) {
+        const auto &topology = m_board.get_topology();
+        std::int16_t desert = NO_ROBBER;
+        for (Map::HexId hex = 0; hex < topology.get_hex_count(); hex++) {
+            const Map::Hex *tile = m_board.get_hex(hex);
+            if (tile->resource == Map::Resource::NONE) {
+                desert = desert == NO_ROBBER ? static_cast<std::int16_t>(hex) : desert;
+                continue;
+            }
+            for (const Map::CornerId corner: topology.get_hex_corners(hex)) {
+                m_sites.push_back({static_cast<std::int16_t>(hex), static_cast<std::int16_t>(tile->number), corner,
+                                   tile->resource});
+            }
+        }
+        std::ranges::stable_sort(m_sites, {}, &ProductionSite::number);
+        std::ranges::fill(m_robbers, desert);
+        std::fill_n(m_running.begin(), config.games, 1);
+
+        for (size_t game = 0; game < config.games; game++) {
+            // xorshift32 must not start at zero
+            m_dice[game] = static_cast<std::uint32_t>(get_game_seed(config.seed, static_cast<std::uint32_t>(game))) | 1;
+        }
+
+        // Validate a random sample of the games
+        std::vector<size_t> games(config.games);
+        std::iota(games.begin(), games.end(), 0);
+        std::minstd_rand random_engine(static_cast<std::uint32_t>(config.seed));
+        std::ranges::shuffle(games, random_engine);
+        games.resize(std::min(config.validated_games, config.games));
+        std::ranges::sort(games);
+        m_mirrors.reserve(games.size());
+        for (const size_t game: games) {
+            m_mirror_of[game] = static_cast<std::int32_t>(m_mirrors.size());
+            Mirror &mirror = m_mirrors.emplace_back(game, Game::GameState(m_board.clone(), config.player_count, 0));
+            for (PlayerId player = 0; player < static_cast<PlayerId>(config.player_count); player++) {
+                mirror.state.add_resources(player, Game::ResourceBundle{} - mirror.state.get_resources(player));
+            }
+        }
+
+        m_setting_up = true;
+        for (size_t game = 0; game < config.games; game++) {
+            play_setup(game);
+        }
+        m_setting_up = false;
+        update_affordable();
+        validate();
+    }
+
+    auto BatchSimulator::next_random(const size_t game) -> std::uint32_t {
+        std::uint32_t x = m_dice[game];
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        m_dice[game] = x;
+        return x;
+    }
+
+    auto BatchSimulator::get_resources(const size_t game, const PlayerId player) const -> Game::ResourceBundle {
+        Game::ResourceBundle resources;
+        for (const Map::Resource resource: Map::RESOURCES) {
+            resources[resource] = m_resources[lane(resource_row(player, resource), game)];
+        }
+        return resources;
+    }
+
+    void BatchSimulator::add_resources(const size_t game, const PlayerId player,
+                                       const Game::ResourceBundle &resources) {
+        for (const Map::Resource resource: Map::RESOURCES) {
+            m_resources[lane(resource_row(player, resource), game)] += static_cast<std::int16_t>(resources[resource]);
+        }
+        update_affordable(game, player);
+        if (m_mirror_of[game] >= 0) {
+            m_mirrors[m_mirror_of[game]].state.add_resources(player, resources);
+        }
+    }
+
+    void BatchSimulator::place_house(const size_t game, const Map::CornerId corner, const House &house) {
+        m_house_owners[lane(corner, game)] = house.owner;
+        m_house_levels[lane(corner, game)] = house.level;
+        m_pieces[game].set_house(corner, house);
+        if (m_mirror_of[game] >= 0) {
+            Game::GameState &state = m_mirrors[m_mirror_of[game]].state;
+            const auto &layout = m_board.get_topology().get_bitboard_layout();
+            const Map::CornerBoard &legal_corners =
+                    house.level == 2 ? state.get_pieces().get_legal_upgrades(house.owner)
+                    : m_setting_up   ? state.get_setup_builds()
+                                     : state.get_legal_moves().get_settlements(house.owner);
+            const bool legal = layout.contains(legal_corners, corner);
+            if (!legal) {
+                report(game, "house on corner " + std::to_string(corner) + " is not legal in the scalar game");
+            }
+            state.place_house(corner, house);
+        }
+    }
+
+    void BatchSimulator::place_road(const size_t game, const Map::EdgeId edge, const PlayerId player) {
+        m_pieces[game].set_road(edge, Road{.owner = player});
+        if (m_mirror_of[game] >= 0) {
+            Game::GameState &state = m_mirrors[m_mirror_of[game]].state;
+            const auto &layout = m_board.get_topology().get_bitboard_layout();
+            const bool legal = m_setting_up ? layout.contains(state.get_setup_roads(), edge)
+                                            : layout.contains(state.get_legal_moves().get_roads(player), edge);
+            if (!legal) {
+                report(game, "road on edge " + std::to_string(edge) + " is not legal in the scalar game");
+            }
+            state.place_road(edge, Road{.owner = player});
+        }
+    }
+
+    void BatchSimulator::play_setup(const size_t game) {
+        const auto &layout = m_board.get_topology().get_bitboard_layout();
+        const auto player_count = static_cast<PlayerId>(m_config.player_count);
+        std::vector<std::uint32_t> choices;
+
+        auto place = [&](const PlayerId player, const bool second_round) {
+            choices.clear();
+            layout.for_each_corner(m_pieces[game].get_free_corners(), [&](const Map::CornerId corner) {
+                choices.push_back(corner);
+            });
+            if (choices.empty()) {
+                return;
+            }
+            const Map::CornerId corner = choices[next_random(game) % choices.size()];
+            place_house(game, corner, House{.owner = player, .level = 1});
+            if (second_round) {
+                Game::ResourceBundle payout;
+                for (const Map::HexId hex: m_board.get_topology().get_corner_hexes(corner)) {
+                    payout[m_board.get_hex(hex)->resource]++;
+                }
+                payout[Map::Resource::NONE] = 0;
+                add_resources(game, player, payout);
+            }
+
+            choices.clear();
+            layout.for_each_edge(m_pieces[game].get_legal_roads_from(corner), [&](const Map::EdgeId edge) {
+                choices.push_back(edge);
+            });
+            if (!choices.empty()) {
+                place_road(game, choices[next_random(game) % choices.size()], player);
+            }
+        };
+
+        for (PlayerId player = 0; player < player_count; player++) {
+            place(player, false);
+        }
+        for (PlayerId player = player_count; player-- > 0;) {
+            place(player, true);
+        }
+    }
+
+    void BatchSimulator::roll_dice() {
+        for (size_t begin = 0; begin < m_stride; begin += BLOCK) {
+            Block<std::uint32_t> dice = load(m_dice, begin);
+            Block<std::int16_t> rolls;
+            for (size_t i = 0; i < BLOCK; i++) {
+                std::uint32_t x = dice[i];
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                dice[i] = x;
+                // One die from each 16 bit half, scaled onto 0..5 without a division
+                const std::uint32_t first = (x & 0xffff) * 6 >> 16;
+                const std::uint32_t second = (x >> 16) * 6 >> 16;
+                rolls[i] = static_cast<std::int16_t>(first + second + 2);
+            }
+            store(m_dice, begin, dice);
+            store(m_rolls, begin, rolls);
+        }
+    }
+
+    void BatchSimulator::produce() {
+        for (size_t begin = 0; begin < m_stride; begin += BLOCK) {
+            const Block<std::int16_t> running = load(m_running, begin);
+            if (std::ranges::none_of(running, [](const std::int16_t lane) { return lane != 0; })) {
+                continue;
+            }
+            const Block<std::int16_t> rolls = load(m_rolls, begin);
+            const Block<std::int16_t> robbers = load(m_robbers, begin);
+            std::uint32_t rolled = 0;
+            for (const std::int16_t roll: rolls) {
+                rolled |= 1u << roll;
+            }
+            for (const ProductionSite &site: m_sites) {
+                // Sites are grouped by number, so this skips whole groups nobody in the block rolled
+                if ((rolled >> site.number & 1) == 0) {
+                    continue;
+                }
+                const Block<std::int16_t> owners = load(m_house_owners, lane(site.corner, begin));
+                const Block<std::int16_t> levels = load(m_house_levels, lane(site.corner, begin));
+                Block<std::int16_t> amounts;
+                // Masks instead of branches, so both loops stay straight line vector code
+                for (size_t i = 0; i < BLOCK; i++) {
+                    const auto produces = static_cast<std::int16_t>(
+                        -static_cast<int>((rolls[i] == site.number) & (robbers[i] != site.hex)));
+                    amounts[i] = static_cast<std::int16_t>(levels[i] * running[i] & produces);
+                }
+                for (PlayerId player = 0; player < static_cast<PlayerId>(m_config.player_count); player++) {
+                    const size_t row = lane(resource_row(player, site.resource), begin);
+                    Block<std::int16_t> resources = load(m_resources, row);
+                    for (size_t i = 0; i < BLOCK; i++) {
+                        const auto owned = static_cast<std::int16_t>(-static_cast<int>(owners[i] == player));
+                        resources[i] = static_cast<std::int16_t>(resources[i] + (amounts[i] & owned));
+                    }
+                    store(m_resources, row, resources);
+                }
+            }
+        }
+    }
+
+    void BatchSimulator::update_affordable() {
+        for (size_t begin = 0; begin < m_stride; begin += BLOCK) {
+            for (PlayerId player = 0; player < static_cast<PlayerId>(m_config.player_count); player++) {
+                std::array<Block<std::int16_t>, Map::RESOURCE_COUNT> hand;
+                for (const Map::Resource resource: Map::RESOURCES) {
+                    hand[static_cast<size_t>(resource)] = load(m_resources, lane(resource_row(player, resource), begin));
+                }
+                Block<Game::RecipeMask> affordable{};
+                for (const auto &[recipe, cost]: Game::RECIPES) {
+                    // As ResourceBundle::covers: OR the shortfalls, the sign bit says whether any lane fell short
+                    Block<std::int16_t> shortfall{};
+                    for (const Map::Resource resource: Map::RESOURCES) {
+                        const auto &held = hand[static_cast<size_t>(resource)];
+                        const auto needed = static_cast<std::int16_t>(cost[resource]);
+                        for (size_t i = 0; i < BLOCK; i++) {
+                            shortfall[i] = static_cast<std::int16_t>(shortfall[i] | (held[i] - needed));
+                        }
+                    }
+                    const Game::RecipeMask bit = Game::recipe_bit(recipe);
+                    for (size_t i = 0; i < BLOCK; i++) {
+                        affordable[i] = static_cast<Game::RecipeMask>(affordable[i] | (bit & ~(shortfall[i] >> 15)));
+                    }
+                }
+                store(m_affordable, lane(player, begin), affordable);
+            }
+        }
+    }
+
+    void BatchSimulator::update_affordable(const size_t game, const PlayerId player) {
+        m_affordable[lane(player, game)] = Game::get_affordable_recipes(get_resources(game, player));
+    }
+
+    void BatchSimulator::handle_seven(const size_t game) {
+        for (PlayerId victim = 0; victim < static_cast<PlayerId>(m_config.player_count); victim++) {
+            const Game::ResourceBundle hand = get_resources(game, victim);
+            const int total = hand.total();
+            if (total <= static_cast<int>(m_config.rules.hand_limit)) {
+                continue;
+            }
+            Game::ResourceBundle kept = hand;
+            for (int discarded = 0; discarded < total / 2; discarded++) {
+                const auto largest = std::ranges::max(Map::RESOURCES, {}, [&](const Map::Resource resource) {
+                    return kept[resource];
+                });
+                kept[largest]--;
+            }
+            add_resources(game, victim, kept - hand);
+        }
+
+        const auto hex_count = static_cast<std::uint32_t>(m_board.get_topology().get_hex_count());
+        if (hex_count > 1) {
+            auto hex = static_cast<std::int16_t>(next_random(game) % hex_count);
+            if (hex == m_robbers[game]) {
+                hex = static_cast<std::int16_t>((hex + 1) % hex_count);
+            }
+            m_robbers[game] = hex;
+            if (m_mirror_of[game] >= 0) {
+                m_mirrors[m_mirror_of[game]].state.set_robber(static_cast<Map::HexId>(hex));
+            }
+        }
+    }
+
+    auto BatchSimulator::trade_towards(const size_t game, const PlayerId player, const Game::Recipe recipe) -> bool {
+        const Game::ResourceBundle hand = get_resources(game, player);
+        const Game::ResourceBundle &cost = Game::get_recipe(recipe);
+        const auto rate = static_cast<int>(m_config.rules.bank_trade_rate);
+        const auto missing = std::ranges::find_if(Map::RESOURCES, [&](const Map::Resource resource) {
+            return hand[resource] < cost[resource];
+        });
+        const auto surplus = std::ranges::find_if(Map::RESOURCES, [&](const Map::Resource resource) {
+            return hand[resource] - cost[resource] >= rate;
+        });
+        if (missing == Map::RESOURCES.end() || surplus == Map::RESOURCES.end()) {
+            return false;
+        }
+        add_resources(game, player, Game::ResourceBundle{{*surplus, -rate}, {*missing, 1}});
+        return true;
+    }
+
+    void BatchSimulator::build(const size_t game, const PlayerId player) {
+        const auto &layout = m_board.get_topology().get_bitboard_layout();
+        const Rules &rules = m_config.rules;
+        auto can_afford = [&](const Game::Recipe recipe) {
+            return (m_affordable[lane(player, game)] & Game::recipe_bit(recipe)) != 0;
+        };
+        auto first_of = [&](const Map::CornerBoard &corners) {
+            Map::CornerId first = Map::NO_NODE;
+            layout.for_each_corner(corners, [&](const Map::CornerId corner) { first = std::min(first, corner); });
+            return first;
+        };
+
+        while (true) {
+            const Map::BoardBitboards &pieces = m_pieces[game];
+            if (can_afford(Game::Recipe::CITY) && pieces.get_cities(player).count() < rules.max_cities &&
+                pieces.get_settlements(player).any()) {
+                add_resources(game, player, Game::cost_of(Game::Recipe::CITY));
+                place_house(game, first_of(pieces.get_settlements(player)), House{.owner = player, .level = 2});
+                continue;
+            }
+            const Map::CornerBoard settlements = pieces.get_legal_settlements(player);
+            if (can_afford(Game::Recipe::SETTLEMENT) &&
+                pieces.get_settlements(player).count() < rules.max_settlements && settlements.any()) {
+                add_resources(game, player, Game::cost_of(Game::Recipe::SETTLEMENT));
+                place_house(game, first_of(settlements), House{.owner = player, .level = 1});
+                continue;
+            }
+            if (can_afford(Game::Recipe::ROAD) && pieces.get_roads(player).count() < rules.max_roads &&
+                !settlements.any()) {
+                // Head for a corner that can still be settled
+                Map::EdgeBoard roads = pieces.get_legal_roads(player);
+                Map::EdgeBoard towards_free = layout.get_corner_edges(pieces.get_free_corners());
+                towards_free &= roads;
+                Map::EdgeId road = Map::NO_NODE;
+                layout.for_each_edge(towards_free.any() ? towards_free : roads, [&](const Map::EdgeId edge) {
+                    road = std::min(road, edge);
+                });
+                if (road != Map::NO_NODE) {
+                    add_resources(game, player, Game::cost_of(Game::Recipe::ROAD));
+                    place_road(game, road, player);
+                    continue;
+                }
+            }
+            // Nothing to build: trade a surplus towards the next piece the player is saving for
+            Game::Recipe goal = Game::Recipe::CITY;
+            if (pieces.get_settlements(player).count() < rules.max_settlements) {
+                if (settlements.any()) {
+                    goal = Game::Recipe::SETTLEMENT;
+                } else if (pieces.get_roads(player).count() < rules.max_roads) {
+                    goal = Game::Recipe::ROAD;
+                }
+            }
+            if (!trade_towards(game, player, goal)) {
+                break;
+            }
+        }
+
+        const Map::BoardBitboards &pieces = m_pieces[game];
+        if (pieces.get_settlements(player).count() + 2 * pieces.get_cities(player).count() >= rules.victory_points) {
+            m_winners[game] = player;
+            m_running[game] = 0;
+            m_running_count--;
+        }
+    }
+
+    auto BatchSimulator::play_turn() -> bool {
+        if (m_running_count == 0 || m_turn >= m_config.rules.turn_limit) {
+            return false;
+        }
+        const auto player = static_cast<PlayerId>(m_turn % m_config.player_count);
+
+        roll_dice();
+        for (size_t game = 0; game < m_config.games; game++) {
+            if (m_rolls[game] == 7 && m_running[game] != 0) {
+                handle_seven(game);
+            }
+        }
+        produce();
+        for (Mirror &mirror: m_mirrors) {
+            if (m_running[mirror.game] != 0) {
+                mirror.state.produce(m_rolls[mirror.game]);
+            }
+        }
+        update_affordable();
+
+        constexpr Game::RecipeMask builds = Game::recipe_bit(Game::Recipe::ROAD) |
+                                            Game::recipe_bit(Game::Recipe::SETTLEMENT) |
+                                            Game::recipe_bit(Game::Recipe::CITY);
+        const Game::RecipeMask *affordable = &m_affordable[lane(player, 0)];
+        const auto rate = static_cast<std::int16_t>(m_config.rules.bank_trade_rate);
+        for (size_t game = 0; game < m_config.games; game++) {
+            bool can_trade = false;
+            for (const Map::Resource resource: Map::RESOURCES) {
+                can_trade |= m_resources[lane(resource_row(player, resource), game)] >= rate;
+            }
+            if (((affordable[game] & builds) != 0 || can_trade) && m_running[game] != 0) {
+                build(game, player);
+            }
+        }
+        validate();
+        // The mirrors never undo; keep their logs from growing with the game
+        for (Mirror &mirror: m_mirrors) {
+            mirror.state.clear_undo_log();
+        }
+
+        m_turn++;
+        return m_running_count != 0 && m_turn < m_config.rules.turn_limit;
+    }
+
+    void BatchSimulator::report(const size_t game, const std::string &problem) {
+        if (!m_validation_error) {
+            m_validation_error = "game " + std::to_string(game) + ", turn " + std::to_string(m_turn) + ": " + problem;
+        }
+    }
+
+    void BatchSimulator::validate() {
+        for (const Mirror &mirror: m_mirrors) {
+            for (PlayerId player = 0; player < static_cast<PlayerId>(m_config.player_count); player++) {
+                const Game::ResourceBundle batch = get_resources(mirror.game, player);
+                const Game::ResourceBundle &scalar = mirror.state.get_resources(player);
+                for (const Map::Resource resource: Map::RESOURCES) {
+                    if (batch[resource] != scalar[resource]) {
+                        report(mirror.game, "player " + std::to_string(player) + " holds " +
+                                            std::to_string(batch[resource]) + " of resource " +
+                                            std::to_string(static_cast<int>(resource)) + ", the scalar game " +
+                                            std::to_string(scalar[resource]));
+                    }
+                }
+                if (get_affordable_recipes(mirror.game, player) != mirror.state.get_affordable_recipes(player)) {
+                    report(mirror.game, "player " + std::to_string(player) + " can afford different recipes");
+                }
+                const Map::BoardBitboards &pieces = m_pieces[mirror.game];
+                if (pieces.get_settlements(player).count() + 2 * pieces.get_cities(player).count() !=
+                    mirror.state.get_building_points(player)) {
+                    report(mirror.game, "player " + std::to_string(player) + " has a different number of points");
+                }
+            }
+            if (mirror.state.get_robber() != static_cast<Map::HexId>(m_robbers[mirror.game]) &&
+                m_robbers[mirror.game] != NO_ROBBER) {
+                report(mirror.game, "the robber is on another hex");
+            }
+        }
+    }
+} // namespace Sim
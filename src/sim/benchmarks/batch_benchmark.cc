@@ -0,0 +1,75 @@
+// Plays batches of games in lockstep with BatchSimulator and reports game turns per second against batch size,
+// next to the scalar Simulator playing the same number of games one after the other. Also runs a batch in
+// validation mode, which replays a sample of the games on GameState and cross-checks every turn.
+//
+// Usage: batch_benchmark [games]
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "batch_simulator.hh"
+#include "map.hh"
+#include "policy.hh"
+#include "simulator.hh"
+#include "tournament.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    volatile std::uint64_t sink = 0;
+
+    struct Throughput {
+        double game_turns_per_second;
+        double games_per_second;
+    };
+
+    auto measure_batch(const Sim::BatchConfig &config) -> Throughput {
+        const auto start = Clock::now();
+        Sim::BatchSimulator batch(config);
+        std::uint64_t game_turns = 0;
+        do {
+            game_turns += batch.get_running_count();
+        } while (batch.play_turn());
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        sink = sink + batch.get_turn();
+        return {static_cast<double>(game_turns) / seconds, static_cast<double>(config.games) / seconds};
+    }
+
+    auto measure_scalar(const size_t games) -> Throughput {
+        Sim::GreedyPolicy greedy;
+        const std::array<Sim::Policy *, 4> seats{&greedy, &greedy, &greedy, &greedy};
+        const auto start = Clock::now();
+        std::uint64_t game_turns = 0;
+        for (size_t game = 0; game < games; game++) {
+            const auto seed = static_cast<std::uint32_t>(Sim::get_game_seed(0, static_cast<std::uint32_t>(game)));
+            Sim::Simulator simulator(Map::Map::build_map_of_size(2, 0), seats, seed);
+            game_turns += simulator.play().turns;
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return {static_cast<double>(game_turns) / seconds, static_cast<double>(games) / seconds};
+    }
+} // namespace
+
+auto main(const int argc, char **argv) -> int {
+    const size_t max_games = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+
+    std::printf("%-10s %-10s %18s %12s\n", "engine", "games", "game turns/s", "games/s");
+    const Throughput scalar = measure_scalar(std::min<size_t>(max_games, 1024));
+    std::printf("%-10s %-10zu %18.3e %12.0f\n", "scalar", std::min<size_t>(max_games, 1024),
+                scalar.game_turns_per_second, scalar.games_per_second);
+    for (size_t games = 64; games <= max_games; games *= 4) {
+        const Throughput batch = measure_batch({.games = games});
+        std::printf("%-10s %-10zu %18.3e %12.0f\n", "batch", games, batch.game_turns_per_second,
+                    batch.games_per_second);
+    }
+
+    Sim::BatchSimulator validated({.games = max_games, .validated_games = 64});
+    while (validated.play_turn()) {
+    }
+    std::printf("validation of 64 games: %s\n",
+                validated.get_validation_error() ? validated.get_validation_error()->c_str() : "no difference");
+    return validated.get_validation_error() ? 1 : 0;
+}
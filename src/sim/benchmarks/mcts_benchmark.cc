@@ -0,0 +1,70 @@
+// Searches the same position for a fixed time on 1, 2, 4, ... threads up to the hardware thread count and reports
+// playouts per second, per thread, and the parallel efficiency against the single thread search. All threads
+// share one tree, so the loss in efficiency is what contention on the tree and virtual loss cost.
+//
+// Usage: mcts_benchmark [milliseconds per search] [max threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include "game_flow.hh"
+#include "mcts.hh"
+
+namespace {
+    volatile std::uint64_t sink = 0;
+
+    // Standard board after random setup rounds and the first roll, empty hands to start with
+    auto make_position() -> Game::GameState {
+        const Sim::Rules rules;
+        Game::GameState state{Map::Map::build_map_of_size(2, 1), 4, 1};
+        for (PlayerId player = 0; player < 4; player++) {
+            state.add_resources(player, Game::ResourceBundle{} - state.get_resources(player));
+        }
+        std::minstd_rand random_engine(1);
+        Sim::MoveList moves;
+        while (state.get_phase() != Game::GamePhase::ROLL) {
+            Sim::generate_moves(state, rules, moves);
+            Sim::apply_move(state, rules, moves[random_engine() % moves.size()]);
+        }
+        Sim::apply_move(state, rules, {Sim::MoveKind::ROLL, 8});
+        return state;
+    }
+} // namespace
+
+auto main(const int argc, char **argv) -> int {
+    const auto budget = std::chrono::milliseconds(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000);
+    const size_t hardware_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                             : std::max<size_t>(1, std::thread::hardware_concurrency());
+    const Game::GameState position = make_position();
+
+    std::printf("%lld ms per search, up to %zu threads\n", static_cast<long long>(budget.count()),
+                hardware_threads);
+    std::printf("%-8s %14s %18s %10s %10s %10s\n", "threads", "playouts/s", "playouts/s/thread", "nodes",
+                "speedup", "efficiency");
+    double single_thread = 0;
+    for (size_t threads = 1;; threads = std::min(threads * 2, hardware_threads)) {
+        Sim::MctsSearch search({.thread_count = threads, .node_capacity = 1 << 22, .seed = 1});
+        const auto start = std::chrono::steady_clock::now();
+        const Sim::SearchResult result = search.search(position, budget);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sink = sink + result.move.target;
+
+        const double playouts_per_second = static_cast<double>(result.playouts) / seconds;
+        if (threads == 1) {
+            single_thread = playouts_per_second;
+        }
+        const double speedup = playouts_per_second / single_thread;
+        std::printf("%-8zu %14.0f %18.0f %10u %9.2fx %9.0f%%\n", threads, playouts_per_second,
+                    playouts_per_second / static_cast<double>(threads), result.nodes, speedup,
+                    100 * speedup / static_cast<double>(threads));
+        if (threads == hardware_threads) {
+            break;
+        }
+    }
+    return 0;
+}
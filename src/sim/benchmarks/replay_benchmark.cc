@@ -0,0 +1,92 @@
+// Records self-play games into replay logs at several keyframe intervals and reports the log size per turn,
+// the rate of playing a whole log back, and the latency of seeking to random turns. An interval longer than
+// any game leaves only the starting keyframe, so its seeks replay from the start.
+//
+// Usage: replay_benchmark [games]
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "map.hh"
+#include "policy.hh"
+#include "replay.hh"
+#include "simulator.hh"
+#include "tournament.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    volatile std::uint64_t sink = 0;
+
+    auto record_games(const size_t games, const std::uint32_t keyframe_interval)
+        -> std::vector<std::vector<std::uint8_t> > {
+        Sim::GreedyPolicy greedy;
+        Sim::RandomPolicy random{0};
+        const std::array<Sim::Policy *, 4> seats{&greedy, &random, &greedy, &greedy};
+        std::vector<std::vector<std::uint8_t> > logs;
+        for (size_t game = 0; game < games; game++) {
+            const auto seed = static_cast<std::uint32_t>(Sim::get_game_seed(0, static_cast<std::uint32_t>(game)));
+            random.seed(seed);
+            Sim::Simulator simulator(Map::Map::build_map_of_size(2, seed), seats, seed);
+            Sim::ReplayWriter writer(simulator.get_state(), Sim::Rules{}, keyframe_interval);
+            simulator.record_to(&writer);
+            (void) simulator.play();
+            const auto bytes = writer.get_bytes();
+            logs.emplace_back(bytes.begin(), bytes.end());
+        }
+        return logs;
+    }
+} // namespace
+
+auto main(const int argc, char **argv) -> int {
+    const size_t games = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+    constexpr size_t seeks_per_game = 50;
+
+    std::printf("%zu games\n", games);
+    std::printf("%-10s %14s %16s %16s %14s\n", "interval", "bytes/turn", "playback turns/s", "seek mean us",
+                "seek max us");
+    for (const std::uint32_t interval: {1u, 4u, 16u, 64u, 1u << 30}) {
+        const auto logs = record_games(games, interval);
+
+        std::uint64_t bytes = 0;
+        std::uint64_t turns = 0;
+        auto start = Clock::now();
+        for (const auto &log: logs) {
+            Sim::ReplayReader reader(log);
+            while (reader.next()) {
+            }
+            bytes += log.size();
+            turns += reader.get_turn_count();
+            sink = sink + reader.get_state().get_hash();
+        }
+        const double playback = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::mt19937 random_engine(interval);
+        double total_seek = 0;
+        double max_seek = 0;
+        for (const auto &log: logs) {
+            Sim::ReplayReader reader(log);
+            for (size_t seek = 0; seek < seeks_per_game; seek++) {
+                const auto turn = std::uniform_int_distribution<std::uint32_t>(0, reader.get_turn_count())(
+                    random_engine);
+                start = Clock::now();
+                reader.seek(turn);
+                const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                total_seek += seconds;
+                max_seek = std::max(max_seek, seconds);
+                sink = sink + reader.get_state().get_hash();
+            }
+        }
+
+        std::printf(interval < 1u << 30 ? "%-10u" : "none      ", interval);
+        std::printf(" %14.1f %16.0f %16.1f %14.1f\n", static_cast<double>(bytes) / static_cast<double>(turns),
+                    static_cast<double>(turns) / playback,
+                    1e6 * total_seek / static_cast<double>(logs.size() * seeks_per_game), 1e6 * max_seek);
+    }
+    return 0;
+}
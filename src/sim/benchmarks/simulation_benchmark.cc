@@ -0,0 +1,101 @@
+// Plays complete headless games, board generation and setup included, and reports how many finish per second
+// together with the latency of a single turn. Every bot, analysis and regression run is bounded by this number.
+//
+// Usage: simulation_benchmark [radius]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "map.hh"
+#include "policy.hh"
+#include "simulator.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr auto minimum_measure_time = std::chrono::seconds(1);
+    constexpr size_t player_count = 4;
+
+    volatile std::uint64_t sink = 0;
+
+    struct Measurement {
+        double games_per_second = 0;
+        double turns_per_game = 0;
+        double decided = 0;
+        std::vector<double> turn_nanoseconds;
+    };
+
+    // Plays seeded games until the minimum measure time elapsed, timing every turn on its own.
+    auto measure(const size_t radius, const std::array<Sim::Policy *, player_count> &seats) -> Measurement {
+        Measurement measurement;
+        std::uint64_t games = 0;
+        std::uint64_t turns = 0;
+        std::uint64_t winners = 0;
+        const auto start = Clock::now();
+        auto elapsed = Clock::duration::zero();
+        while (elapsed < minimum_measure_time) {
+            const auto seed = static_cast<std::uint32_t>(games);
+            Sim::Simulator simulator(Map::Map::build_map_of_size(radius, seed), seats, seed);
+            simulator.play_setup();
+            bool running = true;
+            while (running) {
+                const auto turn_start = Clock::now();
+                running = simulator.play_turn();
+                measurement.turn_nanoseconds.push_back(
+                    std::chrono::duration<double, std::nano>(Clock::now() - turn_start).count());
+            }
+            turns += simulator.get_turn();
+            winners += simulator.get_winner() != NO_PLAYER;
+            sink = sink + simulator.get_turn();
+            games++;
+            elapsed = Clock::now() - start;
+        }
+        measurement.games_per_second = static_cast<double>(games) / std::chrono::duration<double>(elapsed).count();
+        measurement.turns_per_game = static_cast<double>(turns) / static_cast<double>(games);
+        measurement.decided = static_cast<double>(winners) / static_cast<double>(games);
+        return measurement;
+    }
+
+    auto percentile(std::vector<double> &values, const double fraction) -> double {
+        const auto index = static_cast<size_t>(fraction * static_cast<double>(values.size() - 1));
+        std::ranges::nth_element(values, values.begin() + static_cast<std::ptrdiff_t>(index));
+        return values[index];
+    }
+} // namespace
+
+auto main(const int argc, char **argv) -> int {
+    const size_t radius = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2;
+
+    std::array<Sim::RandomPolicy, player_count> random_policies{
+        Sim::RandomPolicy{1}, Sim::RandomPolicy{2}, Sim::RandomPolicy{3}, Sim::RandomPolicy{4}};
+    Sim::GreedyPolicy greedy_policy;
+
+    const std::array<std::pair<const char *, std::array<Sim::Policy *, player_count> >, 3> matchups{{
+        {"random", {&random_policies[0], &random_policies[1], &random_policies[2], &random_policies[3]}},
+        {"greedy", {&greedy_policy, &greedy_policy, &greedy_policy, &greedy_policy}},
+        {"mixed", {&greedy_policy, &random_policies[0], &greedy_policy, &random_policies[1]}},
+    }};
+
+    std::printf("radius %zu, %zu players\n", radius, player_count);
+    std::printf("%-8s %12s %12s %9s %14s %14s %14s\n", "policies", "games/s", "turns/game", "decided",
+                "turn mean ns", "turn p50 ns", "turn p99 ns");
+    for (const auto &[name, seats]: matchups) {
+        Measurement measurement = measure(radius, seats);
+        auto &latencies = measurement.turn_nanoseconds;
+        double total = 0;
+        for (const double latency: latencies) {
+            total += latency;
+        }
+        const double mean = total / static_cast<double>(latencies.size());
+        std::printf("%-8s %12.0f %12.1f %8.0f%% %14.0f %14.0f %14.0f\n", name, measurement.games_per_second,
+                    measurement.turns_per_game, 100 * measurement.decided, mean, percentile(latencies, 0.5),
+                    percentile(latencies, 0.99));
+    }
+    return 0;
+}
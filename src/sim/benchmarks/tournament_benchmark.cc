@@ -0,0 +1,58 @@
+// Runs the same tournament on 1, 2, 4, ... threads up to the hardware thread count and reports games per second
+// and the parallel efficiency against the single thread run. Games are independent, so anything short of
+// linear scaling is contention in the pool, the allocator or shared state.
+//
+// Usage: tournament_benchmark [games] [max threads]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "policy.hh"
+#include "tournament.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    volatile std::uint64_t sink = 0;
+} // namespace
+
+auto main(const int argc, char **argv) -> int {
+    const auto games = static_cast<std::uint32_t>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000);
+    const size_t hardware_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10)
+                                             : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    const std::vector<Sim::PolicyFactory> entrants{
+        [] { return std::make_unique<Sim::GreedyPolicy>(); },
+        [] { return std::make_unique<Sim::RandomPolicy>(0); },
+        [] { return std::make_unique<Sim::GreedyPolicy>(); },
+        [] { return std::make_unique<Sim::RandomPolicy>(0); },
+    };
+
+    std::printf("%zu games, up to %zu threads\n", static_cast<size_t>(games), hardware_threads);
+    std::printf("%-8s %12s %10s %10s\n", "threads", "games/s", "speedup", "efficiency");
+    double single_thread = 0;
+    for (size_t threads = 1;; threads = std::min(threads * 2, hardware_threads)) {
+        const auto start = Clock::now();
+        const Sim::TournamentStats stats = run_tournament({.games = games, .thread_count = threads}, entrants);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        sink = sink + stats.turns;
+
+        const double games_per_second = static_cast<double>(stats.games) / seconds;
+        if (threads == 1) {
+            single_thread = games_per_second;
+        }
+        const double speedup = games_per_second / single_thread;
+        std::printf("%-8zu %12.0f %9.2fx %9.0f%%\n", threads, games_per_second, speedup,
+                    100 * speedup / static_cast<double>(threads));
+        if (threads == hardware_threads) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+#include "game_flow.hh"
+#include <algorithm>
+#include <bit>
+
+namespace Sim {
+    namespace {
+        auto get_largest_pile(const Game::ResourceBundle &hand) -> Map::Resource {
+            return std::ranges::max(Map::RESOURCES, {}, [&](const Map::Resource resource) {
+                return hand[resource];
+            });
+        }
+
+        // Who sets next in the setup rounds, once `houses` settlements stand: forward through the players,
+        // then back.
+        auto get_next_setup_player(const PlayerId player, const size_t houses, const size_t player_count)
+            -> PlayerId {
+            if (houses < player_count) {
+                return static_cast<PlayerId>(player + 1);
+            }
+            return houses == player_count ? player : static_cast<PlayerId>(player - 1);
+        }
+    } // namespace
+
+    void generate_moves(const Game::GameState &state, const Rules &rules, MoveList &moves) {
+        moves.clear();
+        const auto &layout = state.get_map().get_topology().get_bitboard_layout();
+        const PlayerId player = state.get_current_player();
+        switch (state.get_phase()) {
+            case Game::GamePhase::ROLL: {
+                // Each value left once, lowest first, whatever order the deck is in
+                const Game::RollManager &deck = state.get_roll_manager();
+                std::uint32_t values = 0;
+                for (size_t position = 0; position < deck.get_queue_size(); position++) {
+                    values |= 1u << deck.peek(position);
+                }
+                for (; values != 0; values &= values - 1) {
+                    moves.push_back({MoveKind::ROLL, static_cast<std::uint32_t>(std::countr_zero(values))});
+                }
+                break;
+            }
+            case Game::GamePhase::FREE_BUILDING:
+                layout.for_each_corner(state.get_setup_builds(), [&](const Map::CornerId corner) {
+                    moves.push_back({MoveKind::SETUP_SETTLEMENT, corner});
+                });
+                break;
+            case Game::GamePhase::FREE_ROAD:
+                layout.for_each_edge(state.get_setup_roads(), [&](const Map::EdgeId edge) {
+                    moves.push_back({MoveKind::SETUP_ROAD, edge});
+                });
+                break;
+            case Game::GamePhase::MOVE_ROBBER:
+                for (Map::HexId hex = 0; hex < state.get_map().get_topology().get_hex_count(); hex++) {
+                    if (hex != state.get_robber()) {
+                        moves.push_back({MoveKind::MOVE_ROBBER, hex});
+                    }
+                }
+                break;
+            case Game::GamePhase::STEAL:
+                // Each resource the victim holds once, whatever the size of its pile
+                if (const PlayerId victim = get_robbery_victim(state); victim != NO_PLAYER) {
+                    for (const Map::Resource resource: Map::RESOURCES) {
+                        if (state.get_resources(victim)[resource] > 0) {
+                            moves.push_back({MoveKind::STEAL, static_cast<std::uint32_t>(resource)});
+                        }
+                    }
+                }
+                break;
+            case Game::GamePhase::PLAYER_TURN: {
+                const auto &pieces = state.get_pieces();
+                moves.push_back({MoveKind::END_TURN});
+                if (pieces.get_cities(player).count() < rules.max_cities) {
+                    layout.for_each_corner(state.get_legal_upgrades(player), [&](const Map::CornerId corner) {
+                        moves.push_back({MoveKind::BUILD_CITY, corner});
+                    });
+                }
+                if (pieces.get_settlements(player).count() < rules.max_settlements) {
+                    layout.for_each_corner(state.get_legal_builds(player), [&](const Map::CornerId corner) {
+                        moves.push_back({MoveKind::BUILD_SETTLEMENT, corner});
+                    });
+                }
+                if (pieces.get_roads(player).count() < rules.max_roads) {
+                    layout.for_each_edge(state.get_legal_roads(player), [&](const Map::EdgeId edge) {
+                        moves.push_back({MoveKind::BUILD_ROAD, edge});
+                    });
+                }
+                const Game::ResourceBundle &hand = state.get_resources(player);
+                for (const Map::Resource give: Map::RESOURCES) {
+                    if (hand[give] < static_cast<int>(rules.bank_trade_rate)) {
+                        continue;
+                    }
+                    for (const Map::Resource get: Map::RESOURCES) {
+                        if (get != give) {
+                            moves.push_back({MoveKind::BANK_TRADE, get_trade_target(give, get)});
+                        }
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void apply_move(Game::GameState &state, const Rules &rules, const Move &move) {
+        const PlayerId player = state.get_current_player();
+        const size_t player_count = state.get_player_count();
+        switch (move.kind) {
+            case MoveKind::SETUP_SETTLEMENT: {
+                const bool second_round = state.get_pieces().get_houses().count() >= player_count;
+                state.place_house(move.target, House{.owner = player, .level = 1});
+                if (second_round) {
+                    const auto &map = state.get_map();
+                    for (const Map::HexId hex: map.get_topology().get_corner_hexes(move.target)) {
+                        if (const Map::Resource resource = map.get_hex(hex)->resource;
+                            resource != Map::Resource::NONE) {
+                            state.add_resources(player, resource, 1);
+                        }
+                    }
+                }
+                update_longest_road(state, rules);
+                state.set_turn(player, Game::GamePhase::FREE_ROAD);
+                break;
+            }
+            case MoveKind::SETUP_ROAD: {
+                state.place_road(move.target, Road{.owner = player});
+                update_longest_road(state, rules);
+                const size_t houses = state.get_pieces().get_houses().count();
+                if (houses >= 2 * player_count) {
+                    state.set_turn(0, Game::GamePhase::ROLL);
+                } else {
+                    state.set_turn(get_next_setup_player(player, houses, player_count),
+                                   Game::GamePhase::FREE_BUILDING);
+                }
+                break;
+            }
+            case MoveKind::BUILD_ROAD:
+                state.add_resources(player, Game::cost_of(Game::Recipe::ROAD));
+                state.place_road(move.target, Road{.owner = player});
+                update_longest_road(state, rules);
+                break;
+            case MoveKind::BUILD_SETTLEMENT:
+                state.add_resources(player, Game::cost_of(Game::Recipe::SETTLEMENT));
+                state.place_house(move.target, House{.owner = player, .level = 1});
+                update_longest_road(state, rules);
+                break;
+            case MoveKind::BUILD_CITY:
+                state.add_resources(player, Game::cost_of(Game::Recipe::CITY));
+                state.place_house(move.target, House{.owner = player, .level = 2});
+                break;
+            case MoveKind::BANK_TRADE:
+                state.add_resources(player, Game::ResourceBundle{
+                                        {get_traded_away(move), -static_cast<int>(rules.bank_trade_rate)},
+                                        {get_traded_for(move), 1},
+                                    });
+                break;
+            case MoveKind::MOVE_ROBBER:
+                state.set_robber(move.target);
+                state.set_turn(player, get_robbery_victim(state) != NO_PLAYER ? Game::GamePhase::STEAL
+                                                                              : Game::GamePhase::PLAYER_TURN);
+                break;
+            case MoveKind::STEAL: {
+                const PlayerId victim = get_robbery_victim(state);
+                const auto stolen = static_cast<Map::Resource>(move.target);
+                state.add_resources(victim, stolen, -1);
+                state.add_resources(player, stolen, 1);
+                state.set_turn(player, Game::GamePhase::PLAYER_TURN);
+                break;
+            }
+            case MoveKind::END_TURN:
+                state.set_turn(static_cast<PlayerId>((player + 1) % player_count), Game::GamePhase::ROLL);
+                break;
+            case MoveKind::ROLL:
+                if (state.roll_dice(static_cast<int>(move.target)) == 7) {
+                    discard_half(state, rules);
+                    state.set_turn(player, Game::GamePhase::MOVE_ROBBER);
+                } else {
+                    state.set_turn(player, Game::GamePhase::PLAYER_TURN);
+                }
+                break;
+        }
+    }
+
+    auto get_robbery_victim(const Game::GameState &state) -> PlayerId {
+        const PlayerId thief = state.get_current_player();
+        for (const Map::CornerId corner: state.get_map().get_topology().get_hex_corners(state.get_robber())) {
+            const PlayerId victim = state.get_map().get_corner(corner)->house.owner;
+            if (victim != NO_PLAYER && victim != thief && state.get_resources(victim).total() != 0) {
+                return victim;
+            }
+        }
+        return NO_PLAYER;
+    }
+
+    auto is_chance_node(const Game::GameState &state) -> bool {
+        return state.get_phase() == Game::GamePhase::ROLL || state.get_phase() == Game::GamePhase::STEAL;
+    }
+
+    auto draw_chance_move(const Game::GameState &state, std::minstd_rand &random_engine) -> Move {
+        if (state.get_phase() == Game::GamePhase::STEAL) {
+            // Every card in the victim's hand is equally likely to be taken
+            const Game::ResourceBundle &hand = state.get_resources(get_robbery_victim(state));
+            int card = std::uniform_int_distribution(0, hand.total() - 1)(random_engine);
+            for (const Map::Resource resource: Map::RESOURCES) {
+                card -= hand[resource];
+                if (card < 0) {
+                    return {MoveKind::STEAL, static_cast<std::uint32_t>(resource)};
+                }
+            }
+        }
+        // Every roll left is equally likely to come next
+        const Game::RollManager &deck = state.get_roll_manager();
+        const size_t position = std::uniform_int_distribution<size_t>(0, deck.get_queue_size() - 1)(random_engine);
+        return {MoveKind::ROLL, static_cast<std::uint32_t>(deck.peek(position))};
+    }
+
+    void discard_half(Game::GameState &state, const Rules &rules) {
+        for (PlayerId victim = 0; victim < static_cast<PlayerId>(state.get_player_count()); victim++) {
+            Game::ResourceBundle hand = state.get_resources(victim);
+            const int total = hand.total();
+            if (total <= static_cast<int>(rules.hand_limit)) {
+                continue;
+            }
+            for (int discarded = 0; discarded < total / 2; discarded++) {
+                hand[get_largest_pile(hand)]--;
+            }
+            state.add_resources(victim, hand - state.get_resources(victim));
+        }
+    }
+
+    void update_longest_road(Game::GameState &state, const Rules &rules) {
+        // The holder keeps the title on a tie and loses it only to a strictly longer road, or when their own road
+        // is cut below the minimum. A minimum of 0 still takes a road.
+        const auto &network = state.get_road_network();
+        const std::uint32_t minimum = std::max(rules.longest_road_minimum, 1U);
+        PlayerId holder = state.get_longest_road_holder();
+        if (holder != NO_PLAYER && network.get_longest_road(holder) < minimum) {
+            holder = NO_PLAYER;
+        }
+        for (PlayerId player = 0; player < static_cast<PlayerId>(state.get_player_count()); player++) {
+            const std::uint32_t road = network.get_longest_road(player);
+            if (road >= minimum && (holder == NO_PLAYER || road > network.get_longest_road(holder))) {
+                holder = player;
+            }
+        }
+        if (holder != state.get_longest_road_holder()) {
+            state.set_longest_road_holder(holder);
+        }
+    }
+
+    auto get_victory_points(const Game::GameState &state, const PlayerId player) -> std::uint32_t {
+        return state.get_building_points(player) + (state.get_longest_road_holder() == player ? 2 : 0);
+    }
+
+    auto get_winner(const Game::GameState &state, const Rules &rules) -> PlayerId {
+        switch (state.get_phase()) {
+            case Game::GamePhase::ROLL:
+            case Game::GamePhase::MOVE_ROBBER:
+            case Game::GamePhase::STEAL:
+            case Game::GamePhase::PLAYER_TURN:
+                break;
+            default:
+                return NO_PLAYER;
+        }
+        const PlayerId player = state.get_current_player();
+        return get_victory_points(state, player) >= rules.victory_points ? player : NO_PLAYER;
+    }
+} // namespace Sim
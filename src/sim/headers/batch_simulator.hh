@@ -0,0 +1,160 @@
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "board_bitboards.hh"
+#include "game_state.hh"
+#include "map.hh"
+#include "resource_bundle.hh"
+#include "simulator.hh"
+
+namespace Sim {
+    struct BatchConfig {
+        size_t games = 4096;
+        size_t player_count = 4;
+        size_t radius = 2;
+        std::uint64_t seed = 0;
+        // Games mirrored on a scalar GameState and cross-checked after every turn, 0 turns validation off
+        size_t validated_games = 0;
+        Rules rules{};
+    };
+
+    // Plays many games on one board in lockstep, turn by turn. Everything a turn touches in every game (dice,
+    // houses, hands, affordability) is stored structure-of-arrays: one int16 lane per game in each row, so
+    // rolling, producing and checking what players can pay for are plain loops over the whole batch that the
+    // compiler turns into SIMD. Builds are rare, so they run per game on that game's BoardBitboards, and only
+    // for the games whose current player can afford something.
+    //
+    // Batched games follow a fixed policy: random setup, then cities before settlements before roads, roads only
+    // while there is no free corner to settle, and bank trades towards the next of those when nothing can be
+    // built. A 7 discards like Simulator does and moves the robber to a random hex without stealing. There is no
+    // longest road.
+    //
+    // With validation on, a random sample of the games is replayed on Game::GameState, taking the same rolls and
+    // decisions; after every turn the hands, what each player can afford and the points must agree, and every
+    // build must be legal in the scalar state too.
+    class BatchSimulator {
+    public:
+        // Games a kernel works on at once: 16 int16 lanes, one AVX2 register or two SSE ones
+        static constexpr size_t BLOCK = 16;
+
+    private:
+        // A corner next to a producing hex, one per (hex, corner) pair, grouped by number
+        struct ProductionSite {
+            std::int16_t hex;
+            std::int16_t number;
+            Map::CornerId corner;
+            Map::Resource resource;
+        };
+
+        struct Mirror {
+            size_t game;
+            Game::GameState state;
+        };
+
+        BatchConfig m_config;
+        // Row length: the game count rounded up to whole blocks. Lanes past the last game are never running.
+        size_t m_stride;
+        Map::Map m_board;
+        std::vector<ProductionSite> m_sites;
+
+        // Rows of one lane per game. Kernels copy a block of a row into a local array, work on that and store it
+        // back, which tells the compiler the rows do not alias.
+        std::vector<std::uint32_t> m_dice;
+        std::vector<std::int16_t> m_rolls;
+        std::vector<std::int16_t> m_robbers;
+        std::vector<std::int16_t> m_running;
+        // [corner][game]
+        std::vector<std::int16_t> m_house_owners;
+        std::vector<std::int16_t> m_house_levels;
+        // [player][resource][game]
+        std::vector<std::int16_t> m_resources;
+        // [player][game]
+        std::vector<Game::RecipeMask> m_affordable;
+
+        std::vector<Map::BoardBitboards> m_pieces;
+        std::vector<PlayerId> m_winners;
+        size_t m_running_count;
+        std::uint32_t m_turn = 0;
+        bool m_setting_up = false;
+
+        std::vector<Mirror> m_mirrors;
+        // Index into m_mirrors of each game, -1 for the games that are not validated
+        std::vector<std::int32_t> m_mirror_of;
+        std::optional<std::string> m_validation_error;
+
+        [[nodiscard]] auto lane(const size_t row, const size_t game) const -> size_t {
+            return row * m_stride + game;
+        }
+
+        [[nodiscard]] auto resource_row(const PlayerId player, const Map::Resource resource) const -> size_t {
+            return static_cast<size_t>(player) * Map::RESOURCE_COUNT + static_cast<size_t>(resource);
+        }
+
+        auto next_random(size_t game) -> std::uint32_t;
+
+        void roll_dice();
+
+        void produce();
+
+        void update_affordable();
+
+        void update_affordable(size_t game, PlayerId player);
+
+        void handle_seven(size_t game);
+
+        // Trades `bank_trade_rate` of a resource the player has to spare for one that `recipe` still lacks.
+        // Returns false when there is no such trade.
+        auto trade_towards(size_t game, PlayerId player, Game::Recipe recipe) -> bool;
+
+        void build(size_t game, PlayerId player);
+
+        void play_setup(size_t game);
+
+        void place_house(size_t game, Map::CornerId corner, const House &house);
+
+        void place_road(size_t game, Map::EdgeId edge, PlayerId player);
+
+        void add_resources(size_t game, PlayerId player, const Game::ResourceBundle &resources);
+
+        void validate();
+
+        void report(size_t game, const std::string &problem);
+
+    public:
+        explicit BatchSimulator(const BatchConfig &config);
+
+        // Plays one turn of the current seat in every running game. Returns false once every game is over.
+        auto play_turn() -> bool;
+
+        [[nodiscard]] auto get_game_count() const -> size_t { return m_config.games; }
+
+        [[nodiscard]] auto get_turn() const -> std::uint32_t { return m_turn; }
+
+        [[nodiscard]] auto get_running_count() const -> size_t { return m_running_count; }
+
+        [[nodiscard]] auto get_roll(const size_t game) const -> int { return m_rolls[game]; }
+
+        [[nodiscard]] auto get_winner(const size_t game) const -> PlayerId { return m_winners[game]; }
+
+        [[nodiscard]] auto get_resources(size_t game, PlayerId player) const -> Game::ResourceBundle;
+
+        [[nodiscard]] auto get_affordable_recipes(const size_t game, const PlayerId player) const
+            -> Game::RecipeMask {
+            return m_affordable[lane(player, game)];
+        }
+
+        [[nodiscard]] auto get_pieces(const size_t game) const -> const Map::BoardBitboards & {
+            return m_pieces[game];
+        }
+
+        // First disagreement found by validation, std::nullopt while the batch agrees with the scalar games.
+        [[nodiscard]] auto get_validation_error() const -> const std::optional<std::string> & {
+            return m_validation_error;
+        }
+    };
+} // namespace Sim
@@ -0,0 +1,57 @@
+
+#pragma once
+#include <cstdint>
+#include <random>
+
+#include "move.hh"
+#include "game_state.hh"
+#include "rules.hh"
+
+namespace Sim {
+    // The rules of a game as single steps on a GameState, so a game can be advanced one decision at a time from
+    // wherever it stands. The player to move and the phase live in the state (GameState::set_turn):
+    //
+    //   FREE_BUILDING -> FREE_ROAD, twice per player in snake order, then ROLL of player 0
+    //   ROLL -> MOVE_ROBBER on a 7 -> STEAL with a victim -> PLAYER_TURN -> END_TURN -> ROLL of the next player
+    //
+    // Search walks games this way, and the Simulator plays its games through the same generate_moves and
+    // apply_move, so both offer the same moves and follow the same rules.
+
+    // Legal moves of the phase `state` is in. The ROLL and STEAL phases are chance nodes, not choices: their
+    // moves are the outcomes, one ROLL per value still in the deck and one STEAL per resource in the victim's
+    // hand. Neither generating nor applying allocates.
+    void generate_moves(const Game::GameState &state, const Rules &rules, MoveList &moves);
+
+    // Plays one move of generate_moves for the player to move and moves on to the next phase. A ROLL draws its
+    // value from the deck, hands out the production, or on a 7 makes the oversized hands discard. A STEAL moves
+    // its card from the victim to the thief. Throws std::invalid_argument when no roll of that value is left in
+    // the deck.
+    void apply_move(Game::GameState &state, const Rules &rules, const Move &move);
+
+    // Who the player to move robs: the first opponent next to the robber's hex who holds any cards, NO_PLAYER
+    // when nobody does.
+    [[nodiscard]] auto get_robbery_victim(const Game::GameState &state) -> PlayerId;
+
+    // Whether the moves of `state` are chance outcomes rather than a choice: the ROLL and STEAL phases.
+    [[nodiscard]] auto is_chance_node(const Game::GameState &state) -> bool;
+
+    // The outcome of the chance node `state` stands at, drawn with its odds: in the STEAL phase every card of
+    // the victim's hand is equally likely, in the ROLL phase every roll left in the deck.
+    [[nodiscard]] auto draw_chance_move(const Game::GameState &state, std::minstd_rand &random_engine) -> Move;
+
+    // Every hand above the hand limit loses half of it, a card at a time from its largest pile.
+    void discard_half(Game::GameState &state, const Rules &rules);
+
+    // Hands longest road to whoever has earned it after a road or a settlement went down: the first player with
+    // a road of at least the minimum length, then only a strictly longer one. The holder keeps it through a tie
+    // and loses it when their road is cut below the minimum. Called by apply_move; the holder is kept in the
+    // state (GameState::get_longest_road_holder).
+    void update_longest_road(Game::GameState &state, const Rules &rules);
+
+    // Buildings plus two for holding the longest road.
+    [[nodiscard]] auto get_victory_points(const Game::GameState &state, PlayerId player) -> std::uint32_t;
+
+    // The player to move once they have the winning points, NO_PLAYER while the game goes on. As in the
+    // Simulator, a game is only won during one's own turn.
+    [[nodiscard]] auto get_winner(const Game::GameState &state, const Rules &rules) -> PlayerId;
+} // namespace Sim
@@ -0,0 +1,142 @@
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "move.hh"
+#include "game_state.hh"
+#include "policy.hh"
+#include "rules.hh"
+
+namespace Sim {
+    struct MctsConfig {
+        // Threads growing the one shared tree, 0 for one per hardware thread
+        size_t thread_count = 1;
+        // UCB1 exploration constant, for rewards in [0, 1]
+        float exploration = 0.7f;
+        // Nodes in the pool. The tree stops growing once they are used up; playouts go on from its leaves.
+        std::uint32_t node_capacity = 1 << 20;
+        // Playouts stop after this many turns and score the points reached instead of a win
+        std::uint32_t playout_turns = 30;
+        // Visits without reward a thread puts on every node it passes on the way down, taken back when its
+        // playout returns, so the other threads spread over other branches meanwhile
+        std::uint32_t virtual_loss = 1;
+        std::uint64_t seed = 0;
+        Rules rules{};
+    };
+
+    struct SearchResult {
+        Move move{MoveKind::END_TURN};
+        std::uint64_t playouts = 0;
+        std::uint32_t nodes = 0;
+        // Playouts that went through the chosen move
+        std::uint32_t visits = 0;
+    };
+
+    // Monte Carlo tree search over the game flow of game_flow.hh, for the player to move.
+    //
+    // All threads grow one tree (tree parallelism) and keep each other apart with virtual loss. A turn's dice
+    // are a chance node with one ROLL child per value left in the RollManager deck, sampled by the odds of the
+    // deck rather than chosen, so the search plays the odds and not the order it happens to be shuffled in. The
+    // card a robbery takes is a chance node the same way, one STEAL child per resource in the victim's hand.
+    // Each thread plays on a clone of the state and takes every iteration back through the undo log.
+    //
+    // Nodes come from a pool allocated once and handed out by bumping an atomic counter; a node's children are
+    // consecutive, so expanding a node is one allocation and walking its children is one contiguous read. A
+    // search resets the pool, so a search allocates nothing per node.
+    //
+    // Every node keeps the reward of the player who took the move leading to it, so each player maximises
+    // their own share (max^n) and the search works for any number of players.
+    class MctsSearch {
+        static constexpr std::uint32_t ROOT = 0;
+        static constexpr std::uint32_t NO_CHILDREN = std::numeric_limits<std::uint32_t>::max();
+        // Rewards are summed as fixed point, so adding one is a single atomic integer add
+        static constexpr double REWARD_SCALE = 1 << 16;
+
+        enum Expansion : std::uint8_t {
+            UNEXPANDED,
+            EXPANDING,
+            EXPANDED,
+        };
+
+        struct Node {
+            Move move{MoveKind::END_TURN};
+            // Who took the move, or rolled for the outcome of a chance node
+            PlayerId player = NO_PLAYER;
+            // The children are chance outcomes, ROLL or STEAL moves
+            bool chance = false;
+            std::atomic<std::uint8_t> expansion{UNEXPANDED};
+            std::uint32_t first_child = NO_CHILDREN;
+            std::uint32_t child_count = 0;
+            std::atomic<std::uint32_t> visits{0};
+            std::atomic<std::uint32_t> virtual_losses{0};
+            std::atomic<std::uint64_t> reward{0};
+
+            void reset(const Move &new_move, PlayerId new_player);
+        };
+
+        // Everything one search thread works with besides the tree
+        struct Worker {
+            Game::GameState state;
+            std::minstd_rand random_engine;
+            MoveList moves{};
+            std::vector<std::uint32_t> path{};
+            std::vector<double> rewards{};
+        };
+
+        MctsConfig m_config;
+        std::unique_ptr<Node[]> m_nodes;
+        std::atomic<std::uint32_t> m_node_count{0};
+        std::atomic<std::uint64_t> m_started_playouts{0};
+        std::uint64_t m_search_count = 0;
+
+        // First of `count` consecutive fresh nodes, NO_CHILDREN once the pool is used up.
+        auto allocate(std::uint32_t count) -> std::uint32_t;
+
+        // Gives the node its children for the state it stands for. False when the pool is used up.
+        auto expand(Node &node, Worker &worker) -> bool;
+
+        [[nodiscard]] auto select_child(const Node &node) const -> std::uint32_t;
+
+        // Plays on with a cheap policy and fills worker.rewards with every player's reward.
+        void play_out(Worker &worker) const;
+
+        void run_iteration(Worker &worker);
+
+    public:
+        explicit MctsSearch(const MctsConfig &config);
+
+        // Best move for the player to move in `state`, after searching for `budget` or `max_playouts`
+        // playouts, whichever runs out first. Anytime: the answer is the most visited move so far. Throws
+        // std::invalid_argument when the player to move has no decision to make.
+        [[nodiscard]] auto search(const Game::GameState &state, std::chrono::nanoseconds budget,
+                                  std::uint64_t max_playouts = std::numeric_limits<std::uint64_t>::max())
+            -> SearchResult;
+
+        void seed(std::uint64_t seed) { m_config.seed = seed; }
+    };
+
+    // Policy searching every decision with MCTS. Needs the phase of the state set by the game flow, as the
+    // Simulator does.
+    class MctsPolicy final : public Policy {
+        MctsSearch m_search;
+        std::chrono::nanoseconds m_budget;
+        std::uint64_t m_max_playouts;
+
+    public:
+        MctsPolicy(const MctsConfig &config, std::chrono::nanoseconds budget,
+                   std::uint64_t max_playouts = std::numeric_limits<std::uint64_t>::max());
+
+        [[nodiscard]] auto choose(const Game::GameState &state, PlayerId player,
+                                  std::span<const Move> moves) -> size_t override;
+
+        void seed(std::uint64_t seed) override;
+    };
+} // namespace Sim
@@ -0,0 +1,105 @@
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+#include "map.hh"
+
+namespace Sim {
+    enum class MoveKind : std::uint8_t {
+        // Free settlement of the setup rounds, target is a CornerId
+        SETUP_SETTLEMENT,
+        // Free road next to the settlement just placed, target is an EdgeId
+        SETUP_ROAD,
+        BUILD_ROAD,
+        BUILD_SETTLEMENT,
+        BUILD_CITY,
+        // Four of one resource to the bank for one of another, target is get_trade_target(give, get)
+        BANK_TRADE,
+        // After a 7, target is the HexId the robber moves to
+        MOVE_ROBBER,
+        END_TURN,
+        // Outcome of the dice at the start of a turn, target is the value rolled
+        ROLL,
+        // Outcome of a robbery, target is the Map::Resource taken from the victim
+        STEAL,
+    };
+
+    // One step of a game. `target` is the corner, edge, hex or dice value the move applies to, 0 when it has none.
+    // Packed into 32 bits so move lists, search nodes and logs stay small; encode() gives the same bits in a
+    // layout that does not depend on the compiler: the kind in the top byte, the target in the low 24 bits.
+    struct Move {
+        static constexpr std::uint32_t TARGET_BITS = 24;
+        static constexpr std::uint32_t TARGET_MASK = (1u << TARGET_BITS) - 1;
+
+        MoveKind kind : 8;
+        std::uint32_t target : TARGET_BITS = 0;
+
+        constexpr auto operator==(const Move &other) const -> bool = default;
+
+        [[nodiscard]] constexpr auto encode() const -> std::uint32_t {
+            return static_cast<std::uint32_t>(kind) << TARGET_BITS | target;
+        }
+
+        [[nodiscard]] static constexpr auto decode(const std::uint32_t bits) -> Move {
+            return Move{static_cast<MoveKind>(bits >> TARGET_BITS), bits & TARGET_MASK};
+        }
+    };
+
+    static_assert(sizeof(Move) == 4);
+
+    constexpr auto get_trade_target(const Map::Resource give, const Map::Resource get) -> std::uint32_t {
+        return static_cast<std::uint32_t>(give) << 8 | static_cast<std::uint32_t>(get);
+    }
+
+    constexpr auto get_traded_away(const Move &trade) -> Map::Resource {
+        return static_cast<Map::Resource>(trade.target >> 8);
+    }
+
+    constexpr auto get_traded_for(const Move &trade) -> Map::Resource {
+        return static_cast<Map::Resource>(trade.target & 0xff);
+    }
+
+    // The legal moves of one decision, kept inline so generating them never touches the heap. MAX_MOVES covers
+    // the free settlements of the setup on boards up to radius 12, the largest list any phase produces; a
+    // larger list throws std::length_error.
+    class MoveList {
+    public:
+        static constexpr size_t MAX_MOVES = 1024;
+
+    private:
+        std::array<Move, MAX_MOVES> m_moves;
+        size_t m_size = 0;
+
+    public:
+        void clear() { m_size = 0; }
+
+        void push_back(const Move &move) {
+            if (m_size == MAX_MOVES) {
+                throw std::length_error("More legal moves than a MoveList holds");
+            }
+            m_moves[m_size++] = move;
+        }
+
+        [[nodiscard]] auto size() const -> size_t { return m_size; }
+        [[nodiscard]] auto empty() const -> bool { return m_size == 0; }
+
+        [[nodiscard]] auto operator[](const size_t index) const -> const Move & { return m_moves[index]; }
+        [[nodiscard]] auto front() const -> const Move & { return m_moves[0]; }
+
+        [[nodiscard]] auto at(const size_t index) const -> const Move & {
+            if (index >= m_size) {
+                throw std::out_of_range("Move index out of range");
+            }
+            return m_moves[index];
+        }
+
+        [[nodiscard]] auto begin() const -> const Move * { return m_moves.data(); }
+        [[nodiscard]] auto end() const -> const Move * { return m_moves.data() + m_size; }
+
+        operator std::span<const Move>() const { return {begin(), m_size}; }
+    };
+} // namespace Sim
@@ -0,0 +1,61 @@
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "game_state.hh"
+#include "move.hh"
+#include "rules.hh"
+
+namespace Sim {
+    // How perft treats the chance nodes: the dice at the start of a turn and the card a robbery takes.
+    enum class DiceMode : std::uint8_t {
+        // Every outcome is a child of its own, as generate_moves lists them
+        EXPAND,
+        // One outcome drawn with its odds, so deep counts stay tractable. Repeatable for one seed.
+        SAMPLE,
+    };
+
+    struct PerftConfig {
+        DiceMode dice = DiceMode::EXPAND;
+        std::uint64_t seed = 0;
+        Rules rules{};
+    };
+
+    struct PerftResult {
+        // Move sequences of exactly the depth asked for. A won game ends its sequences early and counts none,
+        // as a mate does in chess.
+        std::uint64_t leaves = 0;
+        // Moves applied on the way, every one taken back through the undo log
+        std::uint64_t nodes = 0;
+    };
+
+    // Counts under one move of the root, the move itself included, as perft's "divide" prints them to find
+    // where two counts part.
+    struct PerftDivision {
+        Move move{MoveKind::END_TURN};
+        PerftResult result{};
+    };
+
+    // Counts every legal move sequence of `depth` moves of the game flow from `state`, applying and undoing
+    // each move: chess engines' perft. Pinned counts make it the reference for any faster move generation,
+    // and its node rate the benchmark of generate_moves, apply_move and undo together. Leaves `state` as it
+    // found it.
+    [[nodiscard]] auto perft(Game::GameState &state, std::uint32_t depth, const PerftConfig &config = {})
+        -> PerftResult;
+
+    // perft split by the moves of the root, in the order generate_moves lists them.
+    [[nodiscard]] auto divide(Game::GameState &state, std::uint32_t depth, const PerftConfig &config = {})
+        -> std::vector<PerftDivision>;
+
+    // Standard board of `radius` built from `seed`, before the first settlement, hands empty as in the
+    // Simulator.
+    [[nodiscard]] auto make_setup_position(size_t radius, std::uint64_t seed, size_t player_count)
+        -> Game::GameState;
+
+    // The same board once the setup rounds are played by placements drawn from `seed`, player 0 about to roll.
+    [[nodiscard]] auto make_opening_position(size_t radius, std::uint64_t seed, size_t player_count)
+        -> Game::GameState;
+} // namespace Sim
@@ -0,0 +1,55 @@
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+
+#include "move.hh"
+#include "game_state.hh"
+#include "rules.hh"
+
+namespace Sim {
+    // Decides for one seat of a simulated game. The simulator lists every legal move of the decision at hand
+    // and the policy returns the index of the one it takes.
+    class Policy {
+    public:
+        virtual ~Policy() = default;
+
+        // `moves` is never empty and all of its entries are of the same decision: setup placements, the
+        // robber's hex, or the builds of a turn together with END_TURN.
+        [[nodiscard]] virtual auto choose(const Game::GameState &state, PlayerId player,
+                                          std::span<const Move> moves) -> size_t = 0;
+
+        // Restarts any randomness of the policy. Called before every game of a tournament, so a game plays out
+        // the same whichever worker runs it.
+        virtual void seed(std::uint64_t /*seed*/) {}
+    };
+
+    // Picks uniformly among the legal moves.
+    class RandomPolicy final : public Policy {
+        std::minstd_rand m_random_engine;
+
+    public:
+        explicit RandomPolicy(std::uint32_t seed);
+
+        [[nodiscard]] auto choose(const Game::GameState &state, PlayerId player,
+                                  std::span<const Move> moves) -> size_t override;
+
+        void seed(std::uint64_t seed) override;
+    };
+
+    // Scores every move on its own and takes the best: cities before settlements, settlements on the corners
+    // producing the most, roads only while there is no free corner to settle, bank trades only when they
+    // complete a city or settlement, and the robber on the hex that costs the opponents the most.
+    class GreedyPolicy final : public Policy {
+        Rules m_rules;
+
+    public:
+        // `rules` has to be those of the games played, for the bank trade rate.
+        explicit GreedyPolicy(const Rules &rules = {});
+
+        [[nodiscard]] auto choose(const Game::GameState &state, PlayerId player,
+                                  std::span<const Move> moves) -> size_t override;
+    };
+} // namespace Sim
@@ -0,0 +1,113 @@
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "game_state.hh"
+#include "move.hh"
+#include "rules.hh"
+
+namespace Sim {
+    // Binary replay logs: a game as the moves and dice of the game flow (game_flow.hh), appended as they are
+    // played.
+    //
+    // The log opens with a header holding the rules, the player count and the tiles of the board, then a
+    // keyframe of the state the recording started from. Every record after it is one move. Its first byte
+    // holds the kind in the high nibble and a small payload in the low one: the dice value of a ROLL, the card
+    // taken by a STEAL, the resource given in a BANK_TRADE. Corners, edges and hexes are stored as the
+    // zigzag varint delta to the target of the previous move of the same kind, in the low nibble when it fits.
+    // Most moves take one or two bytes.
+    //
+    // Before the roll of every keyframe_interval-th turn comes a keyframe: the full state, varint encoded and
+    // length prefixed. The delta chains restart after each, so a reader can decode from any keyframe on, and
+    // seeking to a turn replays at most keyframe_interval turns.
+    inline constexpr std::uint32_t REPLAY_VERSION = 3;
+
+    // Appends the moves of one game to a log. The log only grows, so its bytes can be written out as they come.
+    class ReplayWriter {
+        std::vector<std::uint8_t> m_bytes;
+        // Keyframe body being built, ahead of its length
+        std::vector<std::uint8_t> m_keyframe;
+        std::uint32_t m_keyframe_interval;
+        std::uint32_t m_turn_count = 0;
+        // Target of the last move of each kind since the last keyframe, what the next one is a delta to
+        std::array<std::uint32_t, 16> m_last_targets{};
+
+        void write_keyframe(const Game::GameState &state);
+
+    public:
+        // Starts the log from `state`, wherever it stands. Throws std::invalid_argument for a keyframe
+        // interval of 0.
+        ReplayWriter(const Game::GameState &state, const Rules &rules, std::uint32_t keyframe_interval = 16);
+
+        // Appends `move`, to be called before it is applied to `state`. A ROLL starts a turn.
+        void record(const Game::GameState &state, const Move &move);
+
+        // Dice rolled so far.
+        [[nodiscard]] auto get_turn_count() const -> std::uint32_t { return m_turn_count; }
+
+        [[nodiscard]] auto get_bytes() const -> std::span<const std::uint8_t> { return m_bytes; }
+    };
+
+    // Plays a log back on a GameState of its own, from the start or from any turn. Reads the log in place;
+    // the bytes must outlive the reader. Throws std::invalid_argument for a log that is not a replay log of
+    // this version, or is cut off in the middle of a record.
+    class ReplayReader {
+        struct Header;
+
+        std::span<const std::uint8_t> m_bytes;
+        Rules m_rules;
+        std::uint32_t m_keyframe_interval;
+        Game::GameState m_state;
+        // The state as built from the header, before any keyframe, to load keyframes onto
+        Game::GameStateSnapshot m_blank;
+        // (turn, offset) of every keyframe, in log order
+        std::vector<std::pair<std::uint32_t, size_t> > m_keyframes;
+        std::uint32_t m_turn_count = 0;
+
+        size_t m_offset = 0;
+        std::uint32_t m_turn = 0;
+        std::array<std::uint32_t, 16> m_last_targets{};
+
+        ReplayReader(std::span<const std::uint8_t> bytes, Header header);
+
+        static auto read_header(std::span<const std::uint8_t> bytes) -> Header;
+
+        void load_keyframe(size_t index);
+
+        // Whether the next record is the roll starting a turn, or the keyframe ahead of it.
+        [[nodiscard]] auto is_at_turn_start() const -> bool;
+
+    public:
+        explicit ReplayReader(std::span<const std::uint8_t> bytes);
+
+        // Back to the state the recording started from.
+        void rewind();
+
+        // Plays the next move of the log and returns it, std::nullopt at the end of the log.
+        auto next() -> std::optional<Move>;
+
+        // Goes to the start of `turn`, before its roll, by loading the last keyframe at or before it and playing
+        // on from there: at most keyframe_interval turns, and none when `turn` lies ahead in the current stretch.
+        // get_turn_count() seeks to the end of the log. Throws std::out_of_range past that.
+        void seek(std::uint32_t turn);
+
+        [[nodiscard]] auto get_state() const -> const Game::GameState & { return m_state; }
+
+        [[nodiscard]] auto get_rules() const -> const Rules & { return m_rules; }
+
+        // Rolls played back so far: the turn under way, or the next one at a turn start.
+        [[nodiscard]] auto get_turn() const -> std::uint32_t { return m_turn; }
+
+        // Turns in the whole log.
+        [[nodiscard]] auto get_turn_count() const -> std::uint32_t { return m_turn_count; }
+
+        [[nodiscard]] auto get_keyframe_interval() const -> std::uint32_t { return m_keyframe_interval; }
+
+        [[nodiscard]] auto is_finished() const -> bool { return m_offset == m_bytes.size(); }
+    };
+} // namespace Sim
@@ -0,0 +1,19 @@
+
+#pragma once
+#include <cstdint>
+
+namespace Sim {
+    struct Rules {
+        std::uint32_t victory_points = 10;
+        // Games still running after this many turns end without a winner
+        std::uint32_t turn_limit = 1000;
+        std::uint32_t max_settlements = 5;
+        std::uint32_t max_cities = 4;
+        std::uint32_t max_roads = 15;
+        std::uint32_t longest_road_minimum = 5;
+        // Hands above this many cards lose half of them on a 7
+        std::uint32_t hand_limit = 7;
+        // Cards of one resource the bank takes for one card of another
+        std::uint32_t bank_trade_rate = 4;
+    };
+} // namespace Sim
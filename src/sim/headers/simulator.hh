@@ -0,0 +1,84 @@
+
+#pragma once
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "move.hh"
+#include "game_state.hh"
+#include "map.hh"
+#include "policy.hh"
+#include "rules.hh"
+
+namespace Sim {
+    class ReplayWriter;
+
+    struct GameResult {
+        PlayerId winner = NO_PLAYER;
+        PlayerId longest_road = NO_PLAYER;
+        std::uint32_t turns = 0;
+        std::vector<std::uint32_t> points{};
+    };
+
+    // Runs a whole game on a GameState without any rendering: the two setup rounds, then turns of rolling,
+    // producing, handling a 7, trading with the bank and building until a player reaches the winning points.
+    // Every decision is handed to the Policy of the seat and played with apply_move, so bots, self-play,
+    // regression runs and search all follow the same rules.
+    class Simulator {
+        Game::GameState m_state;
+        std::vector<Policy *> m_policies;
+        Rules m_rules;
+        // Draws the cards the robber takes
+        std::minstd_rand m_random_engine;
+        // Legal moves of the current decision, reused between decisions
+        MoveList m_moves;
+        PlayerId m_current = 0;
+        std::uint32_t m_turn = 0;
+        PlayerId m_winner = NO_PLAYER;
+        ReplayWriter *m_recorder = nullptr;
+
+        auto decide(PlayerId player) -> Move;
+
+        // Hands the move to the recorder, if any, and plays it with apply_move.
+        void apply(const Move &move);
+
+        void place_setup(PlayerId player);
+
+    public:
+        // Seats one player per policy. The policies are borrowed and must outlive the simulator.
+        Simulator(Map::Map map, std::span<Policy *const> policies, std::uint32_t seed, const Rules &rules = {});
+
+        // Records every move and roll from here on into `recorder`, nullptr to stop. The recorder is borrowed and
+        // must outlive the simulator. Replaying the log through the game flow gives back this game's states.
+        void record_to(ReplayWriter *recorder) { m_recorder = recorder; }
+
+        // Places every player's two free settlements and roads, in snake order. The second settlement pays out
+        // one card per producing hex next to it.
+        void play_setup();
+
+        // Plays the turn of the current player and passes the dice on. Returns false once the game is over.
+        auto play_turn() -> bool;
+
+        // Plays the setup and every turn until the game is over.
+        auto play() -> GameResult;
+
+        [[nodiscard]] auto get_state() const -> const Game::GameState & { return m_state; }
+
+        [[nodiscard]] auto get_current_player() const -> PlayerId { return m_current; }
+
+        [[nodiscard]] auto get_turn() const -> std::uint32_t { return m_turn; }
+
+        [[nodiscard]] auto get_winner() const -> PlayerId { return m_winner; }
+
+        [[nodiscard]] auto get_longest_road_holder() const -> PlayerId;
+
+        [[nodiscard]] auto is_finished() const -> bool {
+            return m_winner != NO_PLAYER || m_turn >= m_rules.turn_limit;
+        }
+
+        [[nodiscard]] auto get_victory_points(PlayerId player) const -> std::uint32_t;
+
+        [[nodiscard]] auto get_result() const -> GameResult;
+    };
+} // namespace Sim
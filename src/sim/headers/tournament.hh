@@ -0,0 +1,64 @@
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "policy.hh"
+#include "simulator.hh"
+
+namespace Sim {
+    // Makes the policy of one seat. Every worker calls it once per seat, so policies never share state across
+    // threads.
+    using PolicyFactory = std::function<std::unique_ptr<Policy>()>;
+
+    struct TournamentConfig {
+        std::uint32_t games = 1000;
+        size_t radius = 2;
+        std::uint64_t seed = 0;
+        // Seats at every game, one per entrant
+        size_t player_count = Game::DEFAULT_PLAYER_COUNT;
+        // 0 uses every hardware thread
+        size_t thread_count = 0;
+        Rules rules{};
+    };
+
+    // Totals of one entrant, an entrant being the policy of one factory.
+    struct EntrantStats {
+        std::uint64_t wins = 0;
+        std::uint64_t points = 0;
+        std::uint64_t longest_roads = 0;
+
+        auto operator==(const EntrantStats &other) const -> bool = default;
+    };
+
+    struct TournamentStats {
+        std::uint64_t games = 0;
+        // Games that ended with a winner rather than at the turn limit
+        std::uint64_t decided = 0;
+        std::uint64_t turns = 0;
+        std::vector<EntrantStats> entrants;
+
+        // Counts a game where player p was played by entrant (p + rotation) % entrant count.
+        void add(const GameResult &result, size_t rotation);
+
+        void merge(const TournamentStats &other);
+
+        auto operator==(const TournamentStats &other) const -> bool = default;
+    };
+
+    // Seed of game `game` of a tournament: a splitmix64 step over both, so neighbouring games get unrelated
+    // boards, dice and policy streams.
+    [[nodiscard]] auto get_game_seed(std::uint64_t tournament_seed, std::uint32_t game) -> std::uint64_t;
+
+    // Plays `config.games` independent games between the entrants on a work stealing pool. Game g is played on
+    // its own board with the seats rotated by g, so no entrant keeps the first move. Everything a game does
+    // derives from its seed, and every worker counts into its own TournamentStats that are merged after the
+    // pool is done: the result is the same for any thread count. Throws std::invalid_argument when there is
+    // not one entrant per seat.
+    [[nodiscard]] auto run_tournament(const TournamentConfig &config, std::span<const PolicyFactory> entrants)
+        -> TournamentStats;
+} // namespace Sim
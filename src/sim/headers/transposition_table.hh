@@ -0,0 +1,108 @@
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "zobrist.hh"
+
+namespace Sim {
+    // What a stored value says about the true value of the position.
+    enum class Bound : std::uint8_t {
+        NONE,
+        // The true value is at least `value`
+        LOWER,
+        // The true value is at most `value`
+        UPPER,
+        EXACT,
+    };
+
+    struct TranspositionEntry {
+        // Best move found, encoded by the search that stored it
+        std::uint32_t move = 0;
+        std::int16_t value = 0;
+        std::uint8_t depth = 0;
+        Bound bound = Bound::NONE;
+    };
+
+    // Fixed-size hash table of search results keyed by GameState::get_hash(), shared by every search thread
+    // without locks.
+    //
+    // Slots are grouped four to a 64 byte bucket, so a probe reads one cache line. Each slot is two words, the
+    // packed entry and the entry XORed with the full hash. A reader accepts a slot only if the two words XOR
+    // back to the hash it looks for, so an entry torn by two threads writing the same slot at once reads as a
+    // miss instead of as wrong data. A full bucket gives up the slot with the smallest depth, counting every
+    // search since it was written as eight plies less.
+    class TranspositionTable {
+        static constexpr size_t SLOTS = 4;
+        // Generations count searches; six bits of each entry hold the one it was written in, never 0 so that an
+        // entry is never the all zero word of an empty slot
+        static constexpr std::uint8_t GENERATIONS = 64;
+        static constexpr int AGE_PENALTY = 8;
+
+        struct Slot {
+            std::atomic<std::uint64_t> check{0};
+            std::atomic<std::uint64_t> data{0};
+        };
+
+        struct alignas(64) Bucket {
+            std::array<Slot, SLOTS> slots;
+        };
+
+        std::unique_ptr<Bucket[]> m_buckets;
+        size_t m_bucket_mask = 0;
+        std::atomic<std::uint8_t> m_generation{1};
+
+        [[nodiscard]] auto get_bucket(const Game::ZobristHash hash) const -> Bucket & {
+            return m_buckets[hash & m_bucket_mask];
+        }
+
+        // Searches since `data` was written, 0 for this one.
+        [[nodiscard]] auto get_age(std::uint64_t data) const -> int;
+
+    public:
+        // Sizes the table to the largest power of two number of buckets that fits in `size_in_bytes`, at least
+        // one.
+        explicit TranspositionTable(size_t size_in_bytes);
+
+        [[nodiscard]] auto probe(Game::ZobristHash hash) const -> std::optional<TranspositionEntry>;
+
+        // Stores the entry unless the slot of the same position already holds a deeper result of this search.
+        void store(Game::ZobristHash hash, const TranspositionEntry &entry);
+
+        // Marks the entries stored so far as older, so a new search replaces them first.
+        void new_search();
+
+        // Empties the table. Not thread safe: no search may be using the table meanwhile.
+        void clear();
+
+        [[nodiscard]] auto get_capacity() const -> size_t { return (m_bucket_mask + 1) * SLOTS; }
+
+        // Share of the first thousand buckets' slots written by the current search, in permille.
+        [[nodiscard]] auto get_usage() const -> size_t;
+
+        static constexpr auto pack(const TranspositionEntry &entry, const std::uint8_t generation) -> std::uint64_t {
+            return static_cast<std::uint64_t>(entry.move) << 32 |
+                   static_cast<std::uint64_t>(static_cast<std::uint16_t>(entry.value)) << 16 |
+                   static_cast<std::uint64_t>(entry.depth) << 8 |
+                   static_cast<std::uint64_t>(generation) << 2 |
+                   static_cast<std::uint64_t>(entry.bound);
+        }
+
+        static constexpr auto unpack(const std::uint64_t data) -> TranspositionEntry {
+            return {
+                .move = static_cast<std::uint32_t>(data >> 32),
+                .value = static_cast<std::int16_t>(static_cast<std::uint16_t>(data >> 16)),
+                .depth = static_cast<std::uint8_t>(data >> 8),
+                .bound = static_cast<Bound>(data & 3),
+            };
+        }
+
+        static constexpr auto get_generation(const std::uint64_t data) -> std::uint8_t {
+            return static_cast<std::uint8_t>(data >> 2 & (GENERATIONS - 1));
+        }
+    };
+} // namespace Sim
@@ -0,0 +1,44 @@
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Sim {
+    // Hands out the task indices [0, task_count) to a fixed set of workers without locks. Every worker starts
+    // with an equal contiguous share and takes tasks from the front of it; a worker that runs dry steals the back
+    // half of the largest share it finds. Shares are (begin, end) pairs packed in one atomic word, so taking
+    // and stealing are each a single compare-and-swap, and each share sits on its own cache line.
+    class WorkStealingScheduler {
+        struct alignas(64) Share {
+            std::atomic<std::uint64_t> range{0};
+        };
+
+        std::vector<Share> m_shares;
+
+        static constexpr auto pack(const std::uint32_t begin, const std::uint32_t end) -> std::uint64_t {
+            return static_cast<std::uint64_t>(begin) << 32 | end;
+        }
+
+        static constexpr auto get_begin(const std::uint64_t range) -> std::uint32_t {
+            return static_cast<std::uint32_t>(range >> 32);
+        }
+
+        static constexpr auto get_end(const std::uint64_t range) -> std::uint32_t {
+            return static_cast<std::uint32_t>(range);
+        }
+
+        auto steal(size_t worker) -> std::optional<std::uint32_t>;
+
+    public:
+        WorkStealingScheduler(std::uint32_t task_count, size_t worker_count);
+
+        // Next task of `worker`, std::nullopt once every task has been handed out. Only the worker itself may
+        // call this with its index.
+        [[nodiscard]] auto next(size_t worker) -> std::optional<std::uint32_t>;
+
+        [[nodiscard]] auto get_worker_count() const -> size_t { return m_shares.size(); }
+    };
+} // namespace Sim
@@ -0,0 +1,301 @@
+#include "mcts.hh"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include "game_flow.hh"
+
+namespace Sim {
+    namespace {
+        auto is_house_build(const Move &move) -> bool {
+            return move.kind == MoveKind::BUILD_CITY || move.kind == MoveKind::BUILD_SETTLEMENT;
+        }
+
+        // Playout policy: settle and upgrade whenever possible, otherwise build a road or trade half of the
+        // time, and only then end the turn. Much stronger than uniform play for the same cost, and games end
+        // in a fraction of the turns.
+        auto choose_playout_move(const std::span<const Move> moves, std::minstd_rand &random_engine)
+            -> const Move & {
+            const auto pick_among = [&](const auto &matches) -> const Move * {
+                const auto count = static_cast<size_t>(std::ranges::count_if(moves, matches));
+                if (count == 0) {
+                    return nullptr;
+                }
+                size_t chosen = std::uniform_int_distribution<size_t>(0, count - 1)(random_engine);
+                for (const Move &move: moves) {
+                    if (matches(move) && chosen-- == 0) {
+                        return &move;
+                    }
+                }
+                return nullptr;
+            };
+            if (moves.front().kind != MoveKind::END_TURN) {
+                // Setup and robber decisions have no best guess
+                return moves[std::uniform_int_distribution<size_t>(0, moves.size() - 1)(random_engine)];
+            }
+            if (const Move *build = pick_among(is_house_build)) {
+                return *build;
+            }
+            if (random_engine() % 2 == 0) {
+                if (const Move *other = pick_among([](const Move &move) {
+                    return move.kind == MoveKind::BUILD_ROAD || move.kind == MoveKind::BANK_TRADE;
+                })) {
+                    return *other;
+                }
+            }
+            return moves.front();
+        }
+    } // namespace
+
+    void MctsSearch::Node::reset(const Move &new_move, const PlayerId new_player) {
+        move = new_move;
+        player = new_player;
+        chance = false;
+        expansion.store(UNEXPANDED, std::memory_order_relaxed);
+        first_child = NO_CHILDREN;
+        child_count = 0;
+        visits.store(0, std::memory_order_relaxed);
+        virtual_losses.store(0, std::memory_order_relaxed);
+        reward.store(0, std::memory_order_relaxed);
+    }
+
+    MctsSearch::MctsSearch(const MctsConfig &config)
+        : m_config(config), m_nodes(std::make_unique<Node[]>(std::max<std::uint32_t>(config.node_capacity, 1))) {
+        if (m_config.thread_count == 0) {
+            m_config.thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+        m_config.node_capacity = std::max<std::uint32_t>(config.node_capacity, 1);
+    }
+
+    auto MctsSearch::allocate(const std::uint32_t count) -> std::uint32_t {
+        std::uint32_t first = m_node_count.load(std::memory_order_relaxed);
+        do {
+            if (count > m_config.node_capacity - first) {
+                return NO_CHILDREN;
+            }
+        } while (!m_node_count.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+        return first;
+    }
+
+    auto MctsSearch::expand(Node &node, Worker &worker) -> bool {
+        const Game::GameState &state = worker.state;
+        const PlayerId player = state.get_current_player();
+        // At a chance node the moves are its outcomes, the dice still in the deck or the victim's cards
+        generate_moves(state, m_config.rules, worker.moves);
+        const auto count = static_cast<std::uint32_t>(worker.moves.size());
+        const std::uint32_t first = count == 0 ? NO_CHILDREN : allocate(count);
+        if (count != 0 && first == NO_CHILDREN) {
+            return false;
+        }
+        for (std::uint32_t child = 0; child < count; child++) {
+            m_nodes[first + child].reset(worker.moves[child], player);
+        }
+        node.chance = is_chance_node(state);
+        node.first_child = first;
+        node.child_count = count;
+        return true;
+    }
+
+    auto MctsSearch::select_child(const Node &node) const -> std::uint32_t {
+        const auto seen = [](const Node &child) {
+            return child.visits.load(std::memory_order_relaxed) +
+                   child.virtual_losses.load(std::memory_order_relaxed);
+        };
+        const double log_visits = std::log(static_cast<double>(seen(node)) + 1);
+        std::uint32_t best = node.first_child;
+        double best_score = -1;
+        for (std::uint32_t child = node.first_child; child < node.first_child + node.child_count; child++) {
+            const Node &candidate = m_nodes[child];
+            const std::uint32_t visits = seen(candidate);
+            if (visits == 0) {
+                return child;
+            }
+            const double mean = static_cast<double>(candidate.reward.load(std::memory_order_relaxed)) /
+                                REWARD_SCALE / visits;
+            const double score = mean + m_config.exploration * std::sqrt(log_visits / visits);
+            if (score > best_score) {
+                best_score = score;
+                best = child;
+            }
+        }
+        return best;
+    }
+
+    void MctsSearch::play_out(Worker &worker) const {
+        Game::GameState &state = worker.state;
+        const Rules &rules = m_config.rules;
+        std::uint32_t turns = 0;
+        PlayerId winner = get_winner(state, rules);
+        while (winner == NO_PLAYER && turns < m_config.playout_turns) {
+            if (is_chance_node(state)) {
+                apply_move(state, rules, draw_chance_move(state, worker.random_engine));
+            } else {
+                generate_moves(state, rules, worker.moves);
+                if (worker.moves.empty()) {
+                    break;
+                }
+                const Move &move = choose_playout_move(worker.moves, worker.random_engine);
+                turns += move.kind == MoveKind::END_TURN;
+                apply_move(state, rules, move);
+            }
+            winner = get_winner(state, rules);
+        }
+
+        const size_t player_count = state.get_player_count();
+        worker.rewards.assign(player_count, 0);
+        if (winner != NO_PLAYER) {
+            worker.rewards[winner] = 1;
+            return;
+        }
+        // Unfinished: everyone gets their share of the points on the board
+        double total = 0;
+        for (PlayerId player = 0; player < static_cast<PlayerId>(player_count); player++) {
+            worker.rewards[player] = get_victory_points(state, player);
+            total += worker.rewards[player];
+        }
+        for (double &reward: worker.rewards) {
+            reward = total > 0 ? reward / total : 1.0 / static_cast<double>(player_count);
+        }
+    }
+
+    void MctsSearch::run_iteration(Worker &worker) {
+        Game::GameState &state = worker.state;
+        const Game::UndoMark mark = state.get_undo_mark();
+        worker.path.assign(1, ROOT);
+
+        std::uint32_t current = ROOT;
+        while (get_winner(state, m_config.rules) == NO_PLAYER) {
+            Node &node = m_nodes[current];
+            std::uint8_t expansion = node.expansion.load(std::memory_order_acquire);
+            if (expansion != EXPANDED) {
+                // Expand a node the first time a thread comes back to it; a thread finding it being expanded
+                // plays out from here instead of waiting
+                if (expansion != UNEXPANDED ||
+                    !node.expansion.compare_exchange_strong(expansion, EXPANDING, std::memory_order_acquire)) {
+                    break;
+                }
+                if (!expand(node, worker)) {
+                    node.expansion.store(UNEXPANDED, std::memory_order_release);
+                    break;
+                }
+                node.expansion.store(EXPANDED, std::memory_order_release);
+            }
+            if (node.child_count == 0) {
+                break;
+            }
+
+            std::uint32_t child = node.first_child;
+            if (node.chance) {
+                const Move outcome = draw_chance_move(state, worker.random_engine);
+                while (m_nodes[child].move != outcome) {
+                    child++;
+                }
+            } else {
+                child = select_child(node);
+            }
+            Node &next = m_nodes[child];
+            next.virtual_losses.fetch_add(m_config.virtual_loss, std::memory_order_relaxed);
+            apply_move(state, m_config.rules, next.move);
+            worker.path.push_back(child);
+            current = child;
+            if (next.visits.load(std::memory_order_relaxed) == 0) {
+                break;
+            }
+        }
+
+        play_out(worker);
+        for (const std::uint32_t index: worker.path) {
+            Node &node = m_nodes[index];
+            if (index != ROOT) {
+                node.reward.fetch_add(static_cast<std::uint64_t>(worker.rewards[node.player] * REWARD_SCALE),
+                                      std::memory_order_relaxed);
+                node.virtual_losses.fetch_sub(m_config.virtual_loss, std::memory_order_relaxed);
+            }
+            node.visits.fetch_add(1, std::memory_order_relaxed);
+        }
+        state.undo(mark);
+    }
+
+    auto MctsSearch::search(const Game::GameState &state, const std::chrono::nanoseconds budget,
+                            const std::uint64_t max_playouts) -> SearchResult {
+        const auto deadline = std::chrono::steady_clock::now() + budget;
+        MoveList root_moves;
+        generate_moves(state, m_config.rules, root_moves);
+        if (root_moves.empty() || is_chance_node(state)) {
+            throw std::invalid_argument("The player to move has no decision to make");
+        }
+
+        m_nodes[ROOT].reset({MoveKind::END_TURN}, NO_PLAYER);
+        m_node_count.store(1, std::memory_order_relaxed);
+        m_started_playouts.store(0, std::memory_order_relaxed);
+        const std::uint64_t search_seed = m_config.seed + m_search_count++ * 0x9e3779b97f4a7c15ULL;
+
+        std::vector<std::exception_ptr> errors(m_config.thread_count);
+        auto work = [&](const size_t thread) {
+            try {
+                Worker worker{
+                    .state = state.clone(),
+                    .random_engine = std::minstd_rand(static_cast<std::uint32_t>(search_seed + thread)),
+                };
+                // Always at least one playout, so there is an answer however short the budget. Without a cap
+                // the threads do not share a counter at all.
+                const bool capped = max_playouts != std::numeric_limits<std::uint64_t>::max();
+                while (!capped || m_started_playouts.fetch_add(1, std::memory_order_relaxed) < max_playouts) {
+                    run_iteration(worker);
+                    if (std::chrono::steady_clock::now() >= deadline) {
+                        break;
+                    }
+                }
+            } catch (...) {
+                errors[thread] = std::current_exception();
+            }
+        };
+        {
+            std::vector<std::jthread> threads;
+            for (size_t thread = 1; thread < m_config.thread_count; thread++) {
+                threads.emplace_back(work, thread);
+            }
+            work(0);
+        }
+        for (const auto &error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+        const Node &root = m_nodes[ROOT];
+        SearchResult result{
+            .move = root_moves.front(),
+            .playouts = root.visits.load(std::memory_order_relaxed),
+            .nodes = m_node_count.load(std::memory_order_relaxed),
+        };
+        if (root.expansion.load(std::memory_order_acquire) == EXPANDED) {
+            for (std::uint32_t child = root.first_child; child < root.first_child + root.child_count; child++) {
+                const std::uint32_t visits = m_nodes[child].visits.load(std::memory_order_relaxed);
+                if (visits > result.visits) {
+                    result.move = m_nodes[child].move;
+                    result.visits = visits;
+                }
+            }
+        }
+        return result;
+    }
+
+    MctsPolicy::MctsPolicy(const MctsConfig &config, const std::chrono::nanoseconds budget,
+                           const std::uint64_t max_playouts)
+        : m_search(config), m_budget(budget), m_max_playouts(max_playouts) {
+    }
+
+    auto MctsPolicy::choose(const Game::GameState &state, PlayerId, const std::span<const Move> moves) -> size_t {
+        if (moves.size() == 1) {
+            return 0;
+        }
+        const Move best = m_search.search(state, m_budget, m_max_playouts).move;
+        const auto found = std::ranges::find(moves, best);
+        return found != moves.end() ? static_cast<size_t>(found - moves.begin()) : 0;
+    }
+
+    void MctsPolicy::seed(const std::uint64_t seed) { m_search.seed(seed); }
+} // namespace Sim
@@ -0,0 +1,98 @@
+#include "perft.hh"
+
+#include "game_flow.hh"
+
+namespace Sim {
+    namespace {
+        class PerftCounter {
+            Game::GameState &m_state;
+            const PerftConfig &m_config;
+            std::minstd_rand m_random_engine;
+
+        public:
+            PerftCounter(Game::GameState &state, const PerftConfig &config)
+                : m_state(state), m_config(config), m_random_engine(static_cast<std::uint32_t>(config.seed)) {
+            }
+
+            void generate(MoveList &moves) {
+                generate_moves(m_state, m_config.rules, moves);
+                if (m_config.dice == DiceMode::SAMPLE && is_chance_node(m_state)) {
+                    moves.clear();
+                    moves.push_back(draw_chance_move(m_state, m_random_engine));
+                }
+            }
+
+            void count(const Move &move, const std::uint32_t depth, PerftResult &result) {
+                const Game::UndoMark mark = m_state.get_undo_mark();
+                apply_move(m_state, m_config.rules, move);
+                result.nodes++;
+                count(depth, result);
+                m_state.undo(mark);
+            }
+
+            void count(const std::uint32_t depth, PerftResult &result) {
+                if (depth == 0) {
+                    result.leaves++;
+                    return;
+                }
+                if (get_winner(m_state, m_config.rules) != NO_PLAYER) {
+                    return;
+                }
+                // One list per ply, on the stack, so the walk itself never allocates
+                MoveList moves;
+                generate(moves);
+                for (const Move &move: moves) {
+                    count(move, depth - 1, result);
+                }
+            }
+        };
+    } // namespace
+
+    auto perft(Game::GameState &state, const std::uint32_t depth, const PerftConfig &config) -> PerftResult {
+        PerftResult result;
+        PerftCounter(state, config).count(depth, result);
+        return result;
+    }
+
+    auto divide(Game::GameState &state, const std::uint32_t depth, const PerftConfig &config)
+        -> std::vector<PerftDivision> {
+        std::vector<PerftDivision> divisions;
+        if (depth == 0 || get_winner(state, config.rules) != NO_PLAYER) {
+            return divisions;
+        }
+        PerftCounter counter(state, config);
+        MoveList moves;
+        counter.generate(moves);
+        for (const Move &move: moves) {
+            PerftDivision &division = divisions.emplace_back(PerftDivision{.move = move});
+            counter.count(move, depth - 1, division.result);
+        }
+        return divisions;
+    }
+
+    auto make_setup_position(const size_t radius, const std::uint64_t seed, const size_t player_count)
+        -> Game::GameState {
+        Game::GameState state{Map::Map::build_map_of_size(radius, seed), player_count,
+                              static_cast<std::uint32_t>(seed)};
+        for (PlayerId player = 0; player < static_cast<PlayerId>(player_count); player++) {
+            state.add_resources(player, Game::ResourceBundle{} - state.get_resources(player));
+        }
+        state.set_turn(0, Game::GamePhase::FREE_BUILDING);
+        state.clear_undo_log();
+        return state;
+    }
+
+    auto make_opening_position(const size_t radius, const std::uint64_t seed, const size_t player_count)
+        -> Game::GameState {
+        Game::GameState state = make_setup_position(radius, seed, player_count);
+        const Rules rules;
+        std::minstd_rand random_engine(static_cast<std::uint32_t>(seed));
+        MoveList moves;
+        while (state.get_phase() != Game::GamePhase::ROLL) {
+            generate_moves(state, rules, moves);
+            apply_move(state, rules, moves[random_engine() % moves.size()]);
+        }
+        state.clear_undo_log();
+        return state;
+    }
+} // namespace Sim
@@ -0,0 +1,103 @@
+#include "policy.hh"
+#include <cstdlib>
+#include <limits>
+
+namespace Sim {
+    namespace {
+        // Ways two dice make the hex's number, out of 36
+        auto get_pips(const Game::GameState &state, const Map::HexId hex) -> int {
+            const Map::Hex *tile = state.get_map().get_hex(hex);
+            return tile->resource == Map::Resource::NONE ? 0 : 6 - std::abs(7 - tile->number);
+        }
+
+        auto get_corner_pips(const Game::GameState &state, const Map::CornerId corner) -> int {
+            int pips = 0;
+            for (const Map::HexId hex: state.get_map().get_topology().get_corner_hexes(corner)) {
+                pips += get_pips(state, hex);
+            }
+            return pips;
+        }
+
+        // Houses of the opponents next to the hex, minus the player's own counted double
+        auto get_robber_damage(const Game::GameState &state, const PlayerId player, const Map::HexId hex) -> int {
+            int damage = 0;
+            for (const Map::CornerId corner: state.get_map().get_topology().get_hex_corners(hex)) {
+                const House &house = state.get_map().get_corner(corner)->house;
+                if (house.is_built()) {
+                    damage += house.owner == player ? -2 * house.level : house.level;
+                }
+            }
+            return damage * get_pips(state, hex);
+        }
+
+        // Trades only when the card bought completes a city, or a settlement that has somewhere to go.
+        auto get_trade_score(const Game::GameState &state, const Rules &rules, const PlayerId player,
+                             const Move &trade) -> int {
+            Game::ResourceBundle hand = state.get_resources(player);
+            hand[get_traded_away(trade)] = static_cast<std::int16_t>(hand[get_traded_away(trade)] -
+                                                                     static_cast<int>(rules.bank_trade_rate));
+            hand[get_traded_for(trade)]++;
+            const Game::RecipeMask gained = Game::get_affordable_recipes(hand) & ~state.get_affordable_recipes(player);
+            if ((gained & Game::recipe_bit(Game::Recipe::CITY)) != 0) {
+                return 250;
+            }
+            if ((gained & Game::recipe_bit(Game::Recipe::SETTLEMENT)) != 0 &&
+                state.get_legal_moves().get_settlements(player).any()) {
+                return 150;
+            }
+            return -1;
+        }
+
+        auto score(const Game::GameState &state, const Rules &rules, const PlayerId player, const Move &move) -> int {
+            switch (move.kind) {
+                case MoveKind::SETUP_SETTLEMENT:
+                    return get_corner_pips(state, move.target);
+                case MoveKind::SETUP_ROAD:
+                    return 0;
+                case MoveKind::BUILD_CITY:
+                    return 300 + get_corner_pips(state, move.target);
+                case MoveKind::BUILD_SETTLEMENT:
+                    return 200 + get_corner_pips(state, move.target);
+                case MoveKind::BUILD_ROAD:
+                    // Save up for a settlement while there is a corner to put it on
+                    return state.get_legal_moves().get_settlements(player).any() ? -1 : 100;
+                case MoveKind::BANK_TRADE:
+                    return get_trade_score(state, rules, player, move);
+                case MoveKind::MOVE_ROBBER:
+                    return get_robber_damage(state, player, move.target);
+                case MoveKind::END_TURN:
+                case MoveKind::ROLL:
+                case MoveKind::STEAL:
+                    return 0;
+            }
+            return 0;
+        }
+    } // namespace
+
+    RandomPolicy::RandomPolicy(const std::uint32_t seed) : m_random_engine(seed) {
+    }
+
+    void RandomPolicy::seed(const std::uint64_t seed) {
+        m_random_engine.seed(static_cast<std::uint32_t>(seed));
+    }
+
+    auto RandomPolicy::choose(const Game::GameState &, PlayerId, const std::span<const Move> moves) -> size_t {
+        return std::uniform_int_distribution<size_t>(0, moves.size() - 1)(m_random_engine);
+    }
+
+    GreedyPolicy::GreedyPolicy(const Rules &rules) : m_rules(rules) {
+    }
+
+    auto GreedyPolicy::choose(const Game::GameState &state, const PlayerId player,
+                              const std::span<const Move> moves) -> size_t {
+        size_t best = 0;
+        int best_score = std::numeric_limits<int>::min();
+        for (size_t index = 0; index < moves.size(); index++) {
+            if (const int move_score = score(state, m_rules, player, moves[index]); move_score > best_score) {
+                best = index;
+                best_score = move_score;
+            }
+        }
+        return best;
+    }
+} // namespace Sim
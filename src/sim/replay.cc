@@ -0,0 +1,504 @@
+#include "replay.hh"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "game_flow.hh"
+#include "map.hh"
+
+namespace Sim {
+    namespace {
+        constexpr std::array<std::uint8_t, 4> MAGIC{'C', 'L', 'R', 'P'};
+        // High nibble of a keyframe's first byte; moves use their MoveKind
+        constexpr std::uint8_t KEYFRAME = 0xf;
+        // Low nibble saying the delta did not fit and follows as a varint
+        constexpr std::uint8_t ESCAPE = 0xf;
+
+        void put_varint(std::vector<std::uint8_t> &bytes, std::uint64_t value) {
+            while (value >= 0x80) {
+                bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<std::uint8_t>(value));
+        }
+
+        auto zigzag(const std::int64_t value) -> std::uint64_t {
+            return static_cast<std::uint64_t>(value) << 1 ^ static_cast<std::uint64_t>(value >> 63);
+        }
+
+        auto unzigzag(const std::uint64_t value) -> std::int64_t {
+            return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+        }
+
+        // Node ids shifted by one, so Map::NO_NODE is stored as 0.
+        auto to_optional_node(const std::uint32_t node) -> std::uint64_t {
+            return node == Map::NO_NODE ? 0 : std::uint64_t{node} + 1;
+        }
+
+        auto from_optional_node(const std::uint64_t value) -> std::uint32_t {
+            return value == 0 ? Map::NO_NODE : static_cast<std::uint32_t>(value - 1);
+        }
+
+        // The state of the engine as the standard text representation writes it, one number for minstd_rand.
+        auto get_engine_state(const std::minstd_rand &engine) -> std::uint64_t {
+            std::ostringstream text;
+            text << engine;
+            return std::stoull(text.str());
+        }
+
+        void set_engine_state(std::minstd_rand &engine, const std::uint64_t state) {
+            std::istringstream text(std::to_string(state));
+            text >> engine;
+        }
+
+        class ByteReader {
+            std::span<const std::uint8_t> m_bytes;
+            size_t m_offset;
+
+        public:
+            ByteReader(const std::span<const std::uint8_t> bytes, const size_t offset)
+                : m_bytes(bytes), m_offset(offset) {
+            }
+
+            [[nodiscard]] auto get_offset() const -> size_t { return m_offset; }
+
+            [[nodiscard]] auto is_at_end() const -> bool { return m_offset == m_bytes.size(); }
+
+            auto get_byte() -> std::uint8_t {
+                if (m_offset >= m_bytes.size()) {
+                    throw std::invalid_argument("Replay log cut off in the middle of a record");
+                }
+                return m_bytes[m_offset++];
+            }
+
+            auto get_varint() -> std::uint64_t {
+                std::uint64_t value = 0;
+                for (int shift = 0; shift < 64; shift += 7) {
+                    const std::uint8_t byte = get_byte();
+                    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+                    if ((byte & 0x80) == 0) {
+                        return value;
+                    }
+                }
+                throw std::invalid_argument("Replay log holds a varint longer than 64 bits");
+            }
+
+            void skip(const std::uint64_t count) {
+                if (count > m_bytes.size() - m_offset) {
+                    throw std::invalid_argument("Replay log cut off in the middle of a record");
+                }
+                m_offset += static_cast<size_t>(count);
+            }
+        };
+
+        auto to_resource(const std::uint8_t value) -> Map::Resource {
+            if (value >= Map::RESOURCE_COUNT) {
+                throw std::invalid_argument("Replay log holds a resource out of range");
+            }
+            return static_cast<Map::Resource>(value);
+        }
+
+        // Decodes the move starting with `tag`.
+        auto decode_move(ByteReader &reader, const std::uint8_t tag, std::array<std::uint32_t, 16> &last_targets)
+            -> Move {
+            const std::uint8_t kind = tag >> 4;
+            const std::uint8_t payload = tag & 0xf;
+            if (kind > static_cast<std::uint8_t>(MoveKind::STEAL)) {
+                throw std::invalid_argument("Replay log holds a record of unknown kind");
+            }
+            const Move move{static_cast<MoveKind>(kind)};
+            switch (move.kind) {
+                case MoveKind::ROLL:
+                    return {MoveKind::ROLL, payload};
+                case MoveKind::STEAL:
+                    return {MoveKind::STEAL, static_cast<std::uint32_t>(to_resource(payload))};
+                case MoveKind::END_TURN:
+                    return move;
+                case MoveKind::BANK_TRADE:
+                    return {MoveKind::BANK_TRADE, get_trade_target(to_resource(payload),
+                                                                   to_resource(reader.get_byte()))};
+                default:
+                    break;
+            }
+            const std::uint64_t delta = payload == ESCAPE ? ESCAPE + reader.get_varint() : payload;
+            const std::int64_t target = static_cast<std::int64_t>(last_targets[kind]) + unzigzag(delta);
+            if (target < 0 || target > Move::TARGET_MASK) {
+                throw std::invalid_argument("Replay log holds a move target out of range");
+            }
+            last_targets[kind] = static_cast<std::uint32_t>(target);
+            return {move.kind, static_cast<std::uint32_t>(target)};
+        }
+
+        // Throws for a target outside the board, which would index past its nodes.
+        void check_target(const Game::GameState &state, const Move &move) {
+            const auto &topology = state.get_map().get_topology();
+            size_t limit;
+            switch (move.kind) {
+                case MoveKind::SETUP_SETTLEMENT:
+                case MoveKind::BUILD_SETTLEMENT:
+                case MoveKind::BUILD_CITY:
+                    limit = topology.get_corner_count();
+                    break;
+                case MoveKind::SETUP_ROAD:
+                case MoveKind::BUILD_ROAD:
+                    limit = topology.get_edge_count();
+                    break;
+                case MoveKind::MOVE_ROBBER:
+                    limit = topology.get_hex_count();
+                    break;
+                case MoveKind::ROLL:
+                    if (!state.get_roll_manager().find(static_cast<int>(move.target))) {
+                        throw std::invalid_argument("Replay log rolls a value the deck does not hold");
+                    }
+                    return;
+                case MoveKind::STEAL:
+                    if (const PlayerId victim = get_robbery_victim(state);
+                        state.get_phase() != Game::GamePhase::STEAL || victim == NO_PLAYER ||
+                        state.get_resources(victim)[static_cast<Map::Resource>(move.target)] <= 0) {
+                        throw std::invalid_argument("Replay log steals a card the victim does not hold");
+                    }
+                    return;
+                default:
+                    return;
+            }
+            if (move.target >= limit) {
+                throw std::invalid_argument("Replay log holds a move off the board");
+            }
+        }
+    } // namespace
+
+    ReplayWriter::ReplayWriter(const Game::GameState &state, const Rules &rules, const std::uint32_t keyframe_interval)
+        : m_bytes(MAGIC.begin(), MAGIC.end()), m_keyframe_interval(keyframe_interval) {
+        if (keyframe_interval == 0) {
+            throw std::invalid_argument("The keyframe interval must be at least one turn");
+        }
+        put_varint(m_bytes, REPLAY_VERSION);
+        put_varint(m_bytes, keyframe_interval);
+        put_varint(m_bytes, state.get_player_count());
+        for (const std::uint32_t rule: {rules.victory_points, rules.turn_limit, rules.max_settlements,
+                                        rules.max_cities, rules.max_roads, rules.longest_road_minimum,
+                                        rules.hand_limit, rules.bank_trade_rate}) {
+            put_varint(m_bytes, rule);
+        }
+        const Map::Map &map = state.get_map();
+        put_varint(m_bytes, map.get_bounds().radius);
+        for (Map::HexId hex = 0; hex < map.get_topology().get_hex_count(); hex++) {
+            m_bytes.push_back(static_cast<std::uint8_t>(map.get_hex(hex)->resource));
+            m_bytes.push_back(static_cast<std::uint8_t>(map.get_hex(hex)->number));
+        }
+        write_keyframe(state);
+    }
+
+    void ReplayWriter::write_keyframe(const Game::GameState &state) {
+        std::vector<std::uint8_t> &body = m_keyframe;
+        body.clear();
+        body.push_back(static_cast<std::uint8_t>(state.get_current_player()));
+        body.push_back(static_cast<std::uint8_t>(state.get_phase()));
+        body.push_back(static_cast<std::uint8_t>(state.get_longest_road_holder()));
+        put_varint(body, to_optional_node(state.get_robber()));
+        put_varint(body, to_optional_node(state.get_last_built_corner()));
+        for (PlayerId player = 0; player < static_cast<PlayerId>(state.get_player_count()); player++) {
+            for (const Map::Resource resource: Map::RESOURCES) {
+                put_varint(body, zigzag(state.get_resources(player)[resource]));
+            }
+        }
+
+        // Pieces as ascending node ids, each a delta to the previous one
+        const Map::Map &map = state.get_map();
+        const auto &topology = map.get_topology();
+        put_varint(body, state.get_pieces().get_houses().count());
+        std::uint32_t previous = 0;
+        for (Map::CornerId corner = 0; corner < topology.get_corner_count(); corner++) {
+            if (const House &house = map.get_corner(corner)->house; house.is_built()) {
+                put_varint(body, corner - previous);
+                body.push_back(static_cast<std::uint8_t>(house.owner << 2 | house.level));
+                previous = corner;
+            }
+        }
+        size_t road_count = 0;
+        for (PlayerId player = 0; player < static_cast<PlayerId>(state.get_player_count()); player++) {
+            road_count += state.get_pieces().get_roads(player).count();
+        }
+        put_varint(body, road_count);
+        previous = 0;
+        for (Map::EdgeId edge = 0; edge < topology.get_edge_count(); edge++) {
+            if (const Road &road = map.get_edge(edge)->road; road.is_built()) {
+                put_varint(body, edge - previous);
+                body.push_back(static_cast<std::uint8_t>(road.owner));
+                previous = edge;
+            }
+        }
+
+        // The deck as it stands, two rolls to a byte, and the engine that shuffles it next
+        const Game::RollManager &deck = state.get_roll_manager();
+        body.push_back(deck.drawn);
+        for (size_t roll = 0; roll < Game::RollManager::DECK_SIZE; roll += 2) {
+            body.push_back(static_cast<std::uint8_t>(deck.rolls[roll] | deck.rolls[roll + 1] << 4));
+        }
+        put_varint(body, get_engine_state(deck.random_engine));
+
+        m_bytes.push_back(KEYFRAME << 4);
+        put_varint(m_bytes, m_turn_count);
+        put_varint(m_bytes, body.size());
+        m_bytes.insert(m_bytes.end(), body.begin(), body.end());
+        m_last_targets.fill(0);
+    }
+
+    void ReplayWriter::record(const Game::GameState &state, const Move &move) {
+        if (move.kind == MoveKind::ROLL) {
+            if (m_turn_count % m_keyframe_interval == 0) {
+                write_keyframe(state);
+            }
+            m_turn_count++;
+        }
+        const auto kind = static_cast<std::uint8_t>(move.kind);
+        const auto tag = static_cast<std::uint8_t>(kind << 4);
+        switch (move.kind) {
+            case MoveKind::ROLL:
+            case MoveKind::STEAL:
+                m_bytes.push_back(static_cast<std::uint8_t>(tag | move.target));
+                return;
+            case MoveKind::END_TURN:
+                m_bytes.push_back(tag);
+                return;
+            case MoveKind::BANK_TRADE:
+                m_bytes.push_back(static_cast<std::uint8_t>(tag | static_cast<std::uint8_t>(get_traded_away(move))));
+                m_bytes.push_back(static_cast<std::uint8_t>(get_traded_for(move)));
+                return;
+            default:
+                break;
+        }
+        const std::uint64_t delta = zigzag(static_cast<std::int64_t>(move.target) - m_last_targets[kind]);
+        m_last_targets[kind] = move.target;
+        if (delta < ESCAPE) {
+            m_bytes.push_back(static_cast<std::uint8_t>(tag | delta));
+        } else {
+            m_bytes.push_back(tag | ESCAPE);
+            put_varint(m_bytes, delta - ESCAPE);
+        }
+    }
+
+    struct ReplayReader::Header {
+        Rules rules;
+        std::uint32_t keyframe_interval = 0;
+        size_t player_count = 0;
+        Map::Map map;
+        // Where the first keyframe starts
+        size_t offset = 0;
+    };
+
+    auto ReplayReader::read_header(const std::span<const std::uint8_t> bytes) -> Header {
+        if (bytes.size() < MAGIC.size() || !std::equal(MAGIC.begin(), MAGIC.end(), bytes.begin())) {
+            throw std::invalid_argument("Not a replay log");
+        }
+        ByteReader reader(bytes, MAGIC.size());
+        if (reader.get_varint() != REPLAY_VERSION) {
+            throw std::invalid_argument("Replay log of an unsupported version");
+        }
+        const auto keyframe_interval = static_cast<std::uint32_t>(reader.get_varint());
+        const auto player_count = static_cast<size_t>(reader.get_varint());
+        if (keyframe_interval == 0 || player_count == 0 || player_count > 8) {
+            throw std::invalid_argument("Replay log header out of range");
+        }
+        Rules rules;
+        for (std::uint32_t *rule: {&rules.victory_points, &rules.turn_limit, &rules.max_settlements,
+                                   &rules.max_cities, &rules.max_roads, &rules.longest_road_minimum,
+                                   &rules.hand_limit, &rules.bank_trade_rate}) {
+            *rule = static_cast<std::uint32_t>(reader.get_varint());
+        }
+        const std::uint64_t radius = reader.get_varint();
+        if (radius > 64) {
+            throw std::invalid_argument("Replay log header out of range");
+        }
+
+        // The tiles as they were dealt, laid over a board of the same shape
+        Map::Map map = Map::Map::build_map_of_size(static_cast<size_t>(radius), 0);
+        for (Map::HexId hex = 0; hex < map.get_topology().get_hex_count(); hex++) {
+            const std::uint8_t resource = reader.get_byte();
+            if (resource >= Map::RESOURCE_COUNT) {
+                throw std::invalid_argument("Replay log header out of range");
+            }
+            map.get_hex(hex)->resource = static_cast<Map::Resource>(resource);
+            map.get_hex(hex)->number = reader.get_byte();
+        }
+        return Header{
+            .rules = rules,
+            .keyframe_interval = keyframe_interval,
+            .player_count = player_count,
+            .map = std::move(map),
+            .offset = reader.get_offset(),
+        };
+    }
+
+    ReplayReader::ReplayReader(const std::span<const std::uint8_t> bytes) : ReplayReader(bytes, read_header(bytes)) {
+    }
+
+    ReplayReader::ReplayReader(const std::span<const std::uint8_t> bytes, Header header)
+        : m_bytes(bytes),
+          m_rules(header.rules),
+          m_keyframe_interval(header.keyframe_interval),
+          m_state(std::move(header.map), header.player_count, 0) {
+        m_state.clear_undo_log();
+        m_state.snapshot(m_blank);
+
+        // Index the keyframes and check every record decodes, so playing back never meets a torn record
+        ByteReader reader(m_bytes, header.offset);
+        std::array<std::uint32_t, 16> last_targets{};
+        while (!reader.is_at_end()) {
+            const size_t offset = reader.get_offset();
+            const std::uint8_t tag = reader.get_byte();
+            if (tag >> 4 == KEYFRAME) {
+                if (reader.get_varint() != m_turn_count) {
+                    throw std::invalid_argument("Replay log holds a keyframe out of place");
+                }
+                m_keyframes.emplace_back(m_turn_count, offset);
+                reader.skip(reader.get_varint());
+                last_targets.fill(0);
+                continue;
+            }
+            m_turn_count += decode_move(reader, tag, last_targets).kind == MoveKind::ROLL;
+        }
+        if (m_keyframes.empty() || m_keyframes.front().second != header.offset) {
+            throw std::invalid_argument("Replay log does not start with a keyframe");
+        }
+        rewind();
+    }
+
+    void ReplayReader::load_keyframe(const size_t index) {
+        const auto [turn, offset] = m_keyframes[index];
+        m_state.restore(m_blank);
+        ByteReader reader(m_bytes, offset + 1);
+        reader.get_varint();
+        const std::uint64_t size = reader.get_varint();
+        const size_t end = reader.get_offset() + static_cast<size_t>(size);
+
+        const auto player = static_cast<PlayerId>(reader.get_byte());
+        const std::uint8_t phase = reader.get_byte();
+        const auto holder = static_cast<PlayerId>(reader.get_byte());
+        if (player < 0 || player >= static_cast<PlayerId>(m_state.get_player_count()) ||
+            phase > static_cast<std::uint8_t>(Game::GamePhase::STEAL) ||
+            holder < NO_PLAYER || holder >= static_cast<PlayerId>(m_state.get_player_count())) {
+            throw std::invalid_argument("Replay keyframe out of range");
+        }
+        m_state.set_turn(player, static_cast<Game::GamePhase>(phase));
+        m_state.set_longest_road_holder(holder);
+        const auto &topology = m_state.get_map().get_topology();
+        if (const Map::HexId robber = from_optional_node(reader.get_varint()); robber != Map::NO_NODE) {
+            if (robber >= topology.get_hex_count()) {
+                throw std::invalid_argument("Replay keyframe out of range");
+            }
+            m_state.set_robber(robber);
+        }
+        const Map::CornerId last_built = from_optional_node(reader.get_varint());
+        for (PlayerId owner = 0; owner < static_cast<PlayerId>(m_state.get_player_count()); owner++) {
+            Game::ResourceBundle hand;
+            for (const Map::Resource resource: Map::RESOURCES) {
+                hand[resource] = static_cast<std::int16_t>(unzigzag(reader.get_varint()));
+            }
+            m_state.add_resources(owner, hand - m_state.get_resources(owner));
+        }
+
+        // The last house built goes down last, so the setup road that follows it has its corner
+        const auto read_owner = [&](const std::uint8_t owner) {
+            if (owner >= m_state.get_player_count()) {
+                throw std::invalid_argument("Replay keyframe out of range");
+            }
+            return static_cast<PlayerId>(owner);
+        };
+        std::optional<House> last_house;
+        Map::CornerId corner = 0;
+        for (std::uint64_t house = reader.get_varint(); house > 0; house--) {
+            corner += static_cast<Map::CornerId>(reader.get_varint());
+            const std::uint8_t packed = reader.get_byte();
+            if (corner >= topology.get_corner_count() || (packed & 3) == 0 || (packed & 3) > 2) {
+                throw std::invalid_argument("Replay keyframe out of range");
+            }
+            const House built{.owner = read_owner(packed >> 2), .level = static_cast<std::uint8_t>(packed & 3)};
+            if (corner == last_built) {
+                last_house = built;
+            } else {
+                m_state.place_house(corner, built);
+            }
+        }
+        if (last_house) {
+            m_state.place_house(last_built, *last_house);
+        }
+        Map::EdgeId edge = 0;
+        for (std::uint64_t road = reader.get_varint(); road > 0; road--) {
+            edge += static_cast<Map::EdgeId>(reader.get_varint());
+            if (edge >= topology.get_edge_count()) {
+                throw std::invalid_argument("Replay keyframe out of range");
+            }
+            m_state.place_road(edge, Road{.owner = read_owner(reader.get_byte())});
+        }
+
+        Game::RollManager deck = m_state.get_roll_manager();
+        deck.drawn = reader.get_byte();
+        for (size_t roll = 0; roll < Game::RollManager::DECK_SIZE; roll += 2) {
+            const std::uint8_t packed = reader.get_byte();
+            deck.rolls[roll] = static_cast<std::int8_t>(packed & 0xf);
+            deck.rolls[roll + 1] = static_cast<std::int8_t>(packed >> 4);
+        }
+        if (deck.drawn >= Game::RollManager::DECK_SIZE) {
+            throw std::invalid_argument("Replay keyframe out of range");
+        }
+        set_engine_state(deck.random_engine, reader.get_varint());
+        m_state.set_roll_manager(deck);
+        m_state.clear_undo_log();
+
+        m_offset = end;
+        m_turn = turn;
+        m_last_targets.fill(0);
+    }
+
+    auto ReplayReader::is_at_turn_start() const -> bool {
+        if (m_offset == m_bytes.size()) {
+            return false;
+        }
+        const std::uint8_t kind = m_bytes[m_offset] >> 4;
+        return kind == KEYFRAME || kind == static_cast<std::uint8_t>(MoveKind::ROLL);
+    }
+
+    void ReplayReader::rewind() { load_keyframe(0); }
+
+    auto ReplayReader::next() -> std::optional<Move> {
+        while (m_offset < m_bytes.size()) {
+            ByteReader reader(m_bytes, m_offset);
+            const std::uint8_t tag = reader.get_byte();
+            if (tag >> 4 == KEYFRAME) {
+                // The state is already the one it holds
+                reader.get_varint();
+                reader.skip(reader.get_varint());
+                m_offset = reader.get_offset();
+                m_last_targets.fill(0);
+                continue;
+            }
+            const Move move = decode_move(reader, tag, m_last_targets);
+            m_offset = reader.get_offset();
+            check_target(m_state, move);
+            apply_move(m_state, m_rules, move);
+            m_turn += move.kind == MoveKind::ROLL;
+            // Nothing is ever undone here; keep the log from growing with the game
+            m_state.clear_undo_log();
+            return move;
+        }
+        return std::nullopt;
+    }
+
+    void ReplayReader::seek(const std::uint32_t turn) {
+        if (turn > m_turn_count) {
+            throw std::out_of_range("Seek past the end of the replay log");
+        }
+        // The last keyframe at or before the turn; the first one is at turn 0
+        const auto keyframe = std::ranges::upper_bound(m_keyframes, turn, {},
+                                                       [](const auto &entry) { return entry.first; }) - 1;
+        // Play on from where the reader stands when that is past the keyframe and not past the turn
+        if (m_turn > turn || m_offset <= keyframe->second) {
+            load_keyframe(static_cast<size_t>(keyframe - m_keyframes.begin()));
+        }
+        while (!is_finished() && !(m_turn == turn && is_at_turn_start())) {
+            next();
+        }
+    }
+} // namespace Sim
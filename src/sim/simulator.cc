@@ -0,0 +1,117 @@
+#include "simulator.hh"
+#include "game_flow.hh"
+#include "replay.hh"
+#include <utility>
+
+namespace Sim {
+    Simulator::Simulator(Map::Map map, const std::span<Policy *const> policies, const std::uint32_t seed,
+                         const Rules &rules)
+        : m_state(std::move(map), policies.size(), seed),
+          m_policies(policies.begin(), policies.end()),
+          m_rules(rules),
+          m_random_engine(seed) {
+        // GameState deals a starting hand for the interactive game; simulated games start empty handed
+        for (PlayerId player = 0; player < static_cast<PlayerId>(m_policies.size()); player++) {
+            m_state.add_resources(player, Game::ResourceBundle{} - m_state.get_resources(player));
+        }
+    }
+
+    auto Simulator::decide(const PlayerId player) -> Move {
+        return m_moves.at(m_policies[player]->choose(m_state, player, m_moves));
+    }
+
+    void Simulator::apply(const Move &move) {
+        if (m_recorder != nullptr) {
+            m_recorder->record(m_state, move);
+        }
+        apply_move(m_state, m_rules, move);
+    }
+
+    void Simulator::place_setup(const PlayerId player) {
+        m_state.set_turn(player, Game::GamePhase::FREE_BUILDING);
+        generate_moves(m_state, m_rules, m_moves);
+        if (m_moves.empty()) {
+            return;
+        }
+        // Moves on to the player's free road
+        apply(decide(player));
+        generate_moves(m_state, m_rules, m_moves);
+        if (!m_moves.empty()) {
+            apply(decide(player));
+        }
+    }
+
+    void Simulator::play_setup() {
+        const auto player_count = static_cast<PlayerId>(m_policies.size());
+        for (PlayerId player = 0; player < player_count; player++) {
+            place_setup(player);
+        }
+        for (PlayerId player = player_count; player-- > 0;) {
+            place_setup(player);
+        }
+        m_state.clear_undo_log();
+    }
+
+    auto Simulator::play_turn() -> bool {
+        if (is_finished()) {
+            return false;
+        }
+        const PlayerId player = m_current;
+        m_state.set_turn(player, Game::GamePhase::ROLL);
+        // Longest road can change hands during other players' turns, but a game is only won on one's own turn
+        m_winner = Sim::get_winner(m_state, m_rules);
+        if (m_winner == NO_PLAYER) {
+            // The roll on top of the deck is the one a throw of the dice draws
+            apply({MoveKind::ROLL, static_cast<std::uint32_t>(m_state.get_roll_manager().peek(0))});
+            // On a 7 the oversized hands are discarded and the robber has to move
+            if (m_state.get_phase() == Game::GamePhase::MOVE_ROBBER) {
+                generate_moves(m_state, m_rules, m_moves);
+                if (!m_moves.empty()) {
+                    apply(decide(player));
+                }
+            }
+            if (m_state.get_phase() == Game::GamePhase::STEAL) {
+                apply(draw_chance_move(m_state, m_random_engine));
+            }
+        }
+        m_state.set_turn(player, Game::GamePhase::PLAYER_TURN);
+        while (m_winner == NO_PLAYER) {
+            generate_moves(m_state, m_rules, m_moves);
+            const Move move = decide(player);
+            apply(move);
+            if (move.kind == MoveKind::END_TURN) {
+                break;
+            }
+            m_winner = Sim::get_winner(m_state, m_rules);
+        }
+
+        // Nothing in a simulated game is undone, so the log only ever has to hold one turn
+        m_state.clear_undo_log();
+        m_current = static_cast<PlayerId>((m_current + 1) % m_policies.size());
+        m_turn++;
+        return !is_finished();
+    }
+
+    auto Simulator::play() -> GameResult {
+        play_setup();
+        while (play_turn()) {
+        }
+        return get_result();
+    }
+
+    auto Simulator::get_longest_road_holder() const -> PlayerId {
+        return m_state.get_longest_road_holder();
+    }
+
+    auto Simulator::get_victory_points(const PlayerId player) const -> std::uint32_t {
+        return Sim::get_victory_points(m_state, player);
+    }
+
+    auto Simulator::get_result() const -> GameResult {
+        GameResult result{.winner = m_winner, .longest_road = get_longest_road_holder(), .turns = m_turn};
+        for (PlayerId player = 0; player < static_cast<PlayerId>(m_policies.size()); player++) {
+            result.points.push_back(get_victory_points(player));
+        }
+        return result;
+    }
+} // namespace Sim
@@ -0,0 +1,65 @@
+#include <array>
+#include <gtest/gtest.h>
+#include "batch_simulator.hh"
+
+namespace Sim {
+    // Test: Sampled games agree with the scalar GameState on every turn until the batch is done
+    TEST(BatchSimulatorTest, ValidationFindsNoDifference) {
+        BatchSimulator batch({.games = 256, .seed = 4, .validated_games = 32});
+        ASSERT_EQ(batch.get_validation_error(), std::nullopt);
+        while (batch.play_turn()) {
+            ASSERT_EQ(batch.get_validation_error(), std::nullopt);
+        }
+        EXPECT_EQ(batch.get_validation_error(), std::nullopt);
+    }
+
+    // Test: Nearly every game ends with a winner holding the winning points; the rest are boards where nobody
+    // can build any more
+    TEST(BatchSimulatorTest, GamesFinish) {
+        const Rules rules;
+        BatchSimulator batch({.games = 100, .seed = 2});
+        while (batch.play_turn()) {
+        }
+        EXPECT_LE(batch.get_running_count(), 5);
+        for (size_t game = 0; game < batch.get_game_count(); game++) {
+            const PlayerId winner = batch.get_winner(game);
+            if (winner == NO_PLAYER) {
+                continue;
+            }
+            const auto &pieces = batch.get_pieces(game);
+            EXPECT_GE(pieces.get_settlements(winner).count() + 2 * pieces.get_cities(winner).count(),
+                      rules.victory_points);
+        }
+    }
+
+    // Test: The dice follow the two dice distribution across the batch
+    TEST(BatchSimulatorTest, DiceDistribution) {
+        constexpr size_t games = 36000;
+        BatchSimulator batch({.games = games, .seed = 8, .rules = {.victory_points = 1000}});
+        batch.play_turn();
+        std::array<size_t, 13> counts{};
+        for (size_t game = 0; game < games; game++) {
+            counts[batch.get_roll(game)]++;
+        }
+        for (int roll = 2; roll <= 12; roll++) {
+            const double expected = games * (6 - std::abs(7 - roll)) / 36.0;
+            EXPECT_NEAR(counts[roll], expected, expected * 0.15) << "roll " << roll;
+        }
+    }
+
+    // Test: The same seed plays the same batch
+    TEST(BatchSimulatorTest, SeedDeterminesTheBatch) {
+        BatchSimulator first({.games = 64, .seed = 3});
+        BatchSimulator second({.games = 64, .seed = 3});
+        while (first.play_turn()) {
+            ASSERT_TRUE(second.play_turn());
+        }
+        EXPECT_FALSE(second.play_turn());
+        for (size_t game = 0; game < 64; game++) {
+            EXPECT_EQ(first.get_winner(game), second.get_winner(game));
+            for (PlayerId player = 0; player < 4; player++) {
+                EXPECT_EQ(first.get_resources(game, player), second.get_resources(game, player));
+            }
+        }
+    }
+} // namespace Sim
@@ -0,0 +1,149 @@
+#include <array>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include "game_flow.hh"
+#include "mcts.hh"
+#include "simulator.hh"
+
+namespace Sim {
+    namespace {
+        using namespace std::chrono_literals;
+
+        // A state with the setup rounds played by random placements, player 0 about to roll. Hands start empty,
+        // as in the Simulator.
+        auto make_started_game(const std::uint64_t seed, const size_t player_count = 4) -> Game::GameState {
+            Game::GameState state{Map::Map::build_map_of_size(2, seed), player_count, static_cast<std::uint32_t>(seed)};
+            for (PlayerId player = 0; player < static_cast<PlayerId>(player_count); player++) {
+                state.add_resources(player, Game::ResourceBundle{} - state.get_resources(player));
+            }
+            std::minstd_rand random_engine(static_cast<std::uint32_t>(seed));
+            MoveList moves;
+            const Rules rules;
+            while (state.get_phase() != Game::GamePhase::ROLL) {
+                generate_moves(state, rules, moves);
+                apply_move(state, rules, moves[random_engine() % moves.size()]);
+            }
+            return state;
+        }
+
+        auto is_legal(const Game::GameState &state, const Move &move) -> bool {
+            MoveList moves;
+            generate_moves(state, Rules{}, moves);
+            return std::ranges::find(moves, move) != moves.end();
+        }
+    } // namespace
+
+    // Test: The step by step flow plays the setup in snake order and whole games to a winner
+    TEST(GameFlowTest, PlaysWholeGames) {
+        for (const std::uint64_t seed: {1, 2, 3}) {
+            Game::GameState state = make_started_game(seed);
+            EXPECT_EQ(state.get_current_player(), 0);
+            for (PlayerId player = 0; player < 4; player++) {
+                EXPECT_EQ(state.get_pieces().get_settlements(player).count(), 2);
+                EXPECT_EQ(state.get_pieces().get_roads(player).count(), 2);
+            }
+
+            const Rules rules;
+            std::minstd_rand random_engine(static_cast<std::uint32_t>(seed));
+            MoveList moves;
+            int steps = 0;
+            while (get_winner(state, rules) == NO_PLAYER && steps++ < 200000) {
+                if (state.get_phase() == Game::GamePhase::ROLL) {
+                    const int value = state.get_roll_manager().peek(0);
+                    apply_move(state, rules, {MoveKind::ROLL, static_cast<std::uint32_t>(value)});
+                    continue;
+                }
+                generate_moves(state, rules, moves);
+                ASSERT_FALSE(moves.empty());
+                // Favour building so the game ends
+                const auto build = std::ranges::find_if(moves, [](const Move &move) {
+                    return move.kind != MoveKind::END_TURN && move.kind != MoveKind::BANK_TRADE;
+                });
+                apply_move(state, rules, build != moves.end() && random_engine() % 4 != 0
+                                               ? *build
+                                               : moves[random_engine() % moves.size()]);
+                ASSERT_EQ(state.check_legal_moves(), std::nullopt);
+            }
+            const PlayerId winner = get_winner(state, rules);
+            ASSERT_NE(winner, NO_PLAYER);
+            EXPECT_GE(get_victory_points(state, winner), rules.victory_points);
+        }
+    }
+
+    // Test: Searches on one and on several threads answer with a legal move and count their playouts
+    TEST(MctsTest, ReturnsLegalMoves) {
+        Game::GameState state = make_started_game(4);
+        apply_move(state, Rules{}, {MoveKind::ROLL, 6});
+        const Game::ZobristHash hash = state.get_hash();
+        for (const size_t threads: {1, 4}) {
+            MctsSearch search({.thread_count = threads, .seed = 4});
+            const SearchResult result = search.search(state, 10s, 400);
+            EXPECT_TRUE(is_legal(state, result.move));
+            EXPECT_EQ(result.playouts, 400);
+            EXPECT_GT(result.nodes, 1);
+            EXPECT_GT(result.visits, 0);
+        }
+        EXPECT_EQ(state.get_hash(), hash);
+        MctsSearch search({});
+        Game::GameState rolling = make_started_game(4);
+        EXPECT_THROW((void) search.search(rolling, 1s, 10), std::invalid_argument);
+    }
+
+    // Test: With the game one city away, the search builds the city rather than hand the opponent the win
+    TEST(MctsTest, TakesTheWinningBuild) {
+        Game::GameState state{Map::Map::build_map_of_size(2, 5), 2, 5};
+        const auto &layout = state.get_map().get_topology().get_bitboard_layout();
+        // Three cities and three settlements each: nine points, and a city in hand
+        for (int house = 0; house < 12; house++) {
+            Map::CornerId corner = Map::NO_NODE;
+            layout.for_each_corner(state.get_setup_builds(), [&](const Map::CornerId free) {
+                corner = std::min(corner, free);
+            });
+            ASSERT_NE(corner, Map::NO_NODE);
+            state.place_house(corner, House{.owner = static_cast<PlayerId>(house % 2),
+                                            .level = static_cast<std::uint8_t>(house < 6 ? 2 : 1)});
+        }
+        for (PlayerId player = 0; player < 2; player++) {
+            state.add_resources(player, Game::ResourceBundle{} - state.get_resources(player) +
+                                        Game::get_recipe(Game::Recipe::CITY));
+        }
+        state.set_turn(0, Game::GamePhase::PLAYER_TURN);
+        ASSERT_EQ(get_victory_points(state, 0), 9);
+
+        MctsSearch search({.seed = 5});
+        const SearchResult result = search.search(state, 10s, 500);
+        EXPECT_EQ(result.move.kind, MoveKind::BUILD_CITY);
+    }
+
+    // Test: A pool too small for the tree still yields an answer, and one thread with one seed is repeatable
+    TEST(MctsTest, SmallPoolsAndRepeatability) {
+        Game::GameState state = make_started_game(6);
+        apply_move(state, Rules{}, {MoveKind::ROLL, 8});
+
+        MctsSearch tiny({.node_capacity = 8, .seed = 6});
+        const SearchResult cramped = tiny.search(state, 10s, 200);
+        EXPECT_TRUE(is_legal(state, cramped.move));
+        EXPECT_LE(cramped.nodes, 8);
+
+        MctsSearch first({.seed = 6});
+        MctsSearch second({.seed = 6});
+        const SearchResult a = first.search(state, 10s, 300);
+        const SearchResult b = second.search(state, 10s, 300);
+        EXPECT_EQ(a.move, b.move);
+        EXPECT_EQ(a.visits, b.visits);
+        EXPECT_EQ(a.nodes, b.nodes);
+    }
+
+    // Test: An MCTS seat plays whole simulated games against greedy seats
+    TEST(MctsTest, PlaysSimulatedGames) {
+        MctsPolicy mcts({.playout_turns = 8, .seed = 7}, 10s, 30);
+        GreedyPolicy greedy;
+        const std::array<Policy *, 4> seats{&mcts, &greedy, &greedy, &greedy};
+        Simulator simulator(Map::Map::build_map_of_size(2, 7), seats, 7, Rules{.turn_limit = 200});
+        const GameResult result = simulator.play();
+        EXPECT_GT(result.turns, 0);
+        EXPECT_EQ(simulator.get_state().check_legal_moves(), std::nullopt);
+    }
+} // namespace Sim
@@ -0,0 +1,214 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "game_flow.hh"
+#include "move.hh"
+
+namespace {
+    // Every allocation of the test binary goes through here, so a test can count the ones a stretch of code makes
+    std::atomic<std::uint64_t> allocations{0};
+} // namespace
+
+auto operator new(const size_t size) -> void * {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+
+namespace Sim {
+    namespace {
+        // Plays `steps` random moves of the game flow from wherever `state` stands, stopping at a winner.
+        void play_random_line(Game::GameState &state, MoveList &moves, std::minstd_rand &random_engine,
+                              const int steps) {
+            const Rules rules;
+            for (int step = 0; step < steps && get_winner(state, rules) == NO_PLAYER; step++) {
+                generate_moves(state, rules, moves);
+                if (moves.empty()) {
+                    return;
+                }
+                apply_move(state, rules, moves[random_engine() % moves.size()]);
+            }
+        }
+    } // namespace
+
+    // Test: Every kind of move survives the round trip through its 32 bit encoding
+    TEST(MoveTest, EncodingRoundTrips) {
+        const std::uint32_t trade = get_trade_target(Map::Resource::STONE, Map::Resource::WOOD);
+        for (std::uint8_t kind = 0; kind <= static_cast<std::uint8_t>(MoveKind::STEAL); kind++) {
+            for (const std::uint32_t target: {0u, 1u, 12u, trade, Move::TARGET_MASK}) {
+                const Move move{static_cast<MoveKind>(kind), target};
+                EXPECT_EQ(Move::decode(move.encode()), move);
+                EXPECT_EQ(move.encode() >> Move::TARGET_BITS, kind);
+            }
+        }
+    }
+
+    // Test: A MoveList refuses moves past its capacity instead of spilling to the heap
+    TEST(MoveTest, MoveListIsBounded) {
+        MoveList moves;
+        for (size_t move = 0; move < MoveList::MAX_MOVES; move++) {
+            moves.push_back({MoveKind::BUILD_ROAD, static_cast<std::uint32_t>(move)});
+        }
+        EXPECT_EQ(moves.size(), MoveList::MAX_MOVES);
+        EXPECT_EQ(moves[17].target, 17);
+        EXPECT_THROW(moves.push_back({MoveKind::END_TURN}), std::length_error);
+        EXPECT_THROW((void) moves.at(MoveList::MAX_MOVES), std::out_of_range);
+        moves.clear();
+        EXPECT_TRUE(moves.empty());
+    }
+
+    // Test: The ROLL moves are the values left in the deck, each once, and applying one draws it
+    TEST(MoveTest, RollMovesFollowTheDeck) {
+        Game::GameState state{Map::Map::build_map_of_size(2, 3), 4, 3};
+        state.set_turn(0, Game::GamePhase::ROLL);
+        MoveList moves;
+        for (int turn = 0; turn < 30; turn++) {
+            generate_moves(state, Rules{}, moves);
+            ASSERT_FALSE(moves.empty());
+            for (const Move &move: moves) {
+                EXPECT_EQ(move.kind, MoveKind::ROLL);
+                EXPECT_GT(state.get_roll_manager().count(static_cast<int>(move.target)), 0);
+            }
+            size_t left = 0;
+            for (int value = 2; value <= 12; value++) {
+                left += state.get_roll_manager().count(value) > 0;
+            }
+            EXPECT_EQ(moves.size(), left);
+
+            const Move roll = moves[static_cast<size_t>(turn) % moves.size()];
+            apply_move(state, Rules{}, roll);
+            EXPECT_NE(state.get_phase(), Game::GamePhase::ROLL);
+            state.set_turn(0, Game::GamePhase::ROLL);
+        }
+    }
+
+    // Test: A robbery next to a victim is a chance node with one STEAL per resource in the victim's hand, each
+    // drawn with the odds of its pile; next to nobody the turn goes on
+    TEST(MoveTest, StealMovesFollowTheVictimsHand) {
+        Game::GameState state{Map::Map::build_map_of_size(2, 4), 4, 4};
+        const Rules rules;
+        const auto hex = static_cast<Map::HexId>((state.get_robber() + 1) %
+                                                 state.get_map().get_topology().get_hex_count());
+        state.set_turn(0, Game::GamePhase::MOVE_ROBBER);
+        apply_move(state, rules, {MoveKind::MOVE_ROBBER, hex});
+        EXPECT_EQ(state.get_phase(), Game::GamePhase::PLAYER_TURN);
+
+        state.place_house(state.get_map().get_topology().get_hex_corners(hex)[0], House{.owner = 1, .level = 1});
+        state.add_resources(1, Game::ResourceBundle{{Map::Resource::WOOD, 3}, {Map::Resource::STONE, 1}} -
+                                   state.get_resources(1));
+        state.set_turn(0, Game::GamePhase::MOVE_ROBBER);
+        apply_move(state, rules, {MoveKind::MOVE_ROBBER, hex});
+        ASSERT_EQ(state.get_phase(), Game::GamePhase::STEAL);
+        EXPECT_TRUE(is_chance_node(state));
+        EXPECT_EQ(get_robbery_victim(state), 1);
+        MoveList moves;
+        generate_moves(state, rules, moves);
+        ASSERT_EQ(moves.size(), 2);
+        EXPECT_EQ(moves[0], (Move{MoveKind::STEAL, static_cast<std::uint32_t>(Map::Resource::WOOD)}));
+        EXPECT_EQ(moves[1], (Move{MoveKind::STEAL, static_cast<std::uint32_t>(Map::Resource::STONE)}));
+
+        std::minstd_rand random_engine(4);
+        int wood = 0;
+        for (int draw = 0; draw < 4000; draw++) {
+            wood += draw_chance_move(state, random_engine) == moves[0];
+        }
+        EXPECT_NEAR(wood, 3000, 150);
+
+        const int stone = state.get_resources(0)[Map::Resource::STONE];
+        apply_move(state, rules, moves[1]);
+        EXPECT_EQ(state.get_resources(0)[Map::Resource::STONE], stone + 1);
+        EXPECT_EQ(state.get_resources(1)[Map::Resource::STONE], 0);
+        EXPECT_EQ(state.get_phase(), Game::GamePhase::PLAYER_TURN);
+    }
+
+    // Test: Longest road goes to the first road of the minimum length, stays with its holder through a tie, moves
+    // on a strictly longer road and comes back on undo; a minimum of 0 still takes a road
+    TEST(MoveTest, LongestRoadStaysWithItsHolderOnATie) {
+        Game::GameState state{Map::Map::build_map_of_size(3, 7), 3, 7};
+        const auto &topology = state.get_map().get_topology();
+        // Extends the player's road from `corner` by `length` edges to corners it has not passed yet
+        std::vector<bool> visited(topology.get_corner_count(), false);
+        const auto build_trail = [&](const PlayerId player, Map::CornerId corner, const int length) {
+            visited[corner] = true;
+            for (int road = 0; road < length; road++) {
+                for (const Map::EdgeId edge: topology.get_corner_edges(corner)) {
+                    const auto corners = topology.get_edge_corners(edge);
+                    const Map::CornerId next = corners[0] == corner ? corners[1] : corners[0];
+                    if (!visited[next]) {
+                        state.place_road(edge, Road{.owner = player});
+                        visited[next] = true;
+                        corner = next;
+                        break;
+                    }
+                }
+            }
+            return corner;
+        };
+        Rules rules;
+        rules.longest_road_minimum = 2;
+
+        const Map::CornerId end = build_trail(0, 0, 1);
+        update_longest_road(state, rules);
+        EXPECT_EQ(state.get_longest_road_holder(), NO_PLAYER);
+        build_trail(0, end, 1);
+        update_longest_road(state, rules);
+        EXPECT_EQ(state.get_longest_road_holder(), 0);
+        EXPECT_EQ(get_victory_points(state, 0), state.get_building_points(0) + 2);
+
+        const Game::UndoMark tie = state.get_undo_mark();
+        const Map::CornerId other = build_trail(1, static_cast<Map::CornerId>(topology.get_corner_count() - 1), 2);
+        update_longest_road(state, rules);
+        EXPECT_EQ(state.get_longest_road_holder(), 0);
+        build_trail(1, other, 1);
+        update_longest_road(state, rules);
+        EXPECT_EQ(state.get_longest_road_holder(), 1);
+        EXPECT_EQ(state.get_hash(), state.compute_hash());
+        state.undo(tie);
+        EXPECT_EQ(state.get_longest_road_holder(), 0);
+        EXPECT_EQ(state.get_hash(), state.compute_hash());
+
+        Game::GameState open{Map::Map::build_map_of_size(3, 7), 3, 7};
+        rules.longest_road_minimum = 0;
+        update_longest_road(open, rules);
+        EXPECT_EQ(open.get_longest_road_holder(), NO_PLAYER);
+        open.place_road(open.get_map().get_topology().get_corner_edges(0)[0], Road{.owner = 2});
+        update_longest_road(open, rules);
+        EXPECT_EQ(open.get_longest_road_holder(), 2);
+    }
+
+    // Test: Once the undo log has grown, generating, applying and undoing moves never allocates
+    TEST(MoveTest, GenerateApplyUndoDoNotAllocate) {
+        Game::GameState state{Map::Map::build_map_of_size(2, 9), 4, 9};
+        MoveList moves;
+        std::minstd_rand random_engine(9);
+        play_random_line(state, moves, random_engine, 40);
+
+        const Game::UndoMark mark = state.get_undo_mark();
+        std::minstd_rand warm_up(10);
+        for (int line = 0; line < 20; line++) {
+            play_random_line(state, moves, warm_up, 200);
+            state.undo(mark);
+        }
+
+        // The same lines again, so the log and the saved decks need no more room than before
+        const std::uint64_t before = allocations.load(std::memory_order_relaxed);
+        std::minstd_rand replay(10);
+        for (int line = 0; line < 20; line++) {
+            play_random_line(state, moves, replay, 200);
+            state.undo(mark);
+        }
+        EXPECT_EQ(allocations.load(std::memory_order_relaxed), before);
+        EXPECT_EQ(state.check_legal_moves(), std::nullopt);
+    }
+} // namespace Sim
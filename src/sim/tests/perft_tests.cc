@@ -0,0 +1,74 @@
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+#include "game_flow.hh"
+#include "perft.hh"
+
+namespace Sim {
+    namespace {
+        auto count_leaves(Game::GameState &state, const std::uint32_t max_depth, const PerftConfig &config = {})
+            -> std::vector<std::uint64_t> {
+            std::vector<std::uint64_t> leaves;
+            for (std::uint32_t depth = 1; depth <= max_depth; depth++) {
+                leaves.push_back(perft(state, depth, config).leaves);
+            }
+            return leaves;
+        }
+    } // namespace
+
+    // Test: The setup rounds have the same counts on every standard board, whatever its tiles
+    TEST(PerftTest, SetupCounts) {
+        for (const std::uint64_t seed: {1, 2, 3}) {
+            Game::GameState state = make_setup_position(2, seed, 4);
+            EXPECT_EQ(count_leaves(state, 4), (std::vector<std::uint64_t>{54, 144, 7236, 19248}));
+        }
+        Game::GameState larger = make_setup_position(3, 1, 3);
+        EXPECT_EQ(count_leaves(larger, 3), (std::vector<std::uint64_t>{96, 264, 24336}));
+    }
+
+    // Test: Reference counts from the opening, every dice value left in the deck and every card a robbery can
+    // take expanded
+    TEST(PerftTest, OpeningCounts) {
+        const std::array<std::vector<std::uint64_t>, 3> expected{{
+            {11, 28, 139, 389, 1889, 7472, 29906},
+            {11, 28, 140, 554, 2115, 10646, 41530},
+            {11, 28, 126, 410, 1613, 5894, 21789},
+        }};
+        for (std::uint64_t seed = 1; seed <= 3; seed++) {
+            Game::GameState state = make_opening_position(2, seed, 4);
+            EXPECT_EQ(count_leaves(state, 7), expected[seed - 1]) << "seed " << seed;
+        }
+    }
+
+    // Test: Sampled chance nodes give one outcome each and the same counts for the same seed
+    TEST(PerftTest, SampledDiceCounts) {
+        Game::GameState state = make_opening_position(2, 1, 4);
+        const PerftConfig config{.dice = DiceMode::SAMPLE, .seed = 1};
+        EXPECT_EQ(count_leaves(state, 8, config), (std::vector<std::uint64_t>{1, 18, 18, 18, 18, 52, 90, 155}));
+    }
+
+    // Test: Divide adds up to perft, and neither leaves a trace on the state
+    TEST(PerftTest, DivideAddsUpAndStateIsUntouched) {
+        Game::GameState state = make_opening_position(2, 2, 4);
+        const Game::ZobristHash hash = state.get_hash();
+        const Game::UndoMark mark = state.get_undo_mark();
+
+        const PerftResult total = perft(state, 6);
+        std::uint64_t leaves = 0;
+        std::uint64_t nodes = 0;
+        const std::vector<PerftDivision> divisions = divide(state, 6);
+        for (const PerftDivision &division: divisions) {
+            leaves += division.result.leaves;
+            nodes += division.result.nodes;
+        }
+        EXPECT_EQ(divisions.size(), perft(state, 1).leaves);
+        EXPECT_EQ(leaves, total.leaves);
+        EXPECT_EQ(nodes, total.nodes);
+
+        EXPECT_EQ(state.get_hash(), hash);
+        EXPECT_EQ(state.get_undo_mark(), mark);
+        EXPECT_EQ(state.get_phase(), Game::GamePhase::ROLL);
+        EXPECT_EQ(state.check_legal_moves(), std::nullopt);
+    }
+} // namespace Sim
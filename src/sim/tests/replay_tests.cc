@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "game_flow.hh"
+#include "perft.hh"
+#include "policy.hh"
+#include "replay.hh"
+#include "simulator.hh"
+
+namespace Sim {
+    namespace {
+        // Everything a replay restores: the pieces, the hands, the robber and the deck. Who moves next is left
+        // out, since the Simulator only sets it when a turn starts.
+        struct Observed {
+            std::vector<Game::ResourceBundle> resources{};
+            std::vector<Map::CornerBoard> settlements{};
+            std::vector<Map::CornerBoard> cities{};
+            std::vector<Map::EdgeBoard> roads{};
+            Map::HexId robber;
+            std::uint8_t drawn;
+            std::array<std::int8_t, Game::RollManager::DECK_SIZE> rolls;
+
+            auto operator==(const Observed &other) const -> bool = default;
+        };
+
+        auto observe(const Game::GameState &state) -> Observed {
+            Observed observed{
+                .robber = state.get_robber(),
+                .drawn = state.get_roll_manager().drawn,
+                .rolls = state.get_roll_manager().rolls,
+            };
+            for (PlayerId player = 0; player < static_cast<PlayerId>(state.get_player_count()); player++) {
+                observed.resources.push_back(state.get_resources(player));
+                observed.settlements.push_back(state.get_pieces().get_settlements(player));
+                observed.cities.push_back(state.get_pieces().get_cities(player));
+                observed.roads.push_back(state.get_pieces().get_roads(player));
+            }
+            return observed;
+        }
+
+        struct RecordedGame {
+            std::vector<std::uint8_t> log;
+            // State and hash at the start of every turn, before its roll
+            std::vector<Observed> turn_starts;
+            std::vector<Game::ZobristHash> turn_hashes;
+            Observed end;
+            size_t moves = 0;
+        };
+
+        // A game played through the game flow from before the setup, recorded move by move.
+        auto record_game(const std::uint64_t seed, const std::uint32_t keyframe_interval) -> RecordedGame {
+            Game::GameState state = make_setup_position(2, seed, 4);
+            const Rules rules{.turn_limit = 300};
+            ReplayWriter writer(state, rules, keyframe_interval);
+            RecordedGame game;
+            std::minstd_rand random_engine(static_cast<std::uint32_t>(seed));
+            MoveList moves;
+            for (std::uint32_t turn = 0; turn < rules.turn_limit && get_winner(state, rules) == NO_PLAYER;) {
+                generate_moves(state, rules, moves);
+                // Dice come off the top of the deck; otherwise favour building so the game goes somewhere
+                Move move = moves[random_engine() % moves.size()];
+                if (state.get_phase() == Game::GamePhase::ROLL) {
+                    move = {MoveKind::ROLL, static_cast<std::uint32_t>(state.get_roll_manager().peek(0))};
+                    game.turn_starts.push_back(observe(state));
+                    game.turn_hashes.push_back(state.get_hash());
+                    turn++;
+                } else if (const auto build = std::ranges::find_if(moves, [](const Move &candidate) {
+                    return candidate.kind != MoveKind::END_TURN && candidate.kind != MoveKind::BANK_TRADE;
+                }); build != moves.end() && random_engine() % 3 != 0) {
+                    move = *build;
+                }
+                writer.record(state, move);
+                apply_move(state, rules, move);
+                state.clear_undo_log();
+                game.moves++;
+            }
+            game.end = observe(state);
+            const auto bytes = writer.get_bytes();
+            game.log.assign(bytes.begin(), bytes.end());
+            return game;
+        }
+    } // namespace
+
+    // Test: Playing a log back gives the state of every turn start and the end of the game
+    TEST(ReplayTest, PlaysBackTheGame) {
+        for (const std::uint64_t seed: {1, 2, 3}) {
+            const RecordedGame game = record_game(seed, 8);
+            ReplayReader reader(game.log);
+            ASSERT_EQ(reader.get_turn_count(), game.turn_starts.size());
+            size_t moves = 0;
+            for (std::uint32_t turn = 0; turn < reader.get_turn_count(); turn++) {
+                while (reader.get_turn() < turn || reader.get_state().get_phase() != Game::GamePhase::ROLL) {
+                    ASSERT_TRUE(reader.next());
+                    moves++;
+                }
+                ASSERT_EQ(observe(reader.get_state()), game.turn_starts[turn]) << "turn " << turn;
+                ASSERT_EQ(reader.get_state().get_hash(), game.turn_hashes[turn]) << "turn " << turn;
+            }
+            while (reader.next()) {
+                moves++;
+            }
+            EXPECT_EQ(moves, game.moves);
+            EXPECT_EQ(observe(reader.get_state()), game.end);
+            EXPECT_EQ(reader.get_state().check_legal_moves(), std::nullopt);
+        }
+    }
+
+    // Test: Seeking to turns in any order lands on the state of that turn's start, whatever the keyframe interval
+    TEST(ReplayTest, SeeksToAnyTurn) {
+        for (const std::uint32_t interval: {1u, 5u, 16u, 1000u}) {
+            const RecordedGame game = record_game(4, interval);
+            ReplayReader reader(game.log);
+            std::vector<std::uint32_t> turns(reader.get_turn_count());
+            for (std::uint32_t turn = 0; turn < turns.size(); turn++) {
+                turns[turn] = turn;
+            }
+            std::ranges::shuffle(turns, std::mt19937(interval));
+            // Forward within a stretch too
+            turns.insert(turns.end(), {0, 1, 2, 3, 4, 5});
+            for (const std::uint32_t turn: turns) {
+                reader.seek(turn);
+                EXPECT_EQ(reader.get_turn(), turn);
+                ASSERT_EQ(observe(reader.get_state()), game.turn_starts[turn]) << "turn " << turn;
+                ASSERT_EQ(reader.get_state().get_hash(), game.turn_hashes[turn]) << "turn " << turn;
+            }
+            reader.seek(reader.get_turn_count());
+            EXPECT_TRUE(reader.is_finished());
+            EXPECT_EQ(observe(reader.get_state()), game.end);
+            EXPECT_THROW(reader.seek(reader.get_turn_count() + 1), std::out_of_range);
+        }
+    }
+
+    // Test: A Simulator game, robberies included, replays to the Simulator's own final state
+    TEST(ReplayTest, RecordsSimulatorGames) {
+        for (const std::uint32_t seed: {5, 6, 7}) {
+            GreedyPolicy greedy;
+            RandomPolicy random{seed};
+            const std::array<Policy *, 4> seats{&greedy, &random, &greedy, &random};
+            Simulator simulator(Map::Map::build_map_of_size(2, seed), seats, seed);
+            ReplayWriter writer(simulator.get_state(), Rules{}, 16);
+            simulator.record_to(&writer);
+            const GameResult result = simulator.play();
+            EXPECT_EQ(writer.get_turn_count(), result.turns - (result.winner != NO_PLAYER ? 1 : 0) + 1)
+                << "seed " << seed;
+
+            ReplayReader reader(writer.get_bytes());
+            reader.seek(reader.get_turn_count());
+            EXPECT_EQ(observe(reader.get_state()), observe(simulator.get_state())) << "seed " << seed;
+        }
+    }
+
+    // Test: Moves take little more than a byte each; keyframes cost a couple of hundred bytes at most
+    TEST(ReplayTest, LogIsCompact) {
+        const RecordedGame sparse = record_game(8, 100000);
+        const RecordedGame dense = record_game(8, 1);
+        const double keyframe_size = static_cast<double>(dense.log.size() - sparse.log.size()) /
+                                     static_cast<double>(dense.turn_starts.size());
+        EXPECT_LT(static_cast<double>(sparse.log.size()) / static_cast<double>(sparse.moves), 1.5);
+        EXPECT_LT(keyframe_size, 200);
+    }
+
+    // Test: Logs that are not replay logs, or are cut off inside a record, are refused rather than misread
+    TEST(ReplayTest, RejectsDamagedLogs) {
+        const RecordedGame game = record_game(9, 4);
+        std::vector<std::uint8_t> damaged = game.log;
+        damaged[0] = 'X';
+        EXPECT_THROW(ReplayReader{damaged}, std::invalid_argument);
+        damaged = game.log;
+        damaged[4] = REPLAY_VERSION + 1;
+        EXPECT_THROW(ReplayReader{damaged}, std::invalid_argument);
+
+        // Any cut either lands between records and reads as a shorter game, or is refused
+        size_t refused = 0;
+        for (size_t size = 0; size < game.log.size(); size += 7) {
+            const std::span<const std::uint8_t> cut(game.log.data(), size);
+            try {
+                ReplayReader reader(cut);
+                reader.seek(reader.get_turn_count());
+                EXPECT_EQ(reader.get_state().check_legal_moves(), std::nullopt);
+            } catch (const std::invalid_argument &) {
+                refused++;
+            }
+        }
+        EXPECT_GT(refused, 0);
+        EXPECT_THROW(ReplayWriter(make_setup_position(2, 1, 4), Rules{}, 0), std::invalid_argument);
+    }
+} // namespace Sim
@@ -0,0 +1,106 @@
+#include <array>
+#include <gtest/gtest.h>
+#include "map.hh"
+#include "policy.hh"
+#include "simulator.hh"
+
+namespace Sim {
+    namespace {
+        auto play_random_game(const std::uint32_t seed) -> GameResult {
+            std::array<RandomPolicy, 4> policies{RandomPolicy{seed}, RandomPolicy{seed + 1}, RandomPolicy{seed + 2},
+                                                 RandomPolicy{seed + 3}};
+            const std::array<Policy *, 4> seats{&policies[0], &policies[1], &policies[2], &policies[3]};
+            Simulator simulator(Map::Map::build_map_of_size(2, seed), seats, seed);
+            return simulator.play();
+        }
+    } // namespace
+
+    // Test: Setup gives every player two settlements and two roads, and the second settlement's hexes pay out
+    TEST(SimulatorTest, SetupPlacesTwoOfEach) {
+        GreedyPolicy greedy;
+        const std::array<Policy *, 4> seats{&greedy, &greedy, &greedy, &greedy};
+        Simulator simulator(Map::Map::build_map_of_size(2, 3), seats, 3);
+        simulator.play_setup();
+
+        const auto &pieces = simulator.get_state().get_pieces();
+        for (PlayerId player = 0; player < 4; player++) {
+            EXPECT_EQ(pieces.get_settlements(player).count(), 2);
+            EXPECT_EQ(pieces.get_roads(player).count(), 2);
+            EXPECT_GE(simulator.get_state().get_resources(player).total(), 1);
+            EXPECT_LE(simulator.get_state().get_resources(player).total(), 3);
+        }
+        EXPECT_EQ(simulator.get_state().check_legal_moves(), std::nullopt);
+    }
+
+    // Test: The same seed plays out the same game
+    TEST(SimulatorTest, SeedDeterminesTheGame) {
+        const GameResult first = play_random_game(17);
+        const GameResult second = play_random_game(17);
+        EXPECT_EQ(first.winner, second.winner);
+        EXPECT_EQ(first.turns, second.turns);
+        EXPECT_EQ(first.points, second.points);
+    }
+
+    // Test: Greedy games end with a winner, within the piece limits and without negative hands
+    TEST(SimulatorTest, GreedyGamesFinish) {
+        GreedyPolicy greedy;
+        const std::array<Policy *, 4> seats{&greedy, &greedy, &greedy, &greedy};
+        const Rules rules;
+        for (std::uint32_t seed = 0; seed < 20; seed++) {
+            Simulator simulator(Map::Map::build_map_of_size(2, seed), seats, seed, rules);
+            const GameResult result = simulator.play();
+            ASSERT_NE(result.winner, NO_PLAYER) << "seed " << seed;
+            EXPECT_GE(result.points[result.winner], rules.victory_points);
+
+            const auto &state = simulator.get_state();
+            // Nothing is undone in a simulated game, so nothing is kept to undo
+            EXPECT_EQ(state.get_undo_mark(), 0);
+            for (PlayerId player = 0; player < 4; player++) {
+                EXPECT_LE(state.get_pieces().get_settlements(player).count(), rules.max_settlements);
+                EXPECT_LE(state.get_pieces().get_cities(player).count(), rules.max_cities);
+                EXPECT_LE(state.get_pieces().get_roads(player).count(), rules.max_roads);
+                for (const Map::Resource resource: Map::RESOURCES) {
+                    EXPECT_GE(state.get_resources(player)[resource], 0);
+                }
+            }
+            EXPECT_EQ(state.check_legal_moves(), std::nullopt);
+        }
+    }
+
+    // Test: A game that cannot finish stops at the turn limit without a winner
+    TEST(SimulatorTest, TurnLimitEndsTheGame) {
+        GreedyPolicy greedy;
+        const std::array<Policy *, 4> seats{&greedy, &greedy, &greedy, &greedy};
+        Simulator simulator(Map::Map::build_map_of_size(2, 5), seats, 5, Rules{.victory_points = 1000, .turn_limit = 40});
+        const GameResult result = simulator.play();
+        EXPECT_EQ(result.winner, NO_PLAYER);
+        EXPECT_EQ(result.turns, 40);
+        EXPECT_FALSE(simulator.play_turn());
+    }
+
+    // Test: A policy answering with an index outside the list is rejected
+    TEST(SimulatorTest, RejectsInvalidChoices) {
+        struct OutOfRangePolicy final : Policy {
+            auto choose(const Game::GameState &, PlayerId, std::span<const Move> moves) -> size_t override {
+                return moves.size();
+            }
+        } broken;
+        const std::array<Policy *, 2> seats{&broken, &broken};
+        Simulator simulator(Map::Map::build_map_of_size(2, 1), seats, 1);
+        EXPECT_THROW(simulator.play_setup(), std::out_of_range);
+    }
+
+    // Test: The greedy policy counts bank trades at the rate of the rules it plays by
+    TEST(SimulatorTest, GreedyTradesAtTheRulesRate) {
+        Game::GameState state{Map::Map::build_map_of_size(2, 1), 4, 1};
+        state.add_resources(0, Game::ResourceBundle{} - state.get_resources(0));
+        state.add_resources(0, Game::ResourceBundle{{Map::Resource::STONE, 6}, {Map::Resource::WHEAT, 1}});
+        // Three stone for a wheat leaves enough for a city, four does not
+        const std::array moves{
+            Move{MoveKind::END_TURN},
+            Move{MoveKind::BANK_TRADE, get_trade_target(Map::Resource::STONE, Map::Resource::WHEAT)},
+        };
+        EXPECT_EQ(GreedyPolicy{Rules{.bank_trade_rate = 3}}.choose(state, 0, moves), 1);
+        EXPECT_EQ(GreedyPolicy{}.choose(state, 0, moves), 0);
+    }
+} // namespace Sim
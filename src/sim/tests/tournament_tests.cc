@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <atomic>
+#include <gtest/gtest.h>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "policy.hh"
+#include "tournament.hh"
+#include "work_stealing.hh"
+
+namespace Sim {
+    namespace {
+        auto make_entrants() -> std::vector<PolicyFactory> {
+            return {
+                [] { return std::make_unique<GreedyPolicy>(); },
+                [] { return std::make_unique<RandomPolicy>(0); },
+                [] { return std::make_unique<GreedyPolicy>(); },
+                [] { return std::make_unique<RandomPolicy>(0); },
+            };
+        }
+    } // namespace
+
+    // Test: Every task is handed out exactly once, also while workers steal from each other
+    TEST(WorkStealingTest, HandsOutEveryTaskOnce) {
+        constexpr std::uint32_t task_count = 100000;
+        constexpr size_t worker_count = 8;
+        WorkStealingScheduler scheduler(task_count, worker_count);
+        std::vector<std::atomic<int> > taken(task_count);
+        {
+            std::vector<std::jthread> workers;
+            for (size_t worker = 0; worker < worker_count; worker++) {
+                workers.emplace_back([&, worker] {
+                    while (const auto task = scheduler.next(worker)) {
+                        taken[*task]++;
+                    }
+                });
+            }
+        }
+        EXPECT_TRUE(std::ranges::all_of(taken, [](const std::atomic<int> &count) { return count == 1; }));
+    }
+
+    // Test: A worker whose own share is empty steals from the others until nothing is left
+    TEST(WorkStealingTest, IdleWorkerSteals) {
+        WorkStealingScheduler scheduler(10, 2);
+        size_t stolen = 0;
+        while (scheduler.next(1)) {
+            stolen++;
+        }
+        EXPECT_EQ(stolen, 10);
+        EXPECT_FALSE(scheduler.next(0).has_value());
+    }
+
+    // Test: The totals do not depend on how many threads play the games
+    TEST(TournamentTest, ResultIsIndependentOfThreadCount) {
+        const auto entrants = make_entrants();
+        const TournamentStats single = run_tournament({.games = 40, .seed = 9, .thread_count = 1}, entrants);
+        const TournamentStats parallel = run_tournament({.games = 40, .seed = 9, .thread_count = 4}, entrants);
+        EXPECT_EQ(single, parallel);
+        EXPECT_NE(single, run_tournament({.games = 40, .seed = 10, .thread_count = 1}, entrants));
+    }
+
+    // Test: Every game is counted once, with one winner per decided game
+    TEST(TournamentTest, CountsEveryGame) {
+        const auto entrants = make_entrants();
+        const TournamentStats stats = run_tournament({.games = 24, .seed = 1, .thread_count = 3}, entrants);
+        EXPECT_EQ(stats.games, 24);
+        std::uint64_t wins = 0;
+        for (const EntrantStats &entrant: stats.entrants) {
+            wins += entrant.wins;
+        }
+        EXPECT_EQ(wins, stats.decided);
+        EXPECT_GT(stats.turns, 0);
+    }
+
+    // Test: An exception thrown inside a worker reaches the caller
+    TEST(TournamentTest, RethrowsWorkerErrors) {
+        const std::vector<PolicyFactory> entrants{
+            [] { return std::make_unique<GreedyPolicy>(); },
+            []() -> std::unique_ptr<Policy> { throw std::runtime_error("no policy"); },
+        };
+        EXPECT_THROW((void) run_tournament({.games = 4, .player_count = 2, .thread_count = 2}, entrants),
+                     std::runtime_error);
+    }
+
+    // Test: Entrants that do not fill the seats one each are refused before any game is played
+    TEST(TournamentTest, RejectsEntrantsNotMatchingTheSeats) {
+        const auto entrants = make_entrants();
+        EXPECT_THROW((void) run_tournament({.games = 4, .player_count = 3}, entrants), std::invalid_argument);
+        EXPECT_THROW((void) run_tournament({.games = 4, .player_count = 5}, entrants), std::invalid_argument);
+        EXPECT_EQ(run_tournament({.games = 4, .player_count = 4}, entrants).games, 4);
+    }
+} // namespace Sim
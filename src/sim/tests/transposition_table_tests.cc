@@ -0,0 +1,115 @@
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include "transposition_table.hh"
+
+namespace Sim {
+    namespace {
+        // Hashes landing in bucket 0 of a table with `bucket_count` buckets
+        auto in_first_bucket(const std::uint64_t index, const size_t bucket_count) -> Game::ZobristHash {
+            return (index + 1) * bucket_count;
+        }
+
+        auto entry_for(const Game::ZobristHash hash) -> TranspositionEntry {
+            return {
+                .move = static_cast<std::uint32_t>(hash >> 32),
+                .value = static_cast<std::int16_t>(hash),
+                .depth = static_cast<std::uint8_t>(hash >> 16 & 63),
+                .bound = Bound::EXACT,
+            };
+        }
+    } // namespace
+
+    // Test: Entries pack losslessly and come back only for their own hash
+    TEST(TranspositionTableTest, StoreAndProbe) {
+        TranspositionTable table(1 << 16);
+        const TranspositionEntry entry{.move = 0xdeadbeef, .value = -1234, .depth = 17, .bound = Bound::LOWER};
+        table.store(0x123456789abcdefULL, entry);
+
+        const auto found = table.probe(0x123456789abcdefULL);
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(found->move, entry.move);
+        EXPECT_EQ(found->value, entry.value);
+        EXPECT_EQ(found->depth, entry.depth);
+        EXPECT_EQ(found->bound, entry.bound);
+        EXPECT_FALSE(table.probe(0x123456789abcdeeULL).has_value());
+
+        table.clear();
+        EXPECT_FALSE(table.probe(0x123456789abcdefULL).has_value());
+    }
+
+    // Test: A much shallower bound does not overwrite a deeper result of the same search, an exact one does
+    TEST(TranspositionTableTest, KeepsDeeperResults) {
+        TranspositionTable table(1 << 16);
+        table.store(42, {.move = 1, .depth = 10, .bound = Bound::LOWER});
+        table.store(42, {.move = 2, .depth = 3, .bound = Bound::UPPER});
+        EXPECT_EQ(table.probe(42)->move, 1);
+        table.store(42, {.move = 3, .depth = 9, .bound = Bound::UPPER});
+        EXPECT_EQ(table.probe(42)->move, 3);
+        table.store(42, {.move = 4, .depth = 1, .bound = Bound::EXACT});
+        EXPECT_EQ(table.probe(42)->move, 4);
+
+        // A later search replaces anything
+        table.new_search();
+        table.store(42, {.move = 5, .depth = 0, .bound = Bound::LOWER});
+        EXPECT_EQ(table.probe(42)->move, 5);
+    }
+
+    // Test: A full bucket gives up its shallowest entry, and entries of older searches before those of this one
+    TEST(TranspositionTableTest, ReplacesByDepthAndAge) {
+        TranspositionTable table(1 << 12);
+        const size_t bucket_count = table.get_capacity() / 4;
+        for (std::uint8_t slot = 0; slot < 4; slot++) {
+            table.store(in_first_bucket(slot, bucket_count), {.move = slot, .depth = static_cast<std::uint8_t>(10 + slot)});
+        }
+        table.store(in_first_bucket(4, bucket_count), {.move = 4, .depth = 20});
+        EXPECT_FALSE(table.probe(in_first_bucket(0, bucket_count)).has_value());
+        for (std::uint8_t slot = 1; slot < 5; slot++) {
+            EXPECT_TRUE(table.probe(in_first_bucket(slot, bucket_count)).has_value());
+        }
+
+        // Two searches later the deepest old entry is worth less than a shallow new one
+        table.new_search();
+        table.new_search();
+        table.store(in_first_bucket(5, bucket_count), {.move = 5, .depth = 2});
+        table.store(in_first_bucket(6, bucket_count), {.move = 6, .depth = 1});
+        EXPECT_TRUE(table.probe(in_first_bucket(5, bucket_count)).has_value());
+        EXPECT_TRUE(table.probe(in_first_bucket(6, bucket_count)).has_value());
+        EXPECT_FALSE(table.probe(in_first_bucket(1, bucket_count)).has_value());
+        EXPECT_FALSE(table.probe(in_first_bucket(2, bucket_count)).has_value());
+    }
+
+    // Test: Threads hammering a small table never read an entry that belongs to another hash
+    TEST(TranspositionTableTest, ConcurrentAccessNeverTears) {
+        TranspositionTable table(1 << 10);
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> torn{0};
+        {
+            std::vector<std::jthread> threads;
+            for (std::uint64_t thread = 0; thread < 4; thread++) {
+                threads.emplace_back([&, thread] {
+                    std::uint64_t state = thread + 1;
+                    for (int step = 0; step < 200000; step++) {
+                        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                        // Few distinct hashes, so threads keep writing the same slots
+                        const Game::ZobristHash hash = Game::Zobrist::mix(state >> 56);
+                        if (step % 2 == 0) {
+                            table.store(hash, entry_for(hash));
+                        } else if (const auto found = table.probe(hash)) {
+                            hits.fetch_add(1, std::memory_order_relaxed);
+                            const TranspositionEntry expected = entry_for(hash);
+                            if (found->move != expected.move || found->value != expected.value ||
+                                found->depth != expected.depth) {
+                                torn.fetch_add(1, std::memory_order_relaxed);
+                            }
+                        }
+                    }
+                });
+            }
+        }
+        EXPECT_GT(hits.load(), 0);
+        EXPECT_EQ(torn.load(), 0);
+    }
+} // namespace Sim
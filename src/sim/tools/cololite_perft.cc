@@ -0,0 +1,80 @@
+// Counts the legal move sequences of the game flow to a given depth, one depth after the other, and reports the
+// leaves and the nodes per second at each: chess engines' perft. The counts check move generation against the
+// ones pinned in perft_tests; the node rate is the throughput of generate_moves, apply_move and undo together.
+// With "divide", the last depth is also split by the moves of the root, to find where two counts part.
+//
+// Usage: cololite_perft [depth] [setup|opening] [expand|sample] [seed] [radius] [players] [divide]
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+#include "perft.hh"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    auto get_kind_name(const Sim::MoveKind kind) -> const char * {
+        switch (kind) {
+            case Sim::MoveKind::SETUP_SETTLEMENT:
+                return "setup-settlement";
+            case Sim::MoveKind::SETUP_ROAD:
+                return "setup-road";
+            case Sim::MoveKind::BUILD_ROAD:
+                return "road";
+            case Sim::MoveKind::BUILD_SETTLEMENT:
+                return "settlement";
+            case Sim::MoveKind::BUILD_CITY:
+                return "city";
+            case Sim::MoveKind::BANK_TRADE:
+                return "trade";
+            case Sim::MoveKind::MOVE_ROBBER:
+                return "robber";
+            case Sim::MoveKind::END_TURN:
+                return "end-turn";
+            case Sim::MoveKind::ROLL:
+                return "roll";
+            case Sim::MoveKind::STEAL:
+                return "steal";
+        }
+        return "?";
+    }
+} // namespace
+
+auto main(const int argc, char **argv) -> int {
+    const auto depth = static_cast<std::uint32_t>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4);
+    const bool opening = argc > 2 && std::string_view(argv[2]) == "opening";
+    const bool sample = argc > 3 && std::string_view(argv[3]) == "sample";
+    const std::uint64_t seed = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1;
+    const size_t radius = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 2;
+    const size_t players = argc > 6 ? std::strtoul(argv[6], nullptr, 10) : 4;
+    const bool divide = argc > 7 && std::string_view(argv[7]) == "divide";
+
+    Game::GameState state = opening ? Sim::make_opening_position(radius, seed, players)
+                                    : Sim::make_setup_position(radius, seed, players);
+    const Sim::PerftConfig config{.dice = sample ? Sim::DiceMode::SAMPLE : Sim::DiceMode::EXPAND, .seed = seed};
+
+    std::printf("radius %zu, seed %llu, %zu players, %s position, dice %s\n", radius,
+                static_cast<unsigned long long>(seed), players, opening ? "opening" : "setup",
+                sample ? "sampled" : "expanded");
+    std::printf("%-6s %16s %16s %10s %14s\n", "depth", "leaves", "nodes", "seconds", "nodes/s");
+    for (std::uint32_t current = 1; current <= depth; current++) {
+        const auto start = Clock::now();
+        const Sim::PerftResult result = Sim::perft(state, current, config);
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::printf("%-6u %16llu %16llu %10.3f %14.0f\n", current, static_cast<unsigned long long>(result.leaves),
+                    static_cast<unsigned long long>(result.nodes), seconds,
+                    static_cast<double>(result.nodes) / seconds);
+    }
+
+    if (divide) {
+        std::printf("\n");
+        for (const auto &[move, result]: Sim::divide(state, depth, config)) {
+            std::printf("%-16s %8u %16llu\n", get_kind_name(move.kind), static_cast<unsigned>(move.target),
+                        static_cast<unsigned long long>(result.leaves));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "tournament.hh"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include "map.hh"
+#include "work_stealing.hh"
+
+namespace Sim {
+    void TournamentStats::add(const GameResult &result, const size_t rotation) {
+        const size_t entrant_count = entrants.size();
+        games++;
+        turns += result.turns;
+        decided += result.winner != NO_PLAYER;
+        for (size_t player = 0; player < result.points.size(); player++) {
+            EntrantStats &entrant = entrants[(player + rotation) % entrant_count];
+            entrant.points += result.points[player];
+            entrant.wins += result.winner == static_cast<PlayerId>(player);
+            entrant.longest_roads += result.longest_road == static_cast<PlayerId>(player);
+        }
+    }
+
+    void TournamentStats::merge(const TournamentStats &other) {
+        games += other.games;
+        decided += other.decided;
+        turns += other.turns;
+        entrants.resize(std::max(entrants.size(), other.entrants.size()));
+        for (size_t entrant = 0; entrant < other.entrants.size(); entrant++) {
+            entrants[entrant].wins += other.entrants[entrant].wins;
+            entrants[entrant].points += other.entrants[entrant].points;
+            entrants[entrant].longest_roads += other.entrants[entrant].longest_roads;
+        }
+    }
+
+    auto get_game_seed(const std::uint64_t tournament_seed, const std::uint32_t game) -> std::uint64_t {
+        std::uint64_t z = tournament_seed + (game + 1) * 0x9e3779b97f4a7c15ULL;
+        z = (z ^ z >> 30) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ z >> 27) * 0x94d049bb133111ebULL;
+        return z ^ z >> 31;
+    }
+
+    auto run_tournament(const TournamentConfig &config, const std::span<const PolicyFactory> entrants)
+        -> TournamentStats {
+        // Every entrant plays every game, in the seat the rotation gives it
+        const size_t entrant_count = entrants.size();
+        if (entrant_count != config.player_count) {
+            throw std::invalid_argument("A tournament needs one entrant per seat");
+        }
+        const size_t thread_count = config.thread_count != 0
+                                        ? config.thread_count
+                                        : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+        WorkStealingScheduler scheduler(config.games, thread_count);
+        std::vector<TournamentStats> worker_stats(thread_count, TournamentStats{.entrants =
+                                                                  std::vector<EntrantStats>(entrant_count)});
+        std::vector<std::exception_ptr> errors(thread_count);
+
+        auto work = [&](const size_t worker) {
+            try {
+                // Everything the worker touches per game is its own: policies, seats and counters
+                std::vector<std::unique_ptr<Policy> > policies;
+                for (const auto &make_policy: entrants) {
+                    policies.push_back(make_policy());
+                }
+                std::vector<Policy *> seats(entrant_count);
+                TournamentStats stats{.entrants = std::vector<EntrantStats>(entrant_count)};
+
+                while (const auto game = scheduler.next(worker)) {
+                    const std::uint64_t seed = get_game_seed(config.seed, *game);
+                    const size_t rotation = *game % entrant_count;
+                    for (size_t player = 0; player < entrant_count; player++) {
+                        seats[player] = policies[(player + rotation) % entrant_count].get();
+                        seats[player]->seed(seed + player);
+                    }
+                    Simulator simulator(Map::Map::build_map_of_size(config.radius, seed), seats,
+                                        static_cast<std::uint32_t>(seed), config.rules);
+                    stats.add(simulator.play(), rotation);
+                }
+                worker_stats[worker] = std::move(stats);
+            } catch (...) {
+                errors[worker] = std::current_exception();
+            }
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            for (size_t worker = 1; worker < thread_count; worker++) {
+                threads.emplace_back(work, worker);
+            }
+            work(0);
+        }
+
+        for (const auto &error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        TournamentStats total{.entrants = std::vector<EntrantStats>(entrant_count)};
+        for (const auto &stats: worker_stats) {
+            total.merge(stats);
+        }
+        return total;
+    }
+} // namespace Sim
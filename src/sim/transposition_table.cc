@@ -0,0 +1,84 @@
+#include "transposition_table.hh"
+#include <algorithm>
+#include <bit>
+
+namespace Sim {
+    TranspositionTable::TranspositionTable(const size_t size_in_bytes) {
+        const size_t bucket_count = std::bit_floor(std::max<size_t>(size_in_bytes / sizeof(Bucket), 1));
+        m_buckets = std::make_unique<Bucket[]>(bucket_count);
+        m_bucket_mask = bucket_count - 1;
+    }
+
+    auto TranspositionTable::get_age(const std::uint64_t data) const -> int {
+        // Generations run through [1, GENERATIONS) and wrap around, skipping 0
+        const int current = m_generation.load(std::memory_order_relaxed);
+        const int written = get_generation(data);
+        return (current - written + GENERATIONS - 1) % (GENERATIONS - 1);
+    }
+
+    auto TranspositionTable::probe(const Game::ZobristHash hash) const -> std::optional<TranspositionEntry> {
+        for (const Slot &slot: get_bucket(hash).slots) {
+            const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+            const std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+            if (data != 0 && (check ^ data) == hash) {
+                return unpack(data);
+            }
+        }
+        return std::nullopt;
+    }
+
+    void TranspositionTable::store(const Game::ZobristHash hash, const TranspositionEntry &entry) {
+        const std::uint8_t generation = m_generation.load(std::memory_order_relaxed);
+        Bucket &bucket = get_bucket(hash);
+        Slot *victim = nullptr;
+        int victim_worth = 0;
+        for (Slot &slot: bucket.slots) {
+            const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+            const std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+            if (data == 0 || (check ^ data) == hash) {
+                // An exact result or a search almost as deep is worth more than what this search already had
+                const TranspositionEntry stored = unpack(data);
+                if (data != 0 && get_age(data) == 0 && entry.bound != Bound::EXACT && entry.depth + 2 < stored.depth) {
+                    return;
+                }
+                victim = &slot;
+                break;
+            }
+            const int worth = unpack(data).depth - AGE_PENALTY * get_age(data);
+            if (victim == nullptr || worth < victim_worth) {
+                victim = &slot;
+                victim_worth = worth;
+            }
+        }
+        const std::uint64_t data = pack(entry, generation);
+        victim->check.store(hash ^ data, std::memory_order_relaxed);
+        victim->data.store(data, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::new_search() {
+        const std::uint8_t generation = m_generation.load(std::memory_order_relaxed);
+        m_generation.store(generation + 1 == GENERATIONS ? 1 : generation + 1, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::clear() {
+        for (size_t bucket = 0; bucket <= m_bucket_mask; bucket++) {
+            for (Slot &slot: m_buckets[bucket].slots) {
+                slot.check.store(0, std::memory_order_relaxed);
+                slot.data.store(0, std::memory_order_relaxed);
+            }
+        }
+        m_generation.store(1, std::memory_order_relaxed);
+    }
+
+    auto TranspositionTable::get_usage() const -> size_t {
+        const size_t sampled = std::min<size_t>(1000, m_bucket_mask + 1);
+        size_t used = 0;
+        for (size_t bucket = 0; bucket < sampled; bucket++) {
+            for (const Slot &slot: m_buckets[bucket].slots) {
+                const std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+                used += data != 0 && get_age(data) == 0;
+            }
+        }
+        return used * 1000 / (sampled * SLOTS);
+    }
+} // namespace Sim
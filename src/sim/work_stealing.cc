@@ -0,0 +1,58 @@
+#include "work_stealing.hh"
+
+namespace Sim {
+    WorkStealingScheduler::WorkStealingScheduler(const std::uint32_t task_count, const size_t worker_count)
+        : m_shares(worker_count) {
+        for (size_t worker = 0; worker < worker_count; worker++) {
+            const auto begin = static_cast<std::uint32_t>(task_count * worker / worker_count);
+            const auto end = static_cast<std::uint32_t>(task_count * (worker + 1) / worker_count);
+            m_shares[worker].range.store(pack(begin, end), std::memory_order_relaxed);
+        }
+    }
+
+    auto WorkStealingScheduler::next(const size_t worker) -> std::optional<std::uint32_t> {
+        auto &range = m_shares[worker].range;
+        std::uint64_t current = range.load(std::memory_order_acquire);
+        while (get_begin(current) < get_end(current)) {
+            if (range.compare_exchange_weak(current, pack(get_begin(current) + 1, get_end(current)),
+                                            std::memory_order_acq_rel)) {
+                return get_begin(current);
+            }
+        }
+        return steal(worker);
+    }
+
+    auto WorkStealingScheduler::steal(const size_t worker) -> std::optional<std::uint32_t> {
+        while (true) {
+            // The largest share is the one least likely to run dry before the steal lands
+            size_t victim = worker;
+            std::uint32_t most_left = 0;
+            for (size_t other = 0; other < m_shares.size(); other++) {
+                const std::uint64_t range = m_shares[other].range.load(std::memory_order_relaxed);
+                if (other != worker && get_end(range) - get_begin(range) > most_left) {
+                    most_left = get_end(range) - get_begin(range);
+                    victim = other;
+                }
+            }
+            if (victim == worker) {
+                return std::nullopt;
+            }
+
+            auto &range = m_shares[victim].range;
+            std::uint64_t current = range.load(std::memory_order_acquire);
+            const std::uint32_t begin = get_begin(current);
+            const std::uint32_t end = get_end(current);
+            if (begin >= end) {
+                continue;
+            }
+            // Leave the front half to the victim, it keeps working on it without noticing the steal
+            const std::uint32_t middle = begin + (end - begin) / 2;
+            if (!range.compare_exchange_strong(current, pack(begin, middle), std::memory_order_acq_rel)) {
+                continue;
+            }
+            // Only the owner takes from its own share and it is empty, so a plain store publishes the loot
+            m_shares[worker].range.store(pack(middle + 1, end), std::memory_order_release);
+            return middle;
+        }
+    }
+} // namespace Sim